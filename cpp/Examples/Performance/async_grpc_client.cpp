@@ -0,0 +1,779 @@
+// ASYNC GRPC CLIENT: CHANNEL POOL, PIPELINING, COALESCING, PAGE PREFETCH
+//
+// SimpleGrpcClient (Examples/protobuf.cpp) blocks on one unary RPC at a time,
+// so N lookups cost N round trips. AsyncGrpcClient:
+//   - keeps a pool of channels (separate connections) and spreads calls over
+//     them round-robin
+//   - runs every RPC on one CompletionQueue polled by a dedicated thread;
+//     callers get std::futures and can have up to max_in_flight RPCs
+//     outstanding (pipelining); beyond that, starting a call waits
+//   - coalesces GetUser: ids requested within batch_window (or until
+//     max_batch ids) go out as one BatchGetUsers RPC, and concurrent
+//     requests for the same id share one slot in it
+//   - ListAllUsers fetches page 1, then keeps prefetch_pages page requests
+//     in flight and assembles the result in page order, moving users out of
+//     the responses instead of copying them
+//
+// The benchmark runs against StandInServer: a real gRPC server reached over
+// in-process channels (no sockets) that implements UserService and
+// TodoService with an injectable per-call latency and per-item cost.
+//
+// No grpc_cpp_plugin is needed: the client uses grpc::GenericStub and the
+// server grpc::CallbackGenericService, with the protobuf messages from
+// user.proto / todo.proto serialized explicitly.
+//
+// Build (from Examples/Performance):
+//   protoc -I.. --cpp_out=. ../user.proto ../todo.proto
+//   g++ -std=c++17 -O2 -pthread -I. async_grpc_client.cpp user.pb.cc todo.pb.cc
+//       $(pkg-config --cflags --libs grpc++ protobuf)
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <grpcpp/generic/async_generic_service.h>
+#include <grpcpp/generic/generic_stub.h>
+#include <grpcpp/grpcpp.h>
+#include <grpcpp/impl/codegen/proto_utils.h>
+
+#include "../small_function.hpp"
+#include "todo.pb.h"
+#include "user.pb.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace method {
+const std::string kGetUser = "/simple.UserService/GetUser";
+const std::string kBatchGetUsers = "/simple.UserService/BatchGetUsers";
+const std::string kListUsers = "/simple.UserService/ListUsers";
+const std::string kCreateUser = "/simple.UserService/CreateUser";
+const std::string kAddTodo = "/simple.TodoService/AddTodo";
+} // namespace method
+
+template<typename Message>
+grpc::ByteBuffer serialize(const Message& msg) {
+    grpc::ByteBuffer buffer;
+    bool own = false;
+    grpc::SerializationTraits<Message>::Serialize(msg, &buffer, &own);
+    return buffer;
+}
+
+template<typename Message>
+bool deserialize(grpc::ByteBuffer* buffer, Message* msg) {
+    return grpc::SerializationTraits<Message>::Deserialize(buffer, msg).ok();
+}
+
+// ============================================================================
+// STAND-IN SERVER
+// ============================================================================
+
+// Runs callbacks after a delay on one timer thread, so injected latency
+// does not hold a gRPC thread
+class DelayQueue {
+public:
+    DelayQueue() : thread_([this] { run(); }) {}
+
+    ~DelayQueue() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_one();
+        thread_.join();
+    }
+
+    void schedule(std::chrono::microseconds delay, small_function<void()> fn) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push({Clock::now() + delay, seq_++, std::make_shared<small_function<void()>>(std::move(fn))});
+        }
+        cv_.notify_one();
+    }
+
+private:
+    struct Item {
+        Clock::time_point due;
+        uint64_t seq;
+        std::shared_ptr<small_function<void()>> fn;   // priority_queue::top() is const
+        bool operator>(const Item& other) const { return due != other.due ? due > other.due : seq > other.seq; }
+    };
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            if (queue_.empty()) {
+                if (stop_) return;
+                cv_.wait(lock);
+                continue;
+            }
+            auto due = queue_.top().due;
+            if (Clock::now() < due) {
+                cv_.wait_until(lock, due);
+                continue;
+            }
+            auto fn = queue_.top().fn;
+            queue_.pop();
+            lock.unlock();
+            (*fn)();
+            lock.lock();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue_;
+    uint64_t seq_ = 0;
+    bool stop_ = false;
+    std::thread thread_;
+};
+
+class StandInServer {
+public:
+    struct Stats {
+        std::atomic<uint64_t> get_user{0};
+        std::atomic<uint64_t> batch_get_users{0};
+        std::atomic<uint64_t> batched_ids{0};
+        std::atomic<uint64_t> list_users{0};
+        std::atomic<uint64_t> create_user{0};
+        std::atomic<uint64_t> add_todo{0};
+
+        uint64_t total() const {
+            return get_user + batch_get_users + list_users + create_user + add_todo;
+        }
+    };
+
+    // latency: added to every call; per_item: added per id in a batch
+    explicit StandInServer(std::chrono::microseconds latency, std::chrono::microseconds per_item = {})
+        : latency_(latency), per_item_(per_item) {
+        grpc::ServerBuilder builder;
+        builder.RegisterCallbackGenericService(&service_);
+        server_ = builder.BuildAndStart();
+    }
+
+    ~StandInServer() {
+        server_->Shutdown(std::chrono::system_clock::now() + std::chrono::seconds(5));
+    }
+
+    // Each channel is its own in-process transport
+    std::shared_ptr<grpc::Channel> channel() {
+        grpc::ChannelArguments args;
+        return server_->InProcessChannel(args);
+    }
+
+    void seed_users(std::size_t n) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (std::size_t i = 0; i < n; ++i) add_user_locked("User " + std::to_string(i), "user" + std::to_string(i) + "@example.com",
+                                                            static_cast<int32_t>(20 + i % 50));
+    }
+
+    Stats& stats() { return stats_; }
+
+    void reset_stats() {
+        for (auto* counter : {&stats_.get_user, &stats_.batch_get_users, &stats_.batched_ids, &stats_.list_users,
+                              &stats_.create_user, &stats_.add_todo}) {
+            counter->store(0);
+        }
+    }
+
+private:
+    // Unary call over the generic bidi reactor: read one request, reply
+    // once the injected latency has passed
+    class UnaryReactor : public grpc::ServerGenericBidiReactor {
+    public:
+        UnaryReactor(StandInServer* server, grpc::GenericCallbackServerContext* ctx) : server_(server), ctx_(ctx) {
+            StartRead(&request_);
+        }
+
+        void OnReadDone(bool ok) override {
+            if (!ok) {
+                Finish(grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "missing request"));
+                return;
+            }
+            std::chrono::microseconds delay{};
+            grpc::Status status = server_->handle(ctx_->method(), &request_, &response_, &delay);
+            server_->delay_.schedule(delay, [this, status] {
+                if (status.ok()) {
+                    StartWriteAndFinish(&response_, grpc::WriteOptions(), status);
+                } else {
+                    Finish(status);
+                }
+            });
+        }
+
+        void OnDone() override { delete this; }
+
+    private:
+        StandInServer* server_;
+        grpc::GenericCallbackServerContext* ctx_;
+        grpc::ByteBuffer request_;
+        grpc::ByteBuffer response_;
+    };
+
+    class Service : public grpc::CallbackGenericService {
+    public:
+        explicit Service(StandInServer* server) : server_(server) {}
+        grpc::ServerGenericBidiReactor* CreateReactor(grpc::GenericCallbackServerContext* ctx) override {
+            return new UnaryReactor(server_, ctx);
+        }
+
+    private:
+        StandInServer* server_;
+    };
+
+    simple::User& add_user_locked(const std::string& name, const std::string& email, int32_t age) {
+        simple::User user;
+        user.set_id("u" + std::to_string(order_.size() + 1));
+        user.set_name(name);
+        user.set_email(email);
+        user.set_age(age);
+        order_.push_back(user.id());
+        return users_[user.id()] = std::move(user);
+    }
+
+    grpc::Status handle(const std::string& m, grpc::ByteBuffer* in, grpc::ByteBuffer* out,
+                        std::chrono::microseconds* delay) {
+        *delay = latency_;
+        const grpc::Status bad_request(grpc::StatusCode::INVALID_ARGUMENT, "cannot parse request");
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (m == method::kGetUser) {
+            ++stats_.get_user;
+            simple::GetUserRequest req;
+            if (!deserialize(in, &req)) return bad_request;
+            auto it = users_.find(req.user_id());
+            if (it == users_.end()) return {grpc::StatusCode::NOT_FOUND, "no user " + req.user_id()};
+            *out = serialize(it->second);
+        } else if (m == method::kBatchGetUsers) {
+            ++stats_.batch_get_users;
+            simple::BatchGetUsersRequest req;
+            if (!deserialize(in, &req)) return bad_request;
+            stats_.batched_ids += req.user_ids_size();
+            *delay += per_item_ * req.user_ids_size();
+            simple::ListUsersResponse resp;   // missing ids are left out
+            for (const auto& id : req.user_ids()) {
+                auto it = users_.find(id);
+                if (it != users_.end()) *resp.add_users() = it->second;
+            }
+            *out = serialize(resp);
+        } else if (m == method::kListUsers) {
+            ++stats_.list_users;
+            simple::ListUsersRequest req;
+            if (!deserialize(in, &req) || req.page() < 1 || req.page_size() < 1) return bad_request;
+            *delay += per_item_ * req.page_size();
+            std::size_t size = static_cast<std::size_t>(req.page_size());
+            std::size_t begin = (static_cast<std::size_t>(req.page()) - 1) * size;
+            simple::ListUsersResponse resp;
+            for (std::size_t i = begin; i < std::min(order_.size(), begin + size); ++i) {
+                *resp.add_users() = users_[order_[i]];
+            }
+            resp.set_total_pages(static_cast<int32_t>((order_.size() + size - 1) / size));
+            *out = serialize(resp);
+        } else if (m == method::kCreateUser) {
+            ++stats_.create_user;
+            simple::CreateUserRequest req;
+            if (!deserialize(in, &req)) return bad_request;
+            *out = serialize(add_user_locked(req.name(), req.email(), req.age()));
+        } else if (m == method::kAddTodo) {
+            ++stats_.add_todo;
+            simple::AddTodoRequest req;
+            if (!deserialize(in, &req)) return bad_request;
+            simple::Todo todo;
+            todo.set_id("t" + std::to_string(++todo_count_));
+            todo.set_title(req.title());
+            todo.set_description(req.description());
+            *out = serialize(todo);
+        } else {
+            return {grpc::StatusCode::UNIMPLEMENTED, m};
+        }
+        return grpc::Status::OK;
+    }
+
+    std::chrono::microseconds latency_;
+    std::chrono::microseconds per_item_;
+    std::mutex mutex_;
+    std::unordered_map<std::string, simple::User> users_;
+    std::vector<std::string> order_;
+    uint64_t todo_count_ = 0;
+    Stats stats_;
+    DelayQueue delay_;   // destroyed after server_ has shut down
+    Service service_{this};
+    std::unique_ptr<grpc::Server> server_;
+};
+
+// ============================================================================
+// ASYNC CLIENT
+// ============================================================================
+
+class RpcError : public std::runtime_error {
+public:
+    RpcError(const std::string& method, const grpc::Status& status)
+        : std::runtime_error(method + " failed: " + std::to_string(status.error_code()) + ": " +
+                             status.error_message()),
+          code(status.error_code()) {}
+    grpc::StatusCode code;
+};
+
+class AsyncGrpcClient {
+public:
+    struct Options {
+        std::size_t channels = 4;
+        std::size_t max_in_flight = 512;
+        std::size_t max_batch = 64;
+        std::chrono::microseconds batch_window{200};
+        std::size_t prefetch_pages = 8;
+        std::chrono::seconds timeout{10};
+    };
+
+    struct Stats {
+        std::atomic<uint64_t> rpcs{0};
+        std::atomic<uint64_t> batches{0};
+        std::atomic<uint64_t> merged_lookups{0};   // GetUser calls that shared an id slot
+    };
+
+    using ChannelFactory = std::function<std::shared_ptr<grpc::Channel>(std::size_t index)>;
+
+    AsyncGrpcClient(const ChannelFactory& make_channel, Options options) : options_(options) {
+        for (std::size_t i = 0; i < std::max<std::size_t>(1, options_.channels); ++i) {
+            stubs_.push_back(std::make_unique<grpc::GenericStub>(make_channel(i)));
+        }
+        poller_ = std::thread([this] { poll(); });
+        batcher_ = std::thread([this] { batch_loop(); });
+    }
+
+    ~AsyncGrpcClient() {
+        {
+            std::lock_guard<std::mutex> lock(batch_mutex_);
+            stopping_ = true;
+        }
+        batch_cv_.notify_one();
+        batcher_.join();   // flushes what is pending
+        {
+            std::unique_lock<std::mutex> lock(flight_mutex_);
+            flight_cv_.wait(lock, [this] { return in_flight_ == 0; });
+        }
+        cq_.Shutdown();
+        poller_.join();
+    }
+
+    // Coalesced with other GetUser calls made within the batch window
+    std::future<simple::User> GetUser(const std::string& id) {
+        std::promise<simple::User> promise;
+        auto future = promise.get_future();
+        bool notify = false;
+        {
+            std::lock_guard<std::mutex> lock(batch_mutex_);
+            auto& waiters = pending_[id];
+            if (waiters.empty()) {
+                pending_order_.push_back(id);
+            } else {
+                ++stats_.merged_lookups;
+            }
+            waiters.push_back(std::move(promise));
+            if (pending_order_.size() == 1) batch_started_ = Clock::now();
+            notify = pending_order_.size() == 1 || pending_order_.size() >= options_.max_batch;
+        }
+        if (notify) batch_cv_.notify_one();
+        return future;
+    }
+
+    // One GetUser RPC per call, still pipelined
+    std::future<simple::User> GetUserUnbatched(const std::string& id) {
+        simple::GetUserRequest req;
+        req.set_user_id(id);
+        return unary<simple::User>(method::kGetUser, req);
+    }
+
+    std::future<simple::User> CreateUser(const std::string& name, const std::string& email, int32_t age) {
+        simple::CreateUserRequest req;
+        req.set_name(name);
+        req.set_email(email);
+        req.set_age(age);
+        return unary<simple::User>(method::kCreateUser, req);
+    }
+
+    std::future<simple::Todo> AddTodo(const std::string& title, const std::string& description) {
+        simple::AddTodoRequest req;
+        req.set_title(title);
+        req.set_description(description);
+        return unary<simple::Todo>(method::kAddTodo, req);
+    }
+
+    std::future<simple::ListUsersResponse> ListUsers(int page, int page_size) {
+        simple::ListUsersRequest req;
+        req.set_page(page);
+        req.set_page_size(page_size);
+        return unary<simple::ListUsersResponse>(method::kListUsers, req);
+    }
+
+    // Every user, pages fetched prefetch_pages at a time
+    std::vector<simple::User> ListAllUsers(int page_size) {
+        simple::ListUsersResponse first = ListUsers(1, page_size).get();
+        int total_pages = first.total_pages();
+        std::vector<simple::User> users;
+        users.reserve(static_cast<std::size_t>(std::max(total_pages, 1)) * static_cast<std::size_t>(page_size));
+        auto take = [&](simple::ListUsersResponse& page) {
+            for (auto& u : *page.mutable_users()) users.push_back(std::move(u));
+        };
+        take(first);
+
+        std::deque<std::future<simple::ListUsersResponse>> window;
+        int next = 2;
+        while (next <= total_pages || !window.empty()) {
+            while (next <= total_pages && window.size() < options_.prefetch_pages) {
+                window.push_back(ListUsers(next++, page_size));
+            }
+            simple::ListUsersResponse page = window.front().get();
+            window.pop_front();
+            take(page);
+        }
+        return users;
+    }
+
+    const Stats& stats() const { return stats_; }
+
+private:
+    struct Call {
+        grpc::ClientContext context;
+        grpc::ByteBuffer response;
+        grpc::Status status;
+        std::unique_ptr<grpc::GenericClientAsyncResponseReader> reader;
+        small_function<void(Call&)> on_done;
+    };
+
+    // m must outlive the call (the method:: names do)
+    template<typename Response, typename Request>
+    std::future<Response> unary(const std::string& m, const Request& req) {
+        auto promise = std::make_shared<std::promise<Response>>();
+        auto future = promise->get_future();
+        start(m, serialize(req), [promise, name = &m](Call& call) {
+            Response resp;
+            if (!call.status.ok()) {
+                promise->set_exception(std::make_exception_ptr(RpcError(*name, call.status)));
+            } else if (!deserialize(&call.response, &resp)) {
+                promise->set_exception(std::make_exception_ptr(std::runtime_error(*name + ": bad response")));
+            } else {
+                promise->set_value(std::move(resp));
+            }
+        });
+        return future;
+    }
+
+    void start(const std::string& m, const grpc::ByteBuffer& request, small_function<void(Call&)> on_done) {
+        {
+            std::unique_lock<std::mutex> lock(flight_mutex_);
+            flight_cv_.wait(lock, [this] { return in_flight_ < options_.max_in_flight; });
+            ++in_flight_;
+        }
+        ++stats_.rpcs;
+        auto* call = new Call;
+        call->on_done = std::move(on_done);
+        call->context.set_deadline(std::chrono::system_clock::now() + options_.timeout);
+        grpc::GenericStub& stub = *stubs_[next_channel_.fetch_add(1, std::memory_order_relaxed) % stubs_.size()];
+        call->reader = stub.PrepareUnaryCall(&call->context, m, request, &cq_);
+        call->reader->StartCall();
+        call->reader->Finish(&call->response, &call->status, call);
+    }
+
+    void poll() {
+        void* tag = nullptr;
+        bool ok = false;
+        while (cq_.Next(&tag, &ok)) {
+            std::unique_ptr<Call> call(static_cast<Call*>(tag));
+            call->on_done(*call);
+            {
+                std::lock_guard<std::mutex> lock(flight_mutex_);
+                --in_flight_;
+            }
+            flight_cv_.notify_all();
+        }
+    }
+
+    void batch_loop() {
+        std::unique_lock<std::mutex> lock(batch_mutex_);
+        for (;;) {
+            if (pending_order_.empty()) {
+                if (stopping_) return;
+                batch_cv_.wait(lock);
+                continue;
+            }
+            auto deadline = batch_started_ + options_.batch_window;
+            if (!stopping_ && pending_order_.size() < options_.max_batch && Clock::now() < deadline) {
+                batch_cv_.wait_until(lock, deadline);
+                continue;
+            }
+            flush_locked(lock);
+        }
+    }
+
+    // Sends up to max_batch pending ids as one BatchGetUsers
+    void flush_locked(std::unique_lock<std::mutex>& lock) {
+        std::size_t n = std::min(options_.max_batch, pending_order_.size());
+        simple::BatchGetUsersRequest req;
+        auto waiters = std::make_shared<std::unordered_map<std::string, std::vector<std::promise<simple::User>>>>();
+        for (std::size_t i = 0; i < n; ++i) {
+            const std::string& id = pending_order_[i];
+            req.add_user_ids(id);
+            auto node = pending_.extract(id);
+            waiters->emplace(std::move(node.key()), std::move(node.mapped()));
+        }
+        pending_order_.erase(pending_order_.begin(), pending_order_.begin() + static_cast<std::ptrdiff_t>(n));
+        if (!pending_order_.empty()) batch_started_ = Clock::now();
+        ++stats_.batches;
+        lock.unlock();
+
+        start(method::kBatchGetUsers, serialize(req), [waiters](Call& call) {
+            simple::ListUsersResponse resp;
+            if (!call.status.ok() || !deserialize(&call.response, &resp)) {
+                grpc::Status status = call.status;
+                if (status.ok()) status = grpc::Status(grpc::StatusCode::INTERNAL, "malformed BatchGetUsers response");
+                auto error = std::make_exception_ptr(RpcError(method::kBatchGetUsers, status));
+                for (auto& [id, promises] : *waiters) {
+                    for (auto& p : promises) p.set_exception(error);
+                }
+                return;
+            }
+            for (auto& user : *resp.mutable_users()) {
+                auto it = waiters->find(user.id());
+                if (it == waiters->end()) continue;
+                // Every waiter but the last gets a copy
+                for (std::size_t i = 0; i + 1 < it->second.size(); ++i) it->second[i].set_value(user);
+                it->second.back().set_value(std::move(user));
+                waiters->erase(it);
+            }
+            for (auto& [id, promises] : *waiters) {
+                auto error = std::make_exception_ptr(
+                    RpcError(method::kGetUser, grpc::Status(grpc::StatusCode::NOT_FOUND, "no user " + id)));
+                for (auto& p : promises) p.set_exception(error);
+            }
+        });
+        lock.lock();
+    }
+
+    Options options_;
+    std::vector<std::unique_ptr<grpc::GenericStub>> stubs_;
+    std::atomic<std::size_t> next_channel_{0};
+    grpc::CompletionQueue cq_;
+    Stats stats_;
+
+    std::mutex flight_mutex_;
+    std::condition_variable flight_cv_;
+    std::size_t in_flight_ = 0;
+
+    std::mutex batch_mutex_;
+    std::condition_variable batch_cv_;
+    std::unordered_map<std::string, std::vector<std::promise<simple::User>>> pending_;
+    std::vector<std::string> pending_order_;
+    Clock::time_point batch_started_;
+    bool stopping_ = false;
+
+    std::thread poller_;
+    std::thread batcher_;
+};
+
+// ============================================================================
+// BLOCKING BASELINE
+// ============================================================================
+
+// What SimpleGrpcClient does: one channel, a fresh ClientContext per call,
+// and the caller waits for each response before sending the next request
+class BlockingClient {
+public:
+    explicit BlockingClient(std::shared_ptr<grpc::Channel> channel) : stub_(std::move(channel)) {}
+
+    simple::User GetUser(const std::string& id) {
+        simple::GetUserRequest req;
+        req.set_user_id(id);
+        return call<simple::User>(method::kGetUser, req);
+    }
+
+    simple::User CreateUser(const std::string& name, const std::string& email, int32_t age) {
+        simple::CreateUserRequest req;
+        req.set_name(name);
+        req.set_email(email);
+        req.set_age(age);
+        return call<simple::User>(method::kCreateUser, req);
+    }
+
+    std::vector<simple::User> ListAllUsers(int page_size) {
+        std::vector<simple::User> users;
+        for (int page = 1, total = 1; page <= total; ++page) {
+            simple::ListUsersRequest req;
+            req.set_page(page);
+            req.set_page_size(page_size);
+            auto resp = call<simple::ListUsersResponse>(method::kListUsers, req);
+            total = resp.total_pages();
+            for (const auto& u : resp.users()) users.push_back(u);
+        }
+        return users;
+    }
+
+private:
+    template<typename Response, typename Request>
+    Response call(const std::string& m, const Request& req) {
+        grpc::ClientContext context;
+        context.set_deadline(std::chrono::system_clock::now() + std::chrono::seconds(10));
+        grpc::CompletionQueue cq;
+        grpc::ByteBuffer response;
+        grpc::Status status;
+        auto reader = stub_.PrepareUnaryCall(&context, m, serialize(req), &cq);
+        reader->StartCall();
+        reader->Finish(&response, &status, nullptr);
+        void* tag = nullptr;
+        bool ok = false;
+        cq.Next(&tag, &ok);
+        cq.Shutdown();
+        while (cq.Next(&tag, &ok)) {}
+        Response resp;
+        if (!status.ok()) throw RpcError(m, status);
+        if (!deserialize(&response, &resp)) throw std::runtime_error(m + ": bad response");
+        return resp;
+    }
+
+    grpc::GenericStub stub_;
+};
+
+// ============================================================================
+// BENCHMARK
+// ============================================================================
+
+double ms_since(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void row(const char* what, double ms, uint64_t server_rpcs) {
+    std::cout << "  " << std::left << std::setw(44) << what << std::right << std::fixed << std::setprecision(1)
+              << std::setw(9) << ms << " ms " << std::setw(8) << server_rpcs << " server RPCs\n";
+}
+
+void check(bool ok, const char* what) {
+    if (!ok) {
+        std::cerr << "CHECK FAILED: " << what << "\n";
+        std::exit(1);
+    }
+}
+
+int main() {
+    const auto latency = std::chrono::microseconds(1000);
+    const auto per_item = std::chrono::microseconds(5);
+    StandInServer server(latency, per_item);
+    server.seed_users(5000);
+    std::cout << "stand-in server: " << latency.count() << " us per call + " << per_item.count()
+              << " us per batched/listed item, 5000 users\n";
+
+    BlockingClient blocking(server.channel());
+    AsyncGrpcClient::Options options;
+    AsyncGrpcClient client([&](std::size_t) { return server.channel(); }, options);
+
+    // Lookups, one caller needing 1000 users
+    const int lookups = 1000;
+    std::cout << "\n" << lookups << " GetUser lookups from one caller\n";
+    server.reset_stats();
+    auto start = Clock::now();
+    for (int i = 0; i < lookups; ++i) check(blocking.GetUser("u" + std::to_string(i % 5000 + 1)).age() > 0, "blocking");
+    row("blocking, one at a time", ms_since(start), server.stats().total());
+
+    server.reset_stats();
+    start = Clock::now();
+    {
+        std::vector<std::future<simple::User>> futures;
+        for (int i = 0; i < lookups; ++i) futures.push_back(client.GetUserUnbatched("u" + std::to_string(i % 5000 + 1)));
+        for (int i = 0; i < lookups; ++i) check(futures[i].get().id() == "u" + std::to_string(i % 5000 + 1), "pipelined");
+    }
+    row("async, pipelined", ms_since(start), server.stats().total());
+
+    server.reset_stats();
+    start = Clock::now();
+    {
+        std::vector<std::future<simple::User>> futures;
+        for (int i = 0; i < lookups; ++i) futures.push_back(client.GetUser("u" + std::to_string(i % 500 + 1)));
+        for (int i = 0; i < lookups; ++i) check(futures[i].get().id() == "u" + std::to_string(i % 500 + 1), "coalesced");
+    }
+    row("async, coalesced (500 distinct ids)", ms_since(start), server.stats().total());
+    std::cout << "    " << server.stats().batched_ids << " ids in " << server.stats().batch_get_users
+              << " batches; " << client.stats().merged_lookups << " lookups shared an id\n";
+
+    // Many concurrent callers, each doing sequential lookups
+    const int callers = 32, per_caller = 20;
+    std::cout << "\n" << callers << " threads x " << per_caller << " sequential GetUser\n";
+    auto concurrent = [&](auto&& lookup) {
+        std::vector<std::thread> threads;
+        auto t0 = Clock::now();
+        for (int t = 0; t < callers; ++t) {
+            threads.emplace_back([&, t] {
+                for (int i = 0; i < per_caller; ++i) {
+                    std::string id = "u" + std::to_string((t * per_caller + i) % 5000 + 1);
+                    check(lookup(id).id() == id, "concurrent lookup");
+                }
+            });
+        }
+        for (auto& th : threads) th.join();
+        return ms_since(t0);
+    };
+    server.reset_stats();
+    double ms = concurrent([&](const std::string& id) { return blocking.GetUser(id); });
+    row("blocking client", ms, server.stats().total());
+    server.reset_stats();
+    ms = concurrent([&](const std::string& id) { return client.GetUser(id).get(); });
+    row("async client, coalesced", ms, server.stats().total());
+
+    // Missing ids fail individually
+    bool not_found = false;
+    try {
+        client.GetUser("nobody").get();
+    } catch (const RpcError& e) {
+        not_found = e.code == grpc::StatusCode::NOT_FOUND;
+    }
+    check(not_found, "missing id reports NOT_FOUND");
+
+    // Paging
+    std::cout << "\nListAllUsers, 5000 users, 100 per page\n";
+    server.reset_stats();
+    start = Clock::now();
+    auto all_blocking = blocking.ListAllUsers(100);
+    row("blocking, page after page", ms_since(start), server.stats().total());
+    server.reset_stats();
+    start = Clock::now();
+    auto all_async = client.ListAllUsers(100);
+    row("async, 8 pages prefetched", ms_since(start), server.stats().total());
+    check(all_blocking.size() == 5000 && all_async.size() == 5000, "page count");
+    for (std::size_t i = 0; i < all_async.size(); ++i) check(all_async[i].id() == all_blocking[i].id(), "page order");
+
+    // Writes
+    const int writes = 500;
+    std::cout << "\n" << writes << " CreateUser + " << writes << " AddTodo\n";
+    server.reset_stats();
+    start = Clock::now();
+    for (int i = 0; i < writes; ++i) blocking.CreateUser("new", "new@example.com", 30);
+    row("blocking CreateUser", ms_since(start), server.stats().total());
+    server.reset_stats();
+    start = Clock::now();
+    {
+        std::vector<std::future<simple::User>> users;
+        std::vector<std::future<simple::Todo>> todos;
+        for (int i = 0; i < writes; ++i) {
+            users.push_back(client.CreateUser("new", "new@example.com", 30));
+            todos.push_back(client.AddTodo("todo " + std::to_string(i), "pipelined"));
+        }
+        for (auto& f : users) check(!f.get().id().empty(), "create");
+        for (int i = 0; i < writes; ++i) check(todos[i].get().title() == "todo " + std::to_string(i), "add todo");
+    }
+    row("async CreateUser + AddTodo, pipelined", ms_since(start), server.stats().total());
+    return 0;
+}
@@ -0,0 +1,908 @@
+// ASYNC HTTP CLIENT: KEEP-ALIVE POOL, MULTIPLEXING, CONCURRENCY LIMIT, TOKEN CACHE
+//
+// SecureHttpClient (Examples/auth_client.cpp) runs one HttpRequest per call and
+// checks the server certificate itself after every request. AsyncHttpClient:
+//   - drives every transfer from one curl multi handle on an event-loop
+//     thread; the multi handle keeps finished connections open and hands them
+//     to the next request for the same host (keep-alive)
+//   - shares TLS sessions and DNS results between its easy handles through a
+//     curl share handle, so a new connection resumes a session instead of
+//     doing a full handshake
+//   - asks for HTTP/2 on https origins and lets curl multiplex requests over
+//     one connection (CURLPIPE_MULTIPLEX); plain http stays on HTTP/1.1
+//   - pins the server key with CURLOPT_PINNEDPUBLICKEY, which curl checks
+//     during the handshake, i.e. once per connection instead of per request
+//   - limits concurrency: at most max_concurrency transfers are active, up to
+//     max_pending more wait in a queue, and submit() blocks beyond that
+//   - completes a request through a callback on the loop thread or a future
+//
+// TokenCache sits in front of the token endpoint. get() returns the cached
+// access token without I/O; once the token is within refresh_ahead of expiry
+// one background refresh starts and callers keep using the old token until
+// it lands. Only a caller that finds no valid token waits.
+//
+// The benchmark runs against LoopbackServer, a small HTTP/1.1 keep-alive
+// server on 127.0.0.1 with an injectable per-request latency, and compares
+// requests/sec with the one-request-per-call pattern of SecureHttpClient.
+//
+// Build: g++ -std=c++17 -O2 -pthread async_http_client.cpp -lcurl
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <curl/curl.h>
+
+using Clock = std::chrono::steady_clock;
+
+// Same shape as in auth_client.cpp
+struct HttpRequest {
+    std::string url;
+    std::string method = "GET";
+    std::map<std::string, std::string> headers;
+    std::string body;
+    int timeout = 30;
+    bool verifySSL = true;
+    std::string clientCertPath;
+    std::string clientKeyPath;
+    std::string caBundlePath;
+};
+
+struct HttpResponse {
+    int statusCode{0};
+    std::string body;
+    std::map<std::string, std::string> headers;  // names lower-cased
+    std::string error;
+    long responseTime{0};  // microseconds
+};
+
+// ============================================================================
+// LOOPBACK SERVER
+// ============================================================================
+
+// HTTP/1.1 with keep-alive, one thread per connection. Endpoints:
+//   POST /token          -> {"access_token":"tok-N","token_type":"Bearer","expires_in":S}
+//   GET  /resource/<id>  -> 200 with a valid, unexpired bearer token, else 401
+//   GET  /public/<id>    -> 200, no authentication
+class LoopbackServer {
+public:
+    struct Stats {
+        std::uint64_t connections = 0;
+        std::uint64_t requests = 0;
+        std::uint64_t tokens_issued = 0;
+        std::uint64_t unauthorized = 0;
+    };
+
+    explicit LoopbackServer(std::chrono::seconds token_lifetime = std::chrono::seconds(1))
+        : token_lifetime_(token_lifetime) {
+        listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (listen_fd_ < 0) throw std::system_error(errno, std::generic_category(), "socket");
+        int one = 1;
+        ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof one);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        socklen_t len = sizeof addr;
+        if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof addr) < 0 ||
+            ::listen(listen_fd_, SOMAXCONN) < 0 ||
+            ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len) < 0) {
+            int err = errno;
+            ::close(listen_fd_);
+            throw std::system_error(err, std::generic_category(), "bind/listen");
+        }
+        port_ = ntohs(addr.sin_port);
+        acceptor_ = std::thread([this] { accept_loop(); });
+    }
+
+    ~LoopbackServer() {
+        stopping_ = true;
+        ::shutdown(listen_fd_, SHUT_RDWR);
+        acceptor_.join();
+        ::close(listen_fd_);
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (int fd : open_fds_) ::shutdown(fd, SHUT_RDWR);
+        drained_.wait(lock, [this] { return open_fds_.empty(); });
+    }
+
+    LoopbackServer(const LoopbackServer&) = delete;
+    LoopbackServer& operator=(const LoopbackServer&) = delete;
+
+    std::string base_url() const { return "http://127.0.0.1:" + std::to_string(port_); }
+
+    void set_latency(std::chrono::microseconds latency) { latency_us_ = latency.count(); }
+
+    Stats stats() const {
+        Stats s;
+        s.connections = connections_.load();
+        s.requests = requests_.load();
+        s.tokens_issued = tokens_issued_.load();
+        s.unauthorized = unauthorized_.load();
+        return s;
+    }
+
+    void reset_stats() {
+        connections_ = 0;
+        requests_ = 0;
+        tokens_issued_ = 0;
+        unauthorized_ = 0;
+    }
+
+private:
+    struct Request {
+        std::string method;
+        std::string path;
+        std::string authorization;
+        std::string body;
+        bool close = false;
+    };
+
+    void accept_loop() {
+        for (;;) {
+            int fd = ::accept(listen_fd_, nullptr, nullptr);
+            if (fd < 0) {
+                if (stopping_) return;
+                if (errno == EINTR || errno == ECONNABORTED) continue;
+                return;
+            }
+            int one = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof one);
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_) {
+                ::close(fd);
+                continue;
+            }
+            open_fds_.push_back(fd);
+            ++connections_;
+            std::thread([this, fd] { serve(fd); }).detach();
+        }
+    }
+
+    static bool read_more(int fd, std::string& in) {
+        char buf[16384];
+        ssize_t n = ::recv(fd, buf, sizeof buf, 0);
+        if (n <= 0) return false;
+        in.append(buf, static_cast<std::size_t>(n));
+        return true;
+    }
+
+    static std::string lower(std::string s) {
+        for (char& c : s) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        return s;
+    }
+
+    void serve(int fd) {
+        std::string in;
+        for (;;) {
+            std::size_t header_end;
+            while ((header_end = in.find("\r\n\r\n")) == std::string::npos)
+                if (!read_more(fd, in)) goto done;
+
+            {
+                Request req;
+                std::size_t content_length = 0;
+                std::size_t line_end = in.find("\r\n");
+                std::size_t sp1 = in.find(' ');
+                std::size_t sp2 = in.find(' ', sp1 + 1);
+                if (sp1 == std::string::npos || sp2 == std::string::npos || sp2 > line_end) goto done;
+                req.method = in.substr(0, sp1);
+                req.path = in.substr(sp1 + 1, sp2 - sp1 - 1);
+                for (std::size_t pos = line_end + 2; pos < header_end;) {
+                    std::size_t eol = in.find("\r\n", pos);
+                    std::size_t colon = in.find(':', pos);
+                    if (colon != std::string::npos && colon < eol) {
+                        std::string name = lower(in.substr(pos, colon - pos));
+                        std::size_t v = in.find_first_not_of(' ', colon + 1);
+                        std::string value = in.substr(v, eol - v);
+                        if (name == "content-length") content_length = std::strtoul(value.c_str(), nullptr, 10);
+                        else if (name == "authorization") req.authorization = value;
+                        else if (name == "connection") req.close = lower(value) == "close";
+                    }
+                    pos = eol + 2;
+                }
+                std::size_t total = header_end + 4 + content_length;
+                while (in.size() < total)
+                    if (!read_more(fd, in)) goto done;
+                req.body = in.substr(header_end + 4, content_length);
+                in.erase(0, total);
+
+                ++requests_;
+                if (long us = latency_us_.load()) std::this_thread::sleep_for(std::chrono::microseconds(us));
+                std::string out = handle(req);
+                for (std::size_t sent = 0; sent < out.size();) {
+                    ssize_t n = ::send(fd, out.data() + sent, out.size() - sent, MSG_NOSIGNAL);
+                    if (n <= 0) goto done;
+                    sent += static_cast<std::size_t>(n);
+                }
+                if (req.close) goto done;
+            }
+        }
+    done:
+        std::lock_guard<std::mutex> lock(mutex_);
+        open_fds_.erase(std::find(open_fds_.begin(), open_fds_.end(), fd));
+        ::close(fd);
+        drained_.notify_all();
+    }
+
+    std::string handle(const Request& req) {
+        int status = 200;
+        std::string body;
+        if (req.method == "POST" && req.path == "/token") {
+            std::string token = "tok-" + std::to_string(++tokens_issued_);
+            {
+                std::lock_guard<std::mutex> lock(token_mutex_);
+                tokens_[token] = Clock::now() + token_lifetime_;
+            }
+            body = "{\"access_token\":\"" + token + "\",\"token_type\":\"Bearer\",\"expires_in\":" +
+                   std::to_string(token_lifetime_.count()) + "}";
+        } else if (req.method == "GET" && req.path.compare(0, 10, "/resource/") == 0) {
+            if (!authorized(req.authorization)) {
+                ++unauthorized_;
+                status = 401;
+                body = "{\"error\":\"invalid_token\"}";
+            } else {
+                body = resource_body(req.path.substr(10));
+            }
+        } else if (req.method == "GET" && req.path.compare(0, 8, "/public/") == 0) {
+            body = resource_body(req.path.substr(8));
+        } else {
+            status = 404;
+            body = "{\"error\":\"not_found\"}";
+        }
+        const char* reason = status == 200 ? "OK" : status == 401 ? "Unauthorized" : "Not Found";
+        std::string out = "HTTP/1.1 " + std::to_string(status) + " " + reason +
+                          "\r\nContent-Type: application/json\r\nContent-Length: " + std::to_string(body.size()) +
+                          (req.close ? "\r\nConnection: close" : "") + "\r\n\r\n";
+        return out + body;
+    }
+
+    bool authorized(const std::string& header) {
+        if (header.compare(0, 7, "Bearer ") != 0) return false;
+        std::lock_guard<std::mutex> lock(token_mutex_);
+        auto it = tokens_.find(header.substr(7));
+        return it != tokens_.end() && Clock::now() < it->second;
+    }
+
+    static std::string resource_body(const std::string& id) {
+        return "{\"id\":\"" + id + "\",\"payload\":\"" + std::string(200, 'x') + "\"}";
+    }
+
+    const std::chrono::seconds token_lifetime_;
+    int listen_fd_ = -1;
+    std::uint16_t port_ = 0;
+    std::thread acceptor_;
+    std::atomic<bool> stopping_{false};
+    std::atomic<long> latency_us_{0};
+
+    std::mutex mutex_;
+    std::condition_variable drained_;
+    std::vector<int> open_fds_;
+
+    std::mutex token_mutex_;
+    std::unordered_map<std::string, Clock::time_point> tokens_;
+
+    std::atomic<std::uint64_t> connections_{0}, requests_{0}, tokens_issued_{0}, unauthorized_{0};
+};
+
+// ============================================================================
+// ASYNC CLIENT
+// ============================================================================
+
+// All curl handles are touched only by the loop thread, so the share handle
+// needs no lock callbacks. Completion callbacks run on the loop thread and
+// must not block: no submit() that could hit the limit, no TokenCache::get().
+class AsyncHttpClient {
+public:
+    struct Options {
+        std::size_t max_concurrency = 64;  // active transfers
+        std::size_t max_pending = 1024;    // queued behind them before submit() blocks
+        long max_host_connections = 0;     // 0: max_concurrency
+        bool http2 = true;                 // HTTP/2 + multiplexing on https origins
+        std::string pinned_public_key;     // "sha256//<base64>", checked per handshake
+    };
+
+    struct Stats {
+        std::uint64_t completed = 0;
+        std::uint64_t failed = 0;           // transport errors, not HTTP status codes
+        std::uint64_t new_connections = 0;  // connections curl had to open
+    };
+
+    using Callback = std::function<void(HttpResponse&&)>;
+
+    AsyncHttpClient() : AsyncHttpClient(Options()) {}
+    explicit AsyncHttpClient(Options options) : options_(std::move(options)) {
+        if (options_.max_concurrency == 0) throw std::invalid_argument("max_concurrency must be > 0");
+        multi_ = curl_multi_init();
+        share_ = curl_share_init();
+        if (!multi_ || !share_) throw std::runtime_error("curl init failed");
+        curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+        curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_multi_setopt(multi_, CURLMOPT_PIPELINING, options_.http2 ? CURLPIPE_MULTIPLEX : CURLPIPE_NOTHING);
+        long per_host = options_.max_host_connections > 0 ? options_.max_host_connections
+                                                          : static_cast<long>(options_.max_concurrency);
+        curl_multi_setopt(multi_, CURLMOPT_MAX_HOST_CONNECTIONS, per_host);
+        // Idle connections kept for reuse
+        curl_multi_setopt(multi_, CURLMOPT_MAXCONNECTS, per_host);
+        loop_ = std::thread([this] { run(); });
+    }
+
+    // Completes everything already submitted, then tears down
+    ~AsyncHttpClient() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        curl_multi_wakeup(multi_);
+        loop_.join();
+        for (CURL* easy : idle_easy_) curl_easy_cleanup(easy);
+        curl_multi_cleanup(multi_);
+        curl_share_cleanup(share_);
+    }
+
+    AsyncHttpClient(const AsyncHttpClient&) = delete;
+    AsyncHttpClient& operator=(const AsyncHttpClient&) = delete;
+
+    void submit(HttpRequest request, Callback done) { enqueue(std::move(request), std::move(done), false); }
+
+    std::future<HttpResponse> submit(HttpRequest request) {
+        auto promise = std::make_shared<std::promise<HttpResponse>>();
+        auto future = promise->get_future();
+        submit(std::move(request), [promise](HttpResponse&& r) { promise->set_value(std::move(r)); });
+        return future;
+    }
+
+    // Goes to the front of the queue and never blocks on max_pending; for
+    // requests others are waiting on, such as a token refresh
+    void submit_priority(HttpRequest request, Callback done) { enqueue(std::move(request), std::move(done), true); }
+
+    void wait_idle() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        space_.wait(lock, [this] { return outstanding_ == 0; });
+    }
+
+    Stats stats() const {
+        Stats s;
+        s.completed = completed_.load();
+        s.failed = failed_.load();
+        s.new_connections = new_connections_.load();
+        return s;
+    }
+
+private:
+    struct Transfer {
+        HttpRequest request;
+        HttpResponse response;
+        Callback done;
+        curl_slist* headers = nullptr;
+        Clock::time_point started;
+        char error[CURL_ERROR_SIZE] = {};
+    };
+
+    void enqueue(HttpRequest request, Callback done, bool priority) {
+        auto t = std::make_unique<Transfer>();
+        t->request = std::move(request);
+        t->done = std::move(done);
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (stopping_) throw std::logic_error("AsyncHttpClient is shutting down");
+            if (priority) {
+                pending_.push_front(std::move(t));
+            } else {
+                space_.wait(lock, [this] { return outstanding_ < options_.max_concurrency + options_.max_pending; });
+                pending_.push_back(std::move(t));
+            }
+            ++outstanding_;
+        }
+        curl_multi_wakeup(multi_);
+    }
+
+    void run() {
+        std::vector<std::unique_ptr<Transfer>> starting;
+        for (;;) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (stopping_ && pending_.empty() && active_ == 0) return;
+                while (active_ + starting.size() < options_.max_concurrency && !pending_.empty()) {
+                    starting.push_back(std::move(pending_.front()));
+                    pending_.pop_front();
+                }
+            }
+            for (auto& t : starting) start(std::move(t));
+            starting.clear();
+
+            int running = 0;
+            curl_multi_perform(multi_, &running);
+            bool finished_any = false;
+            int queued = 0;
+            while (CURLMsg* msg = curl_multi_info_read(multi_, &queued)) {
+                if (msg->msg != CURLMSG_DONE) continue;
+                finish(msg->easy_handle, msg->data.result);
+                finished_any = true;
+            }
+            // Freed slots are refilled before sleeping
+            if (finished_any) continue;
+            curl_multi_poll(multi_, nullptr, 0, 1000, nullptr);
+        }
+    }
+
+    void start(std::unique_ptr<Transfer> t) {
+        CURL* easy;
+        if (!idle_easy_.empty()) {
+            easy = idle_easy_.back();
+            idle_easy_.pop_back();
+            curl_easy_reset(easy);  // keeps the handle's caches, drops options
+        } else {
+            easy = curl_easy_init();
+        }
+        const HttpRequest& req = t->request;
+        curl_easy_setopt(easy, CURLOPT_URL, req.url.c_str());
+        curl_easy_setopt(easy, CURLOPT_SHARE, share_);
+        curl_easy_setopt(easy, CURLOPT_NOSIGNAL, 1L);
+        curl_easy_setopt(easy, CURLOPT_TCP_KEEPALIVE, 1L);
+        curl_easy_setopt(easy, CURLOPT_TIMEOUT_MS, static_cast<long>(req.timeout) * 1000L);
+        curl_easy_setopt(easy, CURLOPT_ERRORBUFFER, t->error);
+        curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, &AsyncHttpClient::write_body);
+        curl_easy_setopt(easy, CURLOPT_WRITEDATA, &t->response);
+        curl_easy_setopt(easy, CURLOPT_HEADERFUNCTION, &AsyncHttpClient::write_header);
+        curl_easy_setopt(easy, CURLOPT_HEADERDATA, &t->response);
+        if (options_.http2) {
+            curl_easy_setopt(easy, CURLOPT_HTTP_VERSION, static_cast<long>(CURL_HTTP_VERSION_2TLS));
+            // Wait for an h2 connection that is being set up instead of
+            // opening a parallel one to the same host
+            curl_easy_setopt(easy, CURLOPT_PIPEWAIT, 1L);
+        } else {
+            curl_easy_setopt(easy, CURLOPT_HTTP_VERSION, static_cast<long>(CURL_HTTP_VERSION_1_1));
+        }
+
+        if (req.method == "POST") {
+            curl_easy_setopt(easy, CURLOPT_POSTFIELDS, req.body.data());
+            curl_easy_setopt(easy, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(req.body.size()));
+        } else if (req.method != "GET") {
+            curl_easy_setopt(easy, CURLOPT_CUSTOMREQUEST, req.method.c_str());
+            if (!req.body.empty()) {
+                curl_easy_setopt(easy, CURLOPT_POSTFIELDS, req.body.data());
+                curl_easy_setopt(easy, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(req.body.size()));
+            }
+        }
+        for (const auto& [name, value] : req.headers)
+            t->headers = curl_slist_append(t->headers, (name + ": " + value).c_str());
+        if (t->headers) curl_easy_setopt(easy, CURLOPT_HTTPHEADER, t->headers);
+
+        curl_easy_setopt(easy, CURLOPT_SSL_VERIFYPEER, req.verifySSL ? 1L : 0L);
+        curl_easy_setopt(easy, CURLOPT_SSL_VERIFYHOST, req.verifySSL ? 2L : 0L);
+        if (!req.caBundlePath.empty()) curl_easy_setopt(easy, CURLOPT_CAINFO, req.caBundlePath.c_str());
+        if (!req.clientCertPath.empty()) curl_easy_setopt(easy, CURLOPT_SSLCERT, req.clientCertPath.c_str());
+        if (!req.clientKeyPath.empty()) curl_easy_setopt(easy, CURLOPT_SSLKEY, req.clientKeyPath.c_str());
+        if (!options_.pinned_public_key.empty())
+            curl_easy_setopt(easy, CURLOPT_PINNEDPUBLICKEY, options_.pinned_public_key.c_str());
+
+        t->started = Clock::now();
+        curl_easy_setopt(easy, CURLOPT_PRIVATE, t.get());
+        curl_multi_add_handle(multi_, easy);
+        t.release();  // owned by the easy handle until finish()
+        ++active_;
+    }
+
+    void finish(CURL* easy, CURLcode result) {
+        Transfer* raw = nullptr;
+        curl_easy_getinfo(easy, CURLINFO_PRIVATE, &raw);
+        std::unique_ptr<Transfer> t(raw);
+
+        long status = 0, connects = 0;
+        curl_easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &status);
+        curl_easy_getinfo(easy, CURLINFO_NUM_CONNECTS, &connects);
+        t->response.statusCode = static_cast<int>(status);
+        t->response.responseTime = static_cast<long>(
+            std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - t->started).count());
+        if (result != CURLE_OK) {
+            t->response.error = t->error[0] ? t->error : curl_easy_strerror(result);
+            ++failed_;
+        }
+        ++completed_;
+        new_connections_ += static_cast<std::uint64_t>(connects);
+
+        curl_multi_remove_handle(multi_, easy);
+        curl_slist_free_all(t->headers);
+        t->headers = nullptr;
+        idle_easy_.push_back(easy);
+        --active_;
+
+        t->done(std::move(t->response));
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --outstanding_;
+        }
+        space_.notify_all();
+    }
+
+    static size_t write_body(char* data, size_t size, size_t nmemb, void* userp) {
+        static_cast<HttpResponse*>(userp)->body.append(data, size * nmemb);
+        return size * nmemb;
+    }
+
+    static size_t write_header(char* data, size_t size, size_t nitems, void* userp) {
+        auto* response = static_cast<HttpResponse*>(userp);
+        std::string line(data, size * nitems);
+        std::size_t colon = line.find(':');
+        if (colon != std::string::npos) {
+            std::string name = line.substr(0, colon);
+            for (char& c : name) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            std::size_t begin = line.find_first_not_of(' ', colon + 1);
+            std::size_t end = line.find_last_not_of("\r\n");
+            response->headers[name] = begin <= end ? line.substr(begin, end - begin + 1) : std::string();
+        }
+        return size * nitems;
+    }
+
+    const Options options_;
+    CURLM* multi_ = nullptr;
+    CURLSH* share_ = nullptr;
+    std::thread loop_;
+
+    // Loop thread only
+    std::vector<CURL*> idle_easy_;
+    std::size_t active_ = 0;
+
+    std::mutex mutex_;
+    std::condition_variable space_;
+    std::deque<std::unique_ptr<Transfer>> pending_;
+    std::size_t outstanding_ = 0;  // pending + active
+    bool stopping_ = false;
+
+    std::atomic<std::uint64_t> completed_{0}, failed_{0}, new_connections_{0};
+};
+
+// ============================================================================
+// TOKEN CACHE
+// ============================================================================
+
+class TokenError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// Expiry is counted from when the refresh was sent, so the cache never
+// believes a token lives longer than the server does. The token stays in
+// memory; SecureStorage only needs to see the refresh token, off this path.
+class TokenCache {
+public:
+    struct Options {
+        std::string token_url;
+        std::string refresh_token;
+        std::chrono::milliseconds refresh_ahead{500};
+    };
+
+    struct Stats {
+        std::uint64_t refreshes = 0;
+        std::uint64_t proactive = 0;  // refreshes started while the token was still valid
+        std::uint64_t waits = 0;      // get() calls that had to wait for a refresh
+    };
+
+    TokenCache(AsyncHttpClient& client, Options options) : client_(client), options_(std::move(options)) {}
+
+    ~TokenCache() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        refreshed_.wait(lock, [this] { return !refreshing_; });
+    }
+
+    // Valid access token; blocks only when there is none. Not for
+    // completion callbacks: the refresh completes on the loop thread.
+    std::string get() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto now = Clock::now();
+        if (current_ && now < current_->refresh_at) return current_->value;
+
+        bool valid = current_ && now < current_->expires;
+        if (!refreshing_ && (!valid || now >= retry_at_)) {
+            if (valid) ++stats_.proactive;
+            start_refresh_locked();
+        }
+        if (valid) return current_->value;
+
+        ++stats_.waits;
+        refreshed_.wait(lock, [this] { return !refreshing_; });
+        if (!current_ || Clock::now() >= current_->expires) throw TokenError("token refresh failed: " + last_error_);
+        return current_->value;
+    }
+
+    // The server rejected this token; the next get() fetches a new one
+    void invalidate(const std::string& token) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (current_ && current_->value == token) current_.reset();
+    }
+
+    Stats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+private:
+    struct Token {
+        std::string value;
+        Clock::time_point expires;
+        Clock::time_point refresh_at;
+    };
+
+    void start_refresh_locked() {
+        HttpRequest req;
+        req.url = options_.token_url;
+        req.method = "POST";
+        req.headers["Content-Type"] = "application/x-www-form-urlencoded";
+        req.body = "grant_type=refresh_token&refresh_token=" + options_.refresh_token;
+        auto sent = Clock::now();
+        // Throws once the client is shutting down; refreshing_ stays false so
+        // nobody waits for a response that never comes. on_response needs
+        // mutex_, which the caller holds, so it cannot run before this is set
+        client_.submit_priority(std::move(req), [this, sent](HttpResponse&& r) { on_response(r, sent); });
+        refreshing_ = true;
+        ++stats_.refreshes;
+    }
+
+    void on_response(const HttpResponse& r, Clock::time_point sent) {
+        std::string token = json_string(r.body, "access_token");
+        long expires_in = json_long(r.body, "expires_in");
+        std::lock_guard<std::mutex> lock(mutex_);
+        refreshing_ = false;
+        if (r.error.empty() && r.statusCode == 200 && !token.empty() && expires_in > 0) {
+            Clock::duration lifetime = std::chrono::seconds(expires_in);
+            Clock::duration ahead = std::min<Clock::duration>(options_.refresh_ahead, lifetime / 2);
+            current_ = std::make_shared<Token>(Token{token, sent + lifetime, sent + lifetime - ahead});
+            last_error_.clear();
+        } else {
+            last_error_ = !r.error.empty() ? r.error : "HTTP " + std::to_string(r.statusCode);
+            // Don't retry a failed proactive refresh on every get()
+            retry_at_ = Clock::now() + std::chrono::milliseconds(100);
+        }
+        refreshed_.notify_all();
+    }
+
+    // Enough JSON for {"key":"string"} and {"key":123}
+    // Position just past the ':' after "key", or npos
+    static std::size_t json_value(const std::string& body, const std::string& key) {
+        std::size_t pos = body.find("\"" + key + "\"");
+        if (pos == std::string::npos) return pos;
+        std::size_t colon = body.find(':', pos);
+        return colon == std::string::npos ? colon : colon + 1;
+    }
+
+    static std::string json_string(const std::string& body, const std::string& key) {
+        std::size_t value = json_value(body, key);
+        std::size_t open = value == std::string::npos ? value : body.find('"', value);
+        std::size_t close = open == std::string::npos ? open : body.find('"', open + 1);
+        return close == std::string::npos ? std::string() : body.substr(open + 1, close - open - 1);
+    }
+
+    static long json_long(const std::string& body, const std::string& key) {
+        std::size_t value = json_value(body, key);
+        if (value == std::string::npos) return 0;
+        return std::strtol(body.c_str() + value, nullptr, 10);
+    }
+
+    AsyncHttpClient& client_;
+    const Options options_;
+    mutable std::mutex mutex_;
+    std::condition_variable refreshed_;
+    std::shared_ptr<const Token> current_;
+    bool refreshing_ = false;
+    Clock::time_point retry_at_{};
+    std::string last_error_;
+    Stats stats_;
+};
+
+// ============================================================================
+// BASELINE
+// ============================================================================
+
+// SecureHttpClient::ExecuteRequest: one blocking transfer per call, either on
+// a fresh easy handle (new connection every time) or on the one member
+// handle, which at least keeps its connection alive between calls
+class BlockingHttpClient {
+public:
+    explicit BlockingHttpClient(bool reuse_handle) : reuse_(reuse_handle) {
+        if (reuse_) handle_ = curl_easy_init();
+    }
+    ~BlockingHttpClient() {
+        if (handle_) curl_easy_cleanup(handle_);
+    }
+
+    BlockingHttpClient(const BlockingHttpClient&) = delete;
+    BlockingHttpClient& operator=(const BlockingHttpClient&) = delete;
+
+    HttpResponse Get(const std::string& url) {
+        CURL* curl = reuse_ ? handle_ : curl_easy_init();
+        if (reuse_) curl_easy_reset(curl);
+        HttpResponse response;
+        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+        curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, &write_body);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
+        CURLcode rc = curl_easy_perform(curl);
+        long status = 0;
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+        response.statusCode = static_cast<int>(status);
+        if (rc != CURLE_OK) response.error = curl_easy_strerror(rc);
+        if (!reuse_) curl_easy_cleanup(curl);
+        return response;
+    }
+
+private:
+    static size_t write_body(char* data, size_t size, size_t nmemb, void* userp) {
+        static_cast<HttpResponse*>(userp)->body.append(data, size * nmemb);
+        return size * nmemb;
+    }
+
+    bool reuse_;
+    CURL* handle_ = nullptr;
+};
+
+// ============================================================================
+// BENCHMARK
+// ============================================================================
+
+double ms_since(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void row(const char* what, int requests, double ms, std::uint64_t connections) {
+    std::cout << "  " << std::left << std::setw(36) << what << std::right << std::fixed << std::setprecision(1)
+              << std::setw(9) << ms << " ms " << std::setw(9) << std::setprecision(0) << requests * 1000.0 / ms
+              << " req/s " << std::setw(6) << connections << " connections\n";
+}
+
+void check(bool ok, const char* what) {
+    if (!ok) {
+        std::cerr << "CHECK FAILED: " << what << "\n";
+        std::exit(1);
+    }
+}
+
+bool is_resource(const HttpResponse& r, int id) {
+    return r.error.empty() && r.statusCode == 200 &&
+           r.body.compare(0, 7 + std::to_string(id).size() + 1, "{\"id\":\"" + std::to_string(id) + "\"") == 0;
+}
+
+void throughput(LoopbackServer& server, std::chrono::microseconds latency, int requests) {
+    server.set_latency(latency);
+    std::cout << "\n" << requests << " GET /public, server latency " << latency.count() << " us\n";
+    const std::string base = server.base_url() + "/public/";
+
+    for (bool reuse : {false, true}) {
+        BlockingHttpClient client(reuse);
+        server.reset_stats();
+        auto start = Clock::now();
+        for (int i = 0; i < requests; ++i) check(is_resource(client.Get(base + std::to_string(i)), i), "blocking GET");
+        row(reuse ? "blocking, one kept-alive handle" : "blocking, new handle per call", requests, ms_since(start),
+            server.stats().connections);
+    }
+
+    for (std::size_t concurrency : {std::size_t{8}, std::size_t{64}}) {
+        AsyncHttpClient::Options options;
+        options.max_concurrency = concurrency;
+        options.max_pending = 256;
+        AsyncHttpClient client(options);
+        server.reset_stats();
+        std::atomic<int> ok{0};
+        auto start = Clock::now();
+        for (int i = 0; i < requests; ++i) {
+            HttpRequest req;
+            req.url = base + std::to_string(i);
+            client.submit(std::move(req), [&ok, i](HttpResponse&& r) { ok += is_resource(r, i); });
+        }
+        client.wait_idle();
+        double ms = ms_since(start);
+        check(ok == requests, "async GET");
+        check(client.stats().new_connections == server.stats().connections, "client and server agree on connections");
+        std::string label = "async, " + std::to_string(concurrency) + " in flight";
+        row(label.c_str(), requests, ms, server.stats().connections);
+    }
+}
+
+struct TokenRun {
+    int requests = 0;
+    std::uint64_t rejected = 0;
+    TokenCache::Stats cache;
+    std::uint64_t tokens_issued = 0;
+};
+
+// Authenticated calls for `duration`, tokens expiring every second
+TokenRun token_run(LoopbackServer& server, std::chrono::milliseconds refresh_ahead, std::chrono::milliseconds duration) {
+    AsyncHttpClient::Options options;
+    options.max_concurrency = 16;
+    options.max_pending = 64;
+    AsyncHttpClient client(options);
+    TokenCache tokens(client, {server.base_url() + "/token", "refresh-secret", refresh_ahead});
+    server.reset_stats();
+
+    TokenRun run;
+    std::atomic<std::uint64_t> rejected{0};
+    auto deadline = Clock::now() + duration;
+    for (int i = 0; Clock::now() < deadline; ++i, ++run.requests) {
+        HttpRequest req;
+        req.url = server.base_url() + "/resource/" + std::to_string(i);
+        std::string token = tokens.get();
+        req.headers["Authorization"] = "Bearer " + token;
+        client.submit(std::move(req), [&, i, token](HttpResponse&& r) {
+            if (r.statusCode == 401) {
+                ++rejected;
+                tokens.invalidate(token);
+            } else {
+                check(is_resource(r, i), "authenticated GET");
+            }
+        });
+    }
+    client.wait_idle();
+    run.rejected = rejected;
+    run.cache = tokens.stats();
+    run.tokens_issued = server.stats().tokens_issued;
+    return run;
+}
+
+int main() {
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    const curl_version_info_data* info = curl_version_info(CURLVERSION_NOW);
+    std::cout << "libcurl " << info->version << ", " << (info->ssl_version ? info->ssl_version : "no TLS")
+              << ", HTTP/2 " << ((info->features & CURL_VERSION_HTTP2) ? "available" : "not available") << "\n";
+    std::cout << "loopback server speaks HTTP/1.1 over plain TCP, so these runs reuse connections but do\n"
+                 "not multiplex; against an https origin the same client negotiates h2\n";
+
+    {
+        LoopbackServer server;
+        throughput(server, std::chrono::microseconds(0), 2000);
+        throughput(server, std::chrono::microseconds(1000), 1000);
+
+        // Futures and error reporting
+        AsyncHttpClient client;
+        HttpRequest missing;
+        missing.url = server.base_url() + "/nowhere";
+        check(client.submit(std::move(missing)).get().statusCode == 404, "404 passes through");
+        HttpRequest refused;
+        refused.url = "http://127.0.0.1:1/";
+        HttpResponse r = client.submit(std::move(refused)).get();
+        check(!r.error.empty() && r.statusCode == 0, "connection error reported");
+        server.set_latency(std::chrono::microseconds(0));
+    }
+
+    {
+        LoopbackServer server(std::chrono::seconds(1));
+        server.set_latency(std::chrono::microseconds(500));
+        std::cout << "\nauthenticated GET /resource for 2.5 s, tokens live 1 s, server latency 500 us\n";
+        for (auto ahead : {std::chrono::milliseconds(300), std::chrono::milliseconds(0)}) {
+            TokenRun run = token_run(server, ahead, std::chrono::milliseconds(2500));
+            std::cout << "  refresh " << std::setw(3) << ahead.count() << " ms ahead: " << std::setw(6) << run.requests
+                      << " requests, " << run.tokens_issued << " tokens issued, " << run.cache.proactive
+                      << " proactive refreshes, " << run.cache.waits << " callers waited, " << run.rejected
+                      << " rejected (401)\n";
+            check(run.cache.refreshes == run.tokens_issued, "one server call per refresh");
+            if (ahead.count() > 0) check(run.rejected == 0, "proactive refresh never sends an expired token");
+        }
+    }
+
+    curl_global_cleanup();
+    std::cout << "\nall checks passed\n";
+    return 0;
+}
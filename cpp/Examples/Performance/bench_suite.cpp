@@ -0,0 +1,248 @@
+// BENCHMARK SUITE ON THE IN-TREE HARNESS
+//
+// The PerformanceTest cases from Refreshers/25_testing.cpp rerun on
+// Examples/bench_harness.hpp:
+//   - vector vs linked-list sum; the list both in allocation order (what the
+//     refresher measured, nodes nearly contiguous) and shuffled
+//   - read/write bandwidth over 256 KiB and 64 MiB, reading 8-byte words
+//     instead of one volatile char at a time
+//   - hash map inserts, std::sort with input regeneration paused out of the
+//     timing, and direct vs std::function calls
+//
+// Each result is the median ns/iteration over calibrated samples with its
+// spread; --json writes the raw samples and --compare reads an earlier run
+// and reports which benchmarks got significantly faster or slower.
+//
+//   ./bench_suite --json base.json             baseline
+//   ./bench_suite --compare base.json          exit status 2 on a regression
+//   options: --cpu N (pin), --filter SUBSTR, --samples N, --min-time-ms N,
+//            --threshold PCT (default 5)
+//
+// Build: g++ -std=c++17 -O2 bench_suite.cpp -o bench_suite
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../bench_harness.hpp"
+
+// ============================================================================
+// BENCHMARKS
+// ============================================================================
+
+struct Node {
+    int value;
+    Node* next;
+};
+
+// Nodes from one array, linked either in array order or in a random order
+class LinkedList {
+public:
+    LinkedList(std::size_t n, bool shuffled) : nodes_(n) {
+        std::vector<std::size_t> order(n);
+        std::iota(order.begin(), order.end(), 0);
+        if (shuffled) std::shuffle(order.begin(), order.end(), std::mt19937_64(42));
+        for (std::size_t i = 0; i < n; ++i) {
+            nodes_[order[i]].value = static_cast<int>(i);
+            nodes_[order[i]].next = i + 1 < n ? &nodes_[order[i + 1]] : nullptr;
+        }
+        head_ = n ? &nodes_[order[0]] : nullptr;
+    }
+
+    long long sum() const {
+        long long s = 0;
+        for (const Node* p = head_; p; p = p->next) s += p->value;
+        return s;
+    }
+
+private:
+    std::vector<Node> nodes_;
+    Node* head_ = nullptr;
+};
+
+std::uint64_t read_words(const std::uint64_t* p, std::size_t n) {
+    // Four accumulators so the loop is bound by loads, not by one add chain
+    std::uint64_t a = 0, b = 0, c = 0, d = 0;
+    for (std::size_t i = 0; i + 4 <= n; i += 4) {
+        a += p[i];
+        b += p[i + 1];
+        c += p[i + 2];
+        d += p[i + 3];
+    }
+    return a + b + c + d;
+}
+
+__attribute__((noinline)) int add_one(int x) { return x + 1; }
+
+struct Case {
+    std::string name;
+    std::function<void(bench::State&)> body;
+};
+
+std::vector<Case> make_cases() {
+    std::vector<Case> cases;
+    const std::size_t n = 1'000'000;
+
+    cases.push_back({"sum/vector_1M", [n](bench::State& state) {
+                         static std::vector<int> v = [n] {
+                             std::vector<int> init(n);
+                             std::iota(init.begin(), init.end(), 0);
+                             return init;
+                         }();
+                         for (auto _ : state) bench::do_not_optimize(std::accumulate(v.begin(), v.end(), 0LL));
+                         state.set_items_processed(v.size());
+                     }});
+    cases.push_back({"sum/list_1M_in_order", [n](bench::State& state) {
+                         static LinkedList list(n, false);
+                         for (auto _ : state) bench::do_not_optimize(list.sum());
+                         state.set_items_processed(n);
+                     }});
+    cases.push_back({"sum/list_1M_shuffled", [n](bench::State& state) {
+                         static LinkedList list(n, true);
+                         for (auto _ : state) bench::do_not_optimize(list.sum());
+                         state.set_items_processed(n);
+                     }});
+
+    for (std::size_t bytes : {std::size_t{256} << 10, std::size_t{64} << 20}) {
+        std::string size = bytes < (1u << 20) ? std::to_string(bytes >> 10) + "KiB" : std::to_string(bytes >> 20) + "MiB";
+        auto buffer = std::make_shared<std::vector<std::uint64_t>>(bytes / 8, 1);
+        cases.push_back({"memory/read_" + size, [buffer](bench::State& state) {
+                             for (auto _ : state) bench::do_not_optimize(read_words(buffer->data(), buffer->size()));
+                             state.set_bytes_processed(buffer->size() * 8);
+                         }});
+        cases.push_back({"memory/write_" + size, [buffer](bench::State& state) {
+                             std::uint64_t round = 0;
+                             for (auto _ : state) {
+                                 std::fill(buffer->begin(), buffer->end(), ++round);
+                                 bench::clobber_memory();
+                             }
+                             state.set_bytes_processed(buffer->size() * 8);
+                         }});
+    }
+
+    cases.push_back({"unordered_map/insert_100k", [](bench::State& state) {
+                         const int count = 100'000;
+                         for (auto _ : state) {
+                             std::unordered_map<int, int> map;
+                             for (int i = 0; i < count; ++i) map[i] = i * 2;
+                             bench::do_not_optimize(map.size());
+                         }
+                         state.set_items_processed(count);
+                     }});
+
+    cases.push_back({"sort/std_sort_100k", [](bench::State& state) {
+                         std::vector<int> v(100'000);
+                         std::mt19937 gen(7);
+                         for (auto _ : state) {
+                             state.pause();
+                             std::generate(v.begin(), v.end(), [&] { return static_cast<int>(gen() % 10000); });
+                             state.resume();
+                             std::sort(v.begin(), v.end());
+                             bench::do_not_optimize(v.data());
+                         }
+                         state.set_items_processed(v.size());
+                     }});
+
+    cases.push_back({"call/direct", [](bench::State& state) {
+                         int x = 0;
+                         for (auto _ : state) {
+                             x = add_one(x);
+                             bench::do_not_optimize(x);
+                         }
+                     }});
+    cases.push_back({"call/std_function", [](bench::State& state) {
+                         std::function<int(int)> f = add_one;
+                         bench::do_not_optimize(f);
+                         int x = 0;
+                         for (auto _ : state) {
+                             x = f(x);
+                             bench::do_not_optimize(x);
+                         }
+                     }});
+    return cases;
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main(int argc, char** argv) {
+    bench::Options options;
+    std::string json_path, compare_path, filter;
+    double threshold = 0.05;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&]() -> const char* {
+            if (i + 1 >= argc) {
+                std::cerr << arg << " needs a value\n";
+                std::exit(1);
+            }
+            return argv[++i];
+        };
+        if (arg == "--json") json_path = value();
+        else if (arg == "--compare") compare_path = value();
+        else if (arg == "--filter") filter = value();
+        else if (arg == "--cpu") options.pin_cpu = std::atoi(value());
+        else if (arg == "--samples") options.samples = static_cast<std::size_t>(std::atoi(value()));
+        else if (arg == "--min-time-ms") options.min_sample_time = std::chrono::milliseconds(std::atoi(value()));
+        else if (arg == "--threshold") threshold = std::atof(value()) / 100.0;
+        else {
+            std::cerr << "unknown option " << arg << "\n";
+            return 1;
+        }
+    }
+
+    {
+        bench::PerfCounters probe;
+        std::cout << "counters:";
+        for (int c = 0; c < bench::counter_count; ++c)
+            std::cout << " " << bench::counter_name(c) << (probe.available(c) ? "" : "(n/a)");
+        std::cout << "\n";
+        if (options.pin_cpu >= 0) {
+            bench::CpuPin pin(options.pin_cpu);
+            std::cout << "pinned to cpu " << options.pin_cpu << (pin.cpu() < 0 ? " FAILED" : "") << "\n";
+        }
+        std::cout << "\n";
+    }
+
+    std::vector<bench::Result> results;
+    bench::print_header(std::cout);
+    for (const Case& c : make_cases()) {
+        if (!filter.empty() && c.name.find(filter) == std::string::npos) continue;
+        results.push_back(bench::run(c.name, c.body, options));
+        bench::print(std::cout, results.back());
+    }
+
+    if (!json_path.empty()) {
+        std::ofstream out(json_path);
+        bench::write_json(out, results);
+        if (!out) {
+            std::cerr << "cannot write " << json_path << "\n";
+            return 1;
+        }
+        std::cout << "\nwrote " << json_path << "\n";
+    }
+
+    if (!compare_path.empty()) {
+        std::ifstream in(compare_path);
+        if (!in) {
+            std::cerr << "cannot read " << compare_path << "\n";
+            return 1;
+        }
+        auto comparisons = bench::compare(bench::read_json(in), results, threshold);
+        std::cout << "\nagainst " << compare_path << " (threshold " << threshold * 100 << "%, alpha 0.01)\n";
+        bench::print(std::cout, comparisons);
+        if (bench::has_regression(comparisons)) return 2;
+    }
+    return 0;
+}
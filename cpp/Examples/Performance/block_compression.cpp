@@ -0,0 +1,731 @@
+// LZ4-STYLE BLOCK COMPRESSION, STREAMING API, PARALLEL FRAMES
+//
+// Codec: LZ77 with a single-probe hash table and LZ4's sequence format
+//   [token: 4 bit literal len | 4 bit match len-4] [len ext] [literals]
+//   [offset u16 LE] [match len ext]
+// Frame: independent blocks so they can be compressed/decompressed in
+// parallel, plus a block index at the end for random access:
+//   header   "SLZ1" | u32 block_size | u64 raw_size
+//   block*   u32 stored_size (bit 31 = stored uncompressed) | u32 raw_size
+//            | u32 checksum(raw) | payload
+//   end      u32 0 (lets a streaming decoder stop without the index)
+//   index    u64 offset per block | u32 block_count | u64 index_offset | "SIDX"
+//
+// Build: g++ -std=c++20 -O3 -march=native -pthread block_compression.cpp
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Bytes = std::vector<std::uint8_t>;
+using ByteSpan = std::span<const std::uint8_t>;
+
+
+// LITTLE-ENDIAN HELPERS
+
+inline std::uint32_t read32(const std::uint8_t* p) { std::uint32_t v; std::memcpy(&v, p, 4); return v; }
+inline std::uint64_t read64(const std::uint8_t* p) { std::uint64_t v; std::memcpy(&v, p, 8); return v; }
+
+inline void put32(Bytes& out, std::uint32_t v) { for (int i = 0; i < 4; ++i) out.push_back(static_cast<std::uint8_t>(v >> (8 * i))); }
+inline void put64(Bytes& out, std::uint64_t v) { for (int i = 0; i < 8; ++i) out.push_back(static_cast<std::uint8_t>(v >> (8 * i))); }
+inline void store32(std::uint8_t* p, std::uint32_t v) { for (int i = 0; i < 4; ++i) p[i] = static_cast<std::uint8_t>(v >> (8 * i)); }
+
+inline std::uint32_t get32(ByteSpan s, std::size_t at) {
+    if (at + 4 > s.size()) throw std::runtime_error("truncated frame");
+    std::uint32_t v = 0;
+    for (int i = 0; i < 4; ++i) v |= std::uint32_t(s[at + i]) << (8 * i);
+    return v;
+}
+
+inline std::uint64_t get64(ByteSpan s, std::size_t at) {
+    return get32(s, at) | (std::uint64_t(get32(s, at + 4)) << 32);
+}
+
+// Word-at-a-time 32-bit hash, cheap enough not to dominate decompression
+inline std::uint32_t checksum32(ByteSpan data) {
+    std::uint64_t h = 0x9E3779B97F4A7C15ull ^ data.size();
+    std::size_t i = 0;
+    for (; i + 8 <= data.size(); i += 8) {
+        h = (h ^ read64(data.data() + i)) * 0xFF51AFD7ED558CCDull;
+        h ^= h >> 29;
+    }
+    for (; i < data.size(); ++i) h = (h ^ data[i]) * 0x100000001B3ull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 33;
+    return static_cast<std::uint32_t>(h);
+}
+
+
+// BLOCK CODEC
+
+namespace lz {
+
+constexpr std::size_t MIN_MATCH = 4;
+constexpr std::size_t MF_LIMIT = 12;      // no match may start in the last 12 bytes
+constexpr std::size_t LAST_LITERALS = 5;  // last 5 bytes are always literals
+constexpr std::size_t MAX_DISTANCE = 65535;
+constexpr unsigned HASH_LOG = 14;
+
+constexpr std::size_t bound(std::size_t n) { return n + n / 255 + 16; }
+
+inline std::uint32_t hash4(std::uint32_t v) { return (v * 2654435761u) >> (32 - HASH_LOG); }
+
+inline void write_length(std::uint8_t*& op, std::size_t len) {
+    while (len >= 255) {
+        *op++ = 255;
+        len -= 255;
+    }
+    *op++ = static_cast<std::uint8_t>(len);
+}
+
+inline std::uint8_t* emit_literals_only(std::uint8_t* op, const std::uint8_t* lit, std::size_t len) {
+    if (len >= 15) {
+        *op++ = 15 << 4;
+        write_length(op, len - 15);
+    } else {
+        *op++ = static_cast<std::uint8_t>(len << 4);
+    }
+    std::memcpy(op, lit, len);
+    return op + len;
+}
+
+// Returns bytes written to dst (dst must hold bound(n) bytes)
+inline std::size_t compress(const std::uint8_t* src, std::size_t n, std::uint8_t* dst) {
+    std::uint8_t* op = dst;
+    if (n < MF_LIMIT + 1) {
+        return static_cast<std::size_t>(emit_literals_only(op, src, n) - dst);
+    }
+
+    std::uint32_t table[1u << HASH_LOG] = {};
+    const std::size_t match_start_limit = n - MF_LIMIT;
+    const std::size_t match_end_limit = n - LAST_LITERALS;
+
+    std::size_t anchor = 0;
+    std::size_t ip = 1;
+    table[hash4(read32(src))] = 0;
+
+    while (true) {
+        // Find a match; the step grows while nothing is found (skips incompressible data fast)
+        std::size_t ref;
+        unsigned attempts = 1u << 6;
+        while (true) {
+            if (ip > match_start_limit) goto last_literals;
+            std::uint32_t seq = read32(src + ip);
+            std::uint32_t h = hash4(seq);
+            ref = table[h];
+            table[h] = static_cast<std::uint32_t>(ip);
+            if (ip - ref <= MAX_DISTANCE && read32(src + ref) == seq && ref < ip) break;
+            ip += attempts++ >> 6;
+        }
+
+        // Extend backwards into pending literals
+        while (ip > anchor && ref > 0 && src[ip - 1] == src[ref - 1]) {
+            --ip;
+            --ref;
+        }
+
+        // Extend forwards, 8 bytes at a time
+        std::size_t len = MIN_MATCH;
+        while (ip + len + 8 <= match_end_limit) {
+            std::uint64_t diff = read64(src + ip + len) ^ read64(src + ref + len);
+            if (diff) {
+                len += static_cast<std::size_t>(__builtin_ctzll(diff) >> 3);
+                goto matched;
+            }
+            len += 8;
+        }
+        while (ip + len < match_end_limit && src[ip + len] == src[ref + len]) ++len;
+    matched:
+
+        {
+            std::size_t lit_len = ip - anchor;
+            std::size_t ml = len - MIN_MATCH;
+            std::uint8_t* token = op++;
+            *token = static_cast<std::uint8_t>(((lit_len >= 15 ? 15 : lit_len) << 4) | (ml >= 15 ? 15 : ml));
+            if (lit_len >= 15) write_length(op, lit_len - 15);
+            std::memcpy(op, src + anchor, lit_len);
+            op += lit_len;
+
+            std::size_t offset = ip - ref;
+            *op++ = static_cast<std::uint8_t>(offset);
+            *op++ = static_cast<std::uint8_t>(offset >> 8);
+            if (ml >= 15) write_length(op, ml - 15);
+        }
+
+        ip += len;
+        anchor = ip;
+        if (ip > match_start_limit) break;
+        table[hash4(read32(src + ip - 2))] = static_cast<std::uint32_t>(ip - 2);
+    }
+
+last_literals:
+    op = emit_literals_only(op, src + anchor, n - anchor);
+    return static_cast<std::size_t>(op - dst);
+}
+
+// Bounds-checked: malformed input throws instead of overrunning dst
+inline void decompress(const std::uint8_t* src, std::size_t n, std::uint8_t* dst, std::size_t raw) {
+    std::size_t ip = 0, op = 0;
+    auto read_length = [&](std::size_t len) {
+        std::uint8_t b;
+        do {
+            if (ip >= n) throw std::runtime_error("lz: truncated length");
+            b = src[ip++];
+            len += b;
+        } while (b == 255);
+        return len;
+    };
+
+    while (ip < n) {
+        std::uint8_t token = src[ip++];
+
+        std::size_t lit_len = token >> 4;
+        if (lit_len == 15) lit_len = read_length(lit_len);
+        if (lit_len > n - ip || lit_len > raw - op) throw std::runtime_error("lz: literal overrun");
+        if (lit_len <= 16 && n - ip >= 16 && raw - op >= 16) {
+            std::memcpy(dst + op, src + ip, 16);   // fixed-size copy, overshoot is rewritten later
+        } else {
+            std::memcpy(dst + op, src + ip, lit_len);
+        }
+        ip += lit_len;
+        op += lit_len;
+
+        if (ip == n) break;   // last sequence has no match
+
+        if (n - ip < 2) throw std::runtime_error("lz: truncated offset");
+        std::size_t offset = src[ip] | (std::size_t(src[ip + 1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > op) throw std::runtime_error("lz: bad offset");
+
+        std::size_t len = token & 15;
+        if (len == 15) len = read_length(len);
+        len += MIN_MATCH;
+        if (len > raw - op) throw std::runtime_error("lz: match overrun");
+
+        std::uint8_t* out = dst + op;
+        const std::uint8_t* match = out - offset;
+        if (offset >= 8) {
+            // Chunks never overlap their own source when offset >= 8; round
+            // up to whole chunks while there is room past the match
+            std::size_t i = 0;
+            if (raw - op >= len + 8) {
+                for (; i < len; i += 8) std::memcpy(out + i, match + i, 8);
+            } else {
+                for (; i + 8 <= len; i += 8) std::memcpy(out + i, match + i, 8);
+                for (; i < len; ++i) out[i] = match[i];
+            }
+        } else {
+            for (std::size_t i = 0; i < len; ++i) out[i] = match[i];   // overlapping run
+        }
+        op += len;
+    }
+
+    if (op != raw) throw std::runtime_error("lz: size mismatch");
+}
+
+} // namespace lz
+
+
+// FRAME FORMAT
+
+constexpr std::uint32_t FRAME_MAGIC = 0x315A4C53;   // "SLZ1"
+constexpr std::uint32_t INDEX_MAGIC = 0x58444953;   // "SIDX"
+constexpr std::uint32_t STORED_FLAG = 0x80000000u;
+constexpr std::size_t HEADER_SIZE = 16;
+constexpr std::size_t BLOCK_HEADER_SIZE = 12;
+constexpr std::size_t TRAILER_SIZE = 16;
+constexpr std::uint32_t END_MARK = 0;   // a real block always has stored_size >= 1
+
+// One compressed block with its header, ready to append to a frame
+inline Bytes encode_block(ByteSpan raw) {
+    Bytes out(BLOCK_HEADER_SIZE + lz::bound(raw.size()));
+    std::size_t size = lz::compress(raw.data(), raw.size(), out.data() + BLOCK_HEADER_SIZE);
+
+    std::uint32_t stored = static_cast<std::uint32_t>(size);
+    if (size >= raw.size()) {
+        // Incompressible: store raw bytes, decoding becomes a memcpy
+        std::memcpy(out.data() + BLOCK_HEADER_SIZE, raw.data(), raw.size());
+        size = raw.size();
+        stored = static_cast<std::uint32_t>(size) | STORED_FLAG;
+    }
+    out.resize(BLOCK_HEADER_SIZE + size);
+
+    store32(out.data(), stored);
+    store32(out.data() + 4, static_cast<std::uint32_t>(raw.size()));
+    store32(out.data() + 8, checksum32(raw));
+    return out;
+}
+
+struct BlockInfo {
+    std::size_t payload_offset;
+    std::size_t payload_size;
+    std::size_t raw_size;
+    std::uint32_t checksum;
+    bool stored;
+};
+
+inline BlockInfo parse_block_header(ByteSpan frame, std::size_t at) {
+    if (at > frame.size() || frame.size() - at < BLOCK_HEADER_SIZE) throw std::runtime_error("truncated block");
+    std::uint32_t stored = get32(frame, at);
+    BlockInfo info{at + BLOCK_HEADER_SIZE, stored & ~STORED_FLAG, get32(frame, at + 4),
+                   get32(frame, at + 8), (stored & STORED_FLAG) != 0};
+    if (info.payload_offset + info.payload_size > frame.size()) throw std::runtime_error("truncated block");
+    return info;
+}
+
+inline void decode_block(ByteSpan frame, const BlockInfo& b, std::uint8_t* out) {
+    const std::uint8_t* payload = frame.data() + b.payload_offset;
+    if (b.stored) {
+        if (b.payload_size != b.raw_size) throw std::runtime_error("bad stored block");
+        std::memcpy(out, payload, b.raw_size);
+    } else {
+        lz::decompress(payload, b.payload_size, out, b.raw_size);
+    }
+    if (checksum32(ByteSpan(out, b.raw_size)) != b.checksum) throw std::runtime_error("block checksum mismatch");
+}
+
+
+// STREAMING ENCODER
+
+// Accepts input in arbitrary pieces, emits the frame through `sink` as
+// blocks complete. Up to `threads` full blocks are compressed concurrently.
+class FrameWriter {
+public:
+    using Sink = std::function<void(ByteSpan)>;
+
+    explicit FrameWriter(Sink sink, std::size_t block_size = 256 * 1024, unsigned threads = 1)
+        : sink_(std::move(sink)), block_size_(block_size), threads_(std::max(1u, threads)) {
+        pending_.reserve(block_size_ * threads_);
+        Bytes header;
+        put32(header, FRAME_MAGIC);
+        put32(header, static_cast<std::uint32_t>(block_size_));
+        put64(header, 0);   // raw size unknown while streaming; the index records it
+        emit(header);
+    }
+
+    void write(ByteSpan data) {
+        while (!data.empty()) {
+            std::size_t room = block_size_ * threads_ - pending_.size();
+            std::size_t take = std::min(room, data.size());
+            pending_.insert(pending_.end(), data.begin(), data.begin() + take);
+            data = data.subspan(take);
+            if (pending_.size() == block_size_ * threads_) flush_pending();
+        }
+    }
+
+    void finish() {
+        flush_pending();
+        Bytes index;
+        put32(index, END_MARK);
+        std::uint64_t index_offset = written_ + 4;
+        for (std::uint64_t off : offsets_) put64(index, off);
+        put32(index, static_cast<std::uint32_t>(offsets_.size()));
+        put64(index, index_offset);
+        put32(index, INDEX_MAGIC);
+        emit(index);
+    }
+
+private:
+    void flush_pending() {
+        if (pending_.empty()) return;
+        std::size_t blocks = (pending_.size() + block_size_ - 1) / block_size_;
+        std::vector<Bytes> encoded(blocks);
+
+        auto encode = [&](std::size_t b) {
+            std::size_t lo = b * block_size_;
+            std::size_t hi = std::min(pending_.size(), lo + block_size_);
+            encoded[b] = encode_block(ByteSpan(pending_.data() + lo, hi - lo));
+        };
+
+        if (blocks == 1) {
+            encode(0);
+        } else {
+            std::vector<std::thread> workers;
+            for (std::size_t b = 0; b < blocks; ++b) workers.emplace_back(encode, b);
+            for (auto& w : workers) w.join();
+        }
+
+        for (auto& block : encoded) {
+            offsets_.push_back(written_);
+            emit(block);
+        }
+        pending_.clear();
+    }
+
+    void emit(const Bytes& bytes) {
+        sink_(ByteSpan(bytes));
+        written_ += bytes.size();
+    }
+
+    Sink sink_;
+    std::size_t block_size_;
+    unsigned threads_;
+    Bytes pending_;
+    std::vector<std::uint64_t> offsets_;
+    std::uint64_t written_ = 0;
+};
+
+// Whole-buffer parallel compression: blocks handed out dynamically
+inline Bytes compress_frame(ByteSpan input, std::size_t block_size = 256 * 1024, unsigned threads = 0) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    std::size_t blocks = (input.size() + block_size - 1) / block_size;
+    std::vector<Bytes> encoded(blocks);
+
+    std::atomic<std::size_t> next{0};
+    auto worker = [&] {
+        for (std::size_t b; (b = next.fetch_add(1)) < blocks;) {
+            std::size_t lo = b * block_size;
+            encoded[b] = encode_block(input.subspan(lo, std::min(block_size, input.size() - lo)));
+        }
+    };
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < std::min<std::size_t>(threads, blocks); ++t) workers.emplace_back(worker);
+    worker();
+    for (auto& w : workers) w.join();
+
+    Bytes frame;
+    std::size_t total = HEADER_SIZE + 4 + TRAILER_SIZE + 8 * blocks;
+    for (auto& b : encoded) total += b.size();
+    frame.reserve(total);
+
+    put32(frame, FRAME_MAGIC);
+    put32(frame, static_cast<std::uint32_t>(block_size));
+    put64(frame, input.size());
+    std::vector<std::uint64_t> offsets;
+    for (auto& b : encoded) {
+        offsets.push_back(frame.size());
+        frame.insert(frame.end(), b.begin(), b.end());
+    }
+    put32(frame, END_MARK);
+    std::uint64_t index_offset = frame.size();
+    for (auto off : offsets) put64(frame, off);
+    put32(frame, static_cast<std::uint32_t>(blocks));
+    put64(frame, index_offset);
+    put32(frame, INDEX_MAGIC);
+    return frame;
+}
+
+
+// STREAMING DECODER
+
+// Feed the frame in arbitrary pieces (e.g. straight from recv()); decoded
+// blocks are delivered through `sink` as soon as each one is complete.
+class FrameDecoder {
+public:
+    using Sink = std::function<void(ByteSpan)>;
+
+    explicit FrameDecoder(Sink sink) : sink_(std::move(sink)) {}
+
+    void feed(ByteSpan data) {
+        buffer_.insert(buffer_.end(), data.begin(), data.end());
+        std::size_t pos = 0;
+        while (true) {
+            ByteSpan avail(buffer_.data() + pos, buffer_.size() - pos);
+            if (!header_done_) {
+                if (avail.size() < HEADER_SIZE) break;
+                if (get32(avail, 0) != FRAME_MAGIC) throw std::runtime_error("not an SLZ1 frame");
+                block_size_ = get32(avail, 4);
+                if (block_size_ == 0) throw std::runtime_error("bad block size");
+                header_done_ = true;
+                pos += HEADER_SIZE;
+                continue;
+            }
+            if (done_ || avail.size() < 4) break;
+
+            std::uint32_t stored = get32(avail, 0);
+            if (stored == END_MARK) {
+                done_ = true;   // the index that follows is only needed for random access
+                break;
+            }
+            if (avail.size() < BLOCK_HEADER_SIZE) break;
+            std::uint32_t raw = get32(avail, 4);
+            if (raw > block_size_) throw std::runtime_error("block larger than block size");
+            std::size_t payload = stored & ~STORED_FLAG;
+            if (avail.size() < BLOCK_HEADER_SIZE + payload) break;   // partial block, wait for more
+
+            BlockInfo info{BLOCK_HEADER_SIZE, payload, raw, get32(avail, 8), (stored & STORED_FLAG) != 0};
+            out_.resize(raw);
+            decode_block(avail, info, out_.data());
+            sink_(ByteSpan(out_));
+            pos += BLOCK_HEADER_SIZE + payload;
+        }
+        buffer_.erase(buffer_.begin(), buffer_.begin() + static_cast<std::ptrdiff_t>(pos));
+    }
+
+    bool finished() const { return done_; }
+
+private:
+    Sink sink_;
+    Bytes buffer_;
+    Bytes out_;
+    std::size_t block_size_ = 0;
+    bool header_done_ = false;
+    bool done_ = false;
+};
+
+
+// RANDOM-ACCESS READER
+
+class FrameReader {
+public:
+    explicit FrameReader(ByteSpan frame) : frame_(frame) {
+        if (frame.size() < HEADER_SIZE + TRAILER_SIZE || get32(frame, 0) != FRAME_MAGIC ||
+            get32(frame, frame.size() - 4) != INDEX_MAGIC) {
+            throw std::runtime_error("not an SLZ1 frame");
+        }
+        block_size_ = get32(frame, 4);
+        if (block_size_ == 0) throw std::runtime_error("bad block size");
+        std::size_t count = get32(frame, frame.size() - TRAILER_SIZE);
+        std::size_t index_offset = get64(frame, frame.size() - 12);
+        if (count > frame.size() / 8 || index_offset != frame.size() - TRAILER_SIZE - 8 * count) throw std::runtime_error("bad index");
+
+        // Every block but the last is exactly block_size; the header's
+        // sizes are checked here so decoding can trust them
+        blocks_.reserve(count);
+        starts_.reserve(count + 1);
+        raw_size_ = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            BlockInfo info = parse_block_header(frame, get64(frame, index_offset + 8 * i));
+            if (info.raw_size > block_size_ || (i + 1 < count && info.raw_size != block_size_)) {
+                throw std::runtime_error("bad block size in index");
+            }
+            starts_.push_back(raw_size_);
+            raw_size_ += info.raw_size;
+            blocks_.push_back(info);
+        }
+        starts_.push_back(raw_size_);
+        if (get64(frame, 8) != raw_size_) throw std::runtime_error("frame size mismatch");
+    }
+
+    std::size_t raw_size() const { return raw_size_; }
+    std::size_t block_count() const { return blocks_.size(); }
+
+    // Decompress only the blocks overlapping [offset, offset + len)
+    Bytes read(std::size_t offset, std::size_t len) const {
+        len = std::min(len, raw_size_ - std::min(offset, raw_size_));
+        Bytes out(len), scratch(block_size_);
+        // Last block starting at or before offset
+        std::size_t b = std::upper_bound(starts_.begin(), starts_.end() - 1, offset) - starts_.begin() - 1;
+        std::size_t done = 0;
+        while (done < len) {
+            decode_block(frame_, blocks_[b], scratch.data());
+            std::size_t in_block = (offset + done) - starts_[b];
+            std::size_t n = std::min(len - done, blocks_[b].raw_size - in_block);
+            std::memcpy(out.data() + done, scratch.data() + in_block, n);
+            done += n;
+            ++b;
+        }
+        return out;
+    }
+
+    Bytes read_all(unsigned threads = 0) const {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        Bytes out(raw_size_);
+        std::atomic<std::size_t> next{0};
+        auto worker = [&] {
+            for (std::size_t b; (b = next.fetch_add(1)) < blocks_.size();) {
+                decode_block(frame_, blocks_[b], out.data() + starts_[b]);
+            }
+        };
+        std::vector<std::thread> workers;
+        for (unsigned t = 1; t < std::min<std::size_t>(threads, blocks_.size()); ++t) workers.emplace_back(worker);
+        worker();
+        for (auto& w : workers) w.join();
+        return out;
+    }
+
+private:
+    ByteSpan frame_;
+    std::size_t block_size_ = 0;
+    std::size_t raw_size_ = 0;
+    std::vector<BlockInfo> blocks_;
+    std::vector<std::size_t> starts_;   // raw offset of each block, plus the total
+};
+
+
+// STRATEGY ADAPTER (same interface as the refresher's CompressionStrategy)
+
+class CompressionStrategy {
+public:
+    virtual ~CompressionStrategy() = default;
+    virtual std::string compress(const std::string& data) const = 0;
+    virtual std::string decompress(const std::string& data) const = 0;
+    virtual std::string getName() const = 0;
+};
+
+class BlockLzCompression : public CompressionStrategy {
+public:
+    explicit BlockLzCompression(unsigned threads = 0) : threads(threads) {}
+
+    std::string compress(const std::string& data) const override {
+        auto in = ByteSpan(reinterpret_cast<const std::uint8_t*>(data.data()), data.size());
+        Bytes frame = compress_frame(in, 256 * 1024, threads);
+        return std::string(frame.begin(), frame.end());
+    }
+
+    std::string decompress(const std::string& data) const override {
+        FrameReader reader(ByteSpan(reinterpret_cast<const std::uint8_t*>(data.data()), data.size()));
+        Bytes raw = reader.read_all(threads);
+        return std::string(raw.begin(), raw.end());
+    }
+
+    std::string getName() const override { return "LZ block frame"; }
+
+private:
+    unsigned threads;
+};
+
+
+// BENCHMARK
+
+Bytes make_text(std::size_t n, std::mt19937& rng) {
+    static const char* words[] = {"the", "quick", "brown", "fox", "jumps", "over", "lazy", "dog",
+                                  "compression", "strategy", "pattern", "buffer", "stream", "block",
+                                  "decorator", "thread", "memory", "cache", "latency", "throughput"};
+    Bytes out;
+    out.reserve(n + 32);
+    std::geometric_distribution<int> zipf_like(0.25);
+    while (out.size() < n) {
+        const char* w = words[std::min(19, zipf_like(rng))];
+        out.insert(out.end(), w, w + std::strlen(w));
+        out.push_back(rng() % 12 == 0 ? '\n' : ' ');
+    }
+    out.resize(n);
+    return out;
+}
+
+Bytes make_logs(std::size_t n, std::mt19937& rng) {
+    Bytes out;
+    out.reserve(n + 128);
+    std::uint64_t ts = 1700000000000;
+    static const char* levels[] = {"INFO", "DEBUG", "WARN", "ERROR"};
+    char line[160];
+    while (out.size() < n) {
+        ts += rng() % 50;
+        int len = std::snprintf(line, sizeof(line),
+                                "%llu level=%s service=orders req_id=%08x latency_us=%u status=%u\n",
+                                static_cast<unsigned long long>(ts), levels[rng() % 4],
+                                static_cast<unsigned>(rng()), static_cast<unsigned>(rng() % 5000),
+                                rng() % 10 ? 200u : 500u);
+        out.insert(out.end(), line, line + len);
+    }
+    out.resize(n);
+    return out;
+}
+
+Bytes make_random(std::size_t n, std::mt19937& rng) {
+    Bytes out(n);
+    for (auto& b : out) b = static_cast<std::uint8_t>(rng());
+    return out;
+}
+
+template<typename F>
+double time_s(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double> s = std::chrono::steady_clock::now() - start;
+    return s.count();
+}
+
+void benchmark(const char* name, const Bytes& input, unsigned threads) {
+    double mb = input.size() / 1e6;
+
+    Bytes frame1, frameN;
+    double c1 = time_s([&] { frame1 = compress_frame(input, 256 * 1024, 1); });
+    double cN = time_s([&] { frameN = compress_frame(input, 256 * 1024, threads); });
+
+    FrameReader reader(frameN);
+    Bytes out1, outN;
+    double d1 = time_s([&] { out1 = reader.read_all(1); });
+    double dN = time_s([&] { outN = reader.read_all(threads); });
+
+    // Streaming round trip in odd-sized pieces
+    Bytes streamed_frame, streamed_out;
+    {
+        FrameWriter writer([&](ByteSpan s) { streamed_frame.insert(streamed_frame.end(), s.begin(), s.end()); },
+                           64 * 1024, threads);
+        for (std::size_t i = 0; i < input.size(); i += 10007) {
+            writer.write(ByteSpan(input).subspan(i, std::min<std::size_t>(10007, input.size() - i)));
+        }
+        writer.finish();
+        FrameDecoder decoder([&](ByteSpan s) { streamed_out.insert(streamed_out.end(), s.begin(), s.end()); });
+        for (std::size_t i = 0; i < streamed_frame.size(); i += 4099) {
+            decoder.feed(ByteSpan(streamed_frame).subspan(i, std::min<std::size_t>(4099, streamed_frame.size() - i)));
+        }
+    }
+
+    // Random access: 200 reads of 4 KB
+    std::mt19937 rng(3);
+    bool ra_ok = true;
+    double ra = time_s([&] {
+        for (int i = 0; i < 200; ++i) {
+            std::size_t off = rng() % (input.size() - 4096);
+            Bytes slice = reader.read(off, 4096);
+            ra_ok &= std::equal(slice.begin(), slice.end(), input.begin() + off);
+        }
+    });
+
+    bool ok = out1 == input && outN == input && streamed_out == input && ra_ok &&
+              FrameReader(frame1).read_all() == input;
+
+    std::cout << name << ": ratio " << double(frameN.size()) / input.size()
+              << " | compress " << mb / c1 << " MB/s (1T), " << mb / cN << " MB/s (" << threads << "T)"
+              << " | decompress " << mb / d1 << " MB/s (1T), " << mb / dN << " MB/s (" << threads << "T)"
+              << " | 4KB random read " << ra / 200 * 1e6 << " us"
+              << (ok ? "" : "  ROUND TRIP FAILED") << "\n";
+}
+
+int main() {
+    std::cout.precision(4);
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    std::mt19937 rng(11);
+    const std::size_t n = 64 * 1024 * 1024;
+
+    benchmark("text  ", make_text(n, rng), threads);
+    benchmark("logs  ", make_logs(n, rng), threads);
+    benchmark("random", make_random(n, rng), threads);
+
+    // Behind the Strategy interface
+    BlockLzCompression strategy;
+    std::string sample(100000, 'a');
+    for (std::size_t i = 0; i < sample.size(); i += 7) sample[i] = static_cast<char>('a' + i % 26);
+    std::string packed = strategy.compress(sample);
+    std::cout << strategy.getName() << ": " << sample.size() << " -> " << packed.size() << " bytes, "
+              << (strategy.decompress(packed) == sample ? "round trip ok" : "ROUND TRIP FAILED") << "\n";
+
+    // Corrupted input is rejected, not crashed on
+    packed[packed.size() / 2] ^= 0x5A;
+    try {
+        strategy.decompress(packed);
+        std::cout << "corruption NOT detected\n";
+    } catch (const std::exception& e) {
+        std::cout << "corruption detected: " << e.what() << "\n";
+    }
+
+    // A header block_size that disagrees with the blocks is rejected before
+    // anything is decoded into a buffer sized from it
+    Bytes small = compress_frame(ByteSpan(reinterpret_cast<const std::uint8_t*>(sample.data()), sample.size()),
+                                 4096, 1);
+    for (std::uint32_t forged : {0u, 8192u}) {
+        Bytes bad = small;
+        store32(bad.data() + 4, forged);
+        try {
+            FrameReader(bad).read_all();
+            std::cout << "block_size " << forged << " NOT rejected\n";
+        } catch (const std::exception& e) {
+            std::cout << "block_size " << forged << " rejected: " << e.what() << "\n";
+        }
+    }
+}
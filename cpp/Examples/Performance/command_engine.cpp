@@ -0,0 +1,472 @@
+// COMMAND EXECUTION ENGINE: PRIORITY LANES, AGING, BACKPRESSURE, BATCHING
+//
+// The refresher's CommandQueue runs every command on one thread, from one
+// unbounded FIFO, one lock round-trip per command. This engine adds:
+//   - N worker threads
+//   - priority lanes with aging: a command's score is its enqueue time plus
+//     lane * aging_step, and the lowest score runs first. A low-priority
+//     command therefore waits at most 2 * aging_step longer than a
+//     high-priority one arriving at the same time, so nothing starves.
+//   - bounded capacity: submit() blocks, try_submit() rejects
+//   - batch dequeue: a worker takes several commands per lock acquisition,
+//     capped by its fair share so one worker cannot hoard the queue
+//   - per-lane histograms of queue wait and service time, plus an optional
+//     per-command trace hook
+//
+// Build: g++ -std=c++20 -O3 -pthread command_engine.cpp
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+class Command {
+public:
+    virtual ~Command() = default;
+    virtual void execute() = 0;
+    virtual void undo() = 0;
+    virtual std::string getDescription() const = 0;
+};
+
+
+// LATENCY HISTOGRAM (log-linear, 16 sub-buckets per power of two, ~6% error)
+
+class LatencyHistogram {
+public:
+    void record(std::uint64_t ns) {
+        ++counts[bucket(ns)];
+        ++total;
+        max = std::max(max, ns);
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for (std::size_t i = 0; i < counts.size(); ++i) counts[i] += other.counts[i];
+        total += other.total;
+        max = std::max(max, other.max);
+    }
+
+    std::uint64_t percentile(double p) const {
+        if (total == 0) return 0;
+        auto rank = static_cast<std::uint64_t>(p / 100.0 * static_cast<double>(total - 1)) + 1;
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < counts.size(); ++i) {
+            seen += counts[i];
+            if (seen >= rank) return std::min(lower_bound(i), max);
+        }
+        return max;
+    }
+
+    std::uint64_t count() const { return total; }
+
+private:
+    static std::size_t bucket(std::uint64_t v) {
+        if (v < 16) return static_cast<std::size_t>(v);
+        unsigned e = 63u - static_cast<unsigned>(__builtin_clzll(v));
+        return (e - 3) * 16 + ((v >> (e - 4)) & 15);
+    }
+
+    static std::uint64_t lower_bound(std::size_t i) {
+        if (i < 16) return i;
+        unsigned e = static_cast<unsigned>(i / 16 + 3);
+        return (16 + i % 16) << (e - 4);
+    }
+
+    std::array<std::uint64_t, 64 * 16> counts{};
+    std::uint64_t total = 0;
+    std::uint64_t max = 0;
+};
+
+
+// ENGINE
+
+enum class Priority : std::uint8_t { High, Normal, Low };
+constexpr std::size_t LANES = 3;
+
+struct EngineOptions {
+    unsigned workers = std::max(2u, std::thread::hardware_concurrency());
+    std::size_t capacity = 1024;
+    std::size_t max_batch = 16;
+    // Queueing time that buys one priority level; a step of hours means
+    // strict priority
+    std::chrono::nanoseconds aging_step = std::chrono::milliseconds(1);
+};
+
+struct TraceEvent {
+    Priority priority;
+    unsigned worker;
+    std::chrono::nanoseconds wait;
+    std::chrono::nanoseconds service;
+    bool failed;
+};
+
+struct EngineStats {
+    std::array<LatencyHistogram, LANES> wait;
+    std::array<LatencyHistogram, LANES> service;
+    std::uint64_t executed = 0;
+    std::uint64_t failed = 0;
+    std::uint64_t rejected = 0;
+    std::uint64_t batches = 0;
+};
+
+class CommandEngine {
+public:
+    enum class SubmitResult { Accepted, Rejected, Closed };
+
+    explicit CommandEngine(EngineOptions options = {}, std::function<void(const TraceEvent&)> tracer = {})
+        : options(options), tracer(std::move(tracer)), locals(options.workers) {
+        for (unsigned i = 0; i < options.workers; ++i) workers.emplace_back(&CommandEngine::run, this, i);
+    }
+
+    ~CommandEngine() { shutdown(); }
+
+    CommandEngine(const CommandEngine&) = delete;
+    CommandEngine& operator=(const CommandEngine&) = delete;
+
+    // Blocks while the engine is full; returns false once shut down
+    bool submit(std::unique_ptr<Command> command, Priority priority = Priority::Normal) {
+        std::unique_lock<std::mutex> lock(mutex);
+        not_full.wait(lock, [this] { return count < options.capacity || closed; });
+        if (closed) return false;
+        push(std::move(command), priority);
+        lock.unlock();
+        not_empty.notify_one();
+        return true;
+    }
+
+    // Never blocks: a full engine rejects, which the caller can surface as 503/retry
+    SubmitResult try_submit(std::unique_ptr<Command> command, Priority priority = Priority::Normal) {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (closed) return SubmitResult::Closed;
+        if (count >= options.capacity) {
+            ++rejected;
+            return SubmitResult::Rejected;
+        }
+        push(std::move(command), priority);
+        lock.unlock();
+        not_empty.notify_one();
+        return SubmitResult::Accepted;
+    }
+
+    // Stop accepting, run everything already queued, join the workers
+    void shutdown() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (closed && workers.empty()) return;
+            closed = true;
+        }
+        not_empty.notify_all();
+        not_full.notify_all();
+        for (auto& w : workers) w.join();
+        workers.clear();
+    }
+
+    std::size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return count;
+    }
+
+    EngineStats stats() const {
+        EngineStats out;
+        for (const auto& local : locals) {
+            std::lock_guard<std::mutex> lock(local.mutex);
+            for (std::size_t l = 0; l < LANES; ++l) {
+                out.wait[l].merge(local.stats.wait[l]);
+                out.service[l].merge(local.stats.service[l]);
+            }
+            out.executed += local.stats.executed;
+            out.failed += local.stats.failed;
+            out.batches += local.stats.batches;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        out.rejected = rejected;
+        return out;
+    }
+
+private:
+    struct Entry {
+        std::unique_ptr<Command> command;
+        Clock::time_point enqueued;
+        Priority priority;
+    };
+
+    // Per-worker stats: only its own worker writes, once per batch
+    struct WorkerLocal {
+        mutable std::mutex mutex;
+        EngineStats stats;
+    };
+
+    void push(std::unique_ptr<Command> command, Priority priority) {
+        lanes[static_cast<std::size_t>(priority)].push_back({std::move(command), Clock::now(), priority});
+        ++count;
+    }
+
+    // Lowest (enqueue time + lane * aging_step) wins. Each lane is FIFO, so
+    // only the heads need comparing.
+    Entry pop_best() {
+        std::size_t best = LANES;
+        Clock::time_point best_score{};
+        for (std::size_t l = 0; l < LANES; ++l) {
+            if (lanes[l].empty()) continue;
+            auto score = lanes[l].front().enqueued + l * options.aging_step;
+            if (best == LANES || score < best_score) {
+                best = l;
+                best_score = score;
+            }
+        }
+        Entry e = std::move(lanes[best].front());
+        lanes[best].pop_front();
+        --count;
+        return e;
+    }
+
+    void run(unsigned index) {
+        std::vector<Entry> batch;
+        std::vector<TraceEvent> events;
+        batch.reserve(options.max_batch);
+        events.reserve(options.max_batch);
+        WorkerLocal& local = locals[index];
+
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                not_empty.wait(lock, [this] { return count > 0 || closed; });
+                if (count == 0) return;   // closed and drained
+
+                std::size_t share = std::max<std::size_t>(1, count / options.workers);
+                std::size_t take = std::min(options.max_batch, share);
+                while (batch.size() < take && count > 0) batch.push_back(pop_best());
+            }
+            not_full.notify_all();   // several slots may have opened
+
+            events.clear();
+            for (Entry& e : batch) {
+                auto start = Clock::now();
+                bool failed = false;
+                try {
+                    e.command->execute();
+                } catch (...) {
+                    failed = true;
+                }
+                auto end = Clock::now();
+                events.push_back({e.priority, index, start - e.enqueued, end - start, failed});
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(local.mutex);
+                for (const TraceEvent& ev : events) {
+                    auto lane = static_cast<std::size_t>(ev.priority);
+                    local.stats.wait[lane].record(static_cast<std::uint64_t>(ev.wait.count()));
+                    local.stats.service[lane].record(static_cast<std::uint64_t>(ev.service.count()));
+                    ++local.stats.executed;
+                    local.stats.failed += ev.failed;
+                }
+                ++local.stats.batches;
+            }
+            if (tracer) {
+                for (const TraceEvent& ev : events) tracer(ev);
+            }
+            batch.clear();
+        }
+    }
+
+    EngineOptions options;
+    std::function<void(const TraceEvent&)> tracer;
+
+    mutable std::mutex mutex;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+    std::array<std::deque<Entry>, LANES> lanes;
+    std::size_t count = 0;
+    std::uint64_t rejected = 0;
+    bool closed = false;
+
+    std::vector<WorkerLocal> locals;
+    std::vector<std::thread> workers;
+};
+
+
+// BASELINE: the refresher's single-worker FIFO
+
+class SimpleCommandQueue {
+public:
+    SimpleCommandQueue() : worker(&SimpleCommandQueue::processCommands, this) {}
+
+    ~SimpleCommandQueue() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running = false;
+        }
+        cv.notify_all();
+        worker.join();
+    }
+
+    void enqueue(std::unique_ptr<Command> command) {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push(std::move(command));
+        cv.notify_one();
+    }
+
+private:
+    void processCommands() {
+        while (true) {
+            std::unique_ptr<Command> command;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [this] { return !queue.empty() || !running; });
+                if (queue.empty()) break;
+                command = std::move(queue.front());
+                queue.pop();
+            }
+            command->execute();
+        }
+    }
+
+    std::queue<std::unique_ptr<Command>> queue;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool running = true;
+    std::thread worker;
+};
+
+
+// BENCHMARK
+
+// Spins for a fixed time, then reports its own queueing delay
+class WorkCommand : public Command {
+public:
+    explicit WorkCommand(std::chrono::nanoseconds work, LatencyHistogram* sink = nullptr,
+                         std::mutex* sink_mutex = nullptr)
+        : work(work), created(Clock::now()), sink(sink), sink_mutex(sink_mutex) {}
+
+    void execute() override {
+        auto start = Clock::now();
+        if (sink) {
+            std::lock_guard<std::mutex> lock(*sink_mutex);
+            sink->record(static_cast<std::uint64_t>((start - created).count()));
+        }
+        while (Clock::now() - start < work) {}
+    }
+
+    void undo() override {}
+    std::string getDescription() const override { return "work"; }
+
+private:
+    std::chrono::nanoseconds work;
+    Clock::time_point created;
+    LatencyHistogram* sink;
+    std::mutex* sink_mutex;
+};
+
+constexpr unsigned PRODUCERS = 4;
+constexpr std::size_t PER_PRODUCER = 25000;
+constexpr auto WORK = std::chrono::microseconds(2);
+
+// 10% high, 30% normal, 60% low
+Priority pick_priority(std::mt19937& rng) {
+    unsigned r = rng() % 10;
+    return r == 0 ? Priority::High : r < 4 ? Priority::Normal : Priority::Low;
+}
+
+template<typename Submit>
+double drive(Submit submit) {
+    auto start = Clock::now();
+    std::vector<std::thread> producers;
+    for (unsigned p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&, p] {
+            std::mt19937 rng(p + 1);
+            for (std::size_t i = 0; i < PER_PRODUCER; ++i) submit(pick_priority(rng));
+        });
+    }
+    for (auto& t : producers) t.join();
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+void print_lane_latencies(const EngineStats& s) {
+    static const char* names[] = {"high  ", "normal", "low   "};
+    for (std::size_t l = 0; l < LANES; ++l) {
+        std::cout << "    " << names[l] << " wait p50 " << s.wait[l].percentile(50) / 1e3 << " us, p99 "
+                  << s.wait[l].percentile(99) / 1e3 << " us, p99.9 " << s.wait[l].percentile(99.9) / 1e3
+                  << " us\n";
+    }
+}
+
+void run_engine(const char* name, EngineOptions options) {
+    std::atomic<std::uint64_t> traced{0};
+    double seconds;
+    EngineStats stats;
+    {
+        CommandEngine engine(options, [&](const TraceEvent&) { traced.fetch_add(1, std::memory_order_relaxed); });
+        auto start = Clock::now();
+        drive([&](Priority p) { engine.submit(std::make_unique<WorkCommand>(WORK), p); });
+        engine.shutdown();
+        seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        stats = engine.stats();
+    }
+    std::cout << name << ": " << stats.executed / seconds / 1e3 << " k cmds/s, "
+              << double(stats.executed) / stats.batches << " cmds/batch, " << traced << " traced\n";
+    print_lane_latencies(stats);
+}
+
+int main() {
+    std::cout.precision(4);
+    const std::size_t total = PRODUCERS * PER_PRODUCER;
+    std::cout << PRODUCERS << " producers, " << total << " commands of " << WORK.count()
+              << " us each, 10% high / 30% normal / 60% low\n";
+
+    {
+        LatencyHistogram wait;
+        std::mutex wait_mutex;
+        auto start = Clock::now();
+        {
+            SimpleCommandQueue queue;
+            drive([&](Priority) { queue.enqueue(std::make_unique<WorkCommand>(WORK, &wait, &wait_mutex)); });
+        }
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        std::cout << "single-worker FIFO (unbounded): " << total / seconds / 1e3 << " k cmds/s\n"
+                  << "    all    wait p50 " << wait.percentile(50) / 1e3 << " us, p99 " << wait.percentile(99) / 1e3
+                  << " us, p99.9 " << wait.percentile(99.9) / 1e3 << " us\n";
+    }
+
+    EngineOptions strict;
+    strict.aging_step = std::chrono::hours(24);
+    run_engine("engine, strict priority", strict);
+
+    EngineOptions aging;
+    aging.aging_step = std::chrono::milliseconds(1);
+    run_engine("engine, 1 ms aging", aging);
+
+    EngineOptions unbatched = aging;
+    unbatched.max_batch = 1;
+    run_engine("engine, 1 ms aging, no batching", unbatched);
+
+    // Rejecting submit under overload
+    {
+        EngineOptions small = aging;
+        small.capacity = 256;
+        CommandEngine engine(small);
+        std::atomic<std::uint64_t> accepted{0};
+        drive([&](Priority p) {
+            if (engine.try_submit(std::make_unique<WorkCommand>(WORK), p) == CommandEngine::SubmitResult::Accepted) {
+                accepted.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+        engine.shutdown();
+        auto s = engine.stats();
+        std::cout << "try_submit, capacity 256: " << accepted << " accepted, " << s.rejected << " rejected, "
+                  << s.executed << " executed\n";
+    }
+}
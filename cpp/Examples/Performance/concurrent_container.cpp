@@ -0,0 +1,555 @@
+// CONCURRENT POLICY-BASED CONTAINER
+//
+// Grows the policy-based Container from Refreshers/23_advanced_templates.cpp
+// into one that is safe under concurrent readers and writers:
+//   - ChunkedStorage: elements live in chunks that double in size and never
+//     move, so appends never invalidate what a reader is looking at; the
+//     element count is published with release/acquire
+//   - locking policies decide how a cell is read and written:
+//       MutexLock        one mutex for everything (baseline)
+//       SharedMutexLock  readers share, writers exclude (std::shared_mutex)
+//       SeqLock          per-cell sequence counter; readers never write
+//                        shared memory, they copy and retry if a writer
+//                        overlapped. For small trivially-copyable values.
+//       EpochRcu         cells hold pointers; writers publish a new copy
+//                        and retire the old one, freed once no reader that
+//                        could have seen it is still inside a read section.
+//                        For read-mostly data, large values included.
+// Writers (set and add) are serialized by every policy; the policies differ
+// in what readers pay.
+//
+// Build: g++ -std=c++17 -O2 -pthread concurrent_container.cpp
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <random>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// ============================================================================
+// CHUNKED STORAGE
+// ============================================================================
+
+// Chunk k holds 2^(BaseBits + k) cells, so 48 chunk pointers cover any
+// realistic size and an index maps to (chunk, offset) with one bit scan.
+// push() needs external writer exclusion; operator[] may run concurrently
+// with push() for any index below size().
+template<typename Cell, unsigned BaseBits = 6>
+class ChunkedStorage {
+public:
+    ChunkedStorage() = default;
+    ChunkedStorage(const ChunkedStorage&) = delete;
+    ChunkedStorage& operator=(const ChunkedStorage&) = delete;
+
+    ~ChunkedStorage() {
+        std::size_t n = size_.load(std::memory_order_relaxed);
+        for (std::size_t i = 0; i < n; ++i) (*this)[i].~Cell();
+        for (auto& chunk : chunks_) ::operator delete(chunk.load(std::memory_order_relaxed));
+    }
+
+    std::size_t size() const { return size_.load(std::memory_order_acquire); }
+
+    Cell& operator[](std::size_t i) {
+        auto [chunk, offset] = locate(i);
+        return chunks_[chunk].load(std::memory_order_relaxed)[offset];
+    }
+    const Cell& operator[](std::size_t i) const { return const_cast<ChunkedStorage&>(*this)[i]; }
+
+    // Constructs the next cell, then publishes it; returns its index
+    template<typename... Args>
+    std::size_t push(Args&&... args) {
+        std::size_t i = size_.load(std::memory_order_relaxed);
+        auto [chunk, offset] = locate(i);
+        Cell* cells = chunks_[chunk].load(std::memory_order_relaxed);
+        if (!cells) {
+            if (chunk >= kMaxChunks) throw std::length_error("ChunkedStorage full");
+            cells = static_cast<Cell*>(::operator new(sizeof(Cell) << (BaseBits + chunk)));
+            chunks_[chunk].store(cells, std::memory_order_relaxed);
+        }
+        new (cells + offset) Cell(std::forward<Args>(args)...);
+        size_.store(i + 1, std::memory_order_release);
+        return i;
+    }
+
+private:
+    static constexpr std::size_t kMaxChunks = 48;
+
+    static std::pair<std::size_t, std::size_t> locate(std::size_t i) {
+        std::size_t j = i + (std::size_t{1} << BaseBits);
+        unsigned top = 63u - static_cast<unsigned>(__builtin_clzll(j));
+        return {top - BaseBits, j - (std::size_t{1} << top)};
+    }
+
+    std::atomic<Cell*> chunks_[kMaxChunks] = {};
+    std::atomic<std::size_t> size_{0};
+};
+
+// ============================================================================
+// LOCKING POLICIES
+// ============================================================================
+
+// A policy provides:
+//   cell<T>                      what the storage holds per element
+//   write(f)                     runs f with writers excluded
+//   load(const cell<T>&) -> T    reads a cell, safe against concurrent write()
+//   store(cell<T>&, const T&)    called inside write()
+//   visit(const cell<T>&, f)     calls f(const T&) without an extra copy
+//                                where the policy allows it
+
+template<typename T>
+struct PlainCell {
+    T value;
+    explicit PlainCell(const T& v) : value(v) {}
+};
+
+class MutexLock {
+public:
+    template<typename T> using cell = PlainCell<T>;
+
+    template<typename F>
+    void write(F&& f) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        f();
+    }
+
+    template<typename T>
+    T load(const cell<T>& c) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return c.value;
+    }
+
+    template<typename T>
+    void store(cell<T>& c, const T& v) { c.value = v; }
+
+    template<typename T, typename F>
+    auto visit(const cell<T>& c, F&& f) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return f(c.value);
+    }
+
+private:
+    mutable std::mutex mutex_;
+};
+
+class SharedMutexLock {
+public:
+    template<typename T> using cell = PlainCell<T>;
+
+    template<typename F>
+    void write(F&& f) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        f();
+    }
+
+    template<typename T>
+    T load(const cell<T>& c) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return c.value;
+    }
+
+    template<typename T>
+    void store(cell<T>& c, const T& v) { c.value = v; }
+
+    template<typename T, typename F>
+    auto visit(const cell<T>& c, F&& f) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return f(c.value);
+    }
+
+private:
+    mutable std::shared_mutex mutex_;
+};
+
+// The value lives in relaxed atomic words so a reader racing a writer reads
+// torn data through atomics (well defined) and throws it away, instead of
+// racing on plain memory.
+template<typename T>
+struct SeqCell {
+    static_assert(std::is_trivially_copyable_v<T>, "SeqLock needs trivially copyable values");
+    static_assert(sizeof(T) <= 64, "SeqLock is for small values; use EpochRcu for large ones");
+    static constexpr std::size_t kWords = (sizeof(T) + 7) / 8;
+
+    std::atomic<uint32_t> seq{0};   // odd while a write is in progress
+    std::atomic<uint64_t> words[kWords];
+
+    explicit SeqCell(const T& v) { write_words(v); }
+
+    void write_words(const T& v) {
+        uint64_t buf[kWords] = {};
+        std::memcpy(buf, &v, sizeof(T));
+        for (std::size_t w = 0; w < kWords; ++w) words[w].store(buf[w], std::memory_order_relaxed);
+    }
+
+    T read_words() const {
+        uint64_t buf[kWords];
+        for (std::size_t w = 0; w < kWords; ++w) buf[w] = words[w].load(std::memory_order_relaxed);
+        T v;
+        std::memcpy(&v, buf, sizeof(T));
+        return v;
+    }
+};
+
+class SeqLock {
+public:
+    template<typename T> using cell = SeqCell<T>;
+
+    template<typename F>
+    void write(F&& f) {
+        std::lock_guard<std::mutex> lock(writer_);
+        f();
+    }
+
+    template<typename T>
+    T load(const cell<T>& c) const {
+        for (;;) {
+            uint32_t before = c.seq.load(std::memory_order_acquire);
+            if (before & 1) {
+                std::this_thread::yield();
+                continue;
+            }
+            T v = c.read_words();
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (c.seq.load(std::memory_order_relaxed) == before) return v;
+        }
+    }
+
+    template<typename T>
+    void store(cell<T>& c, const T& v) {
+        uint32_t s = c.seq.load(std::memory_order_relaxed);
+        c.seq.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        c.write_words(v);
+        c.seq.store(s + 2, std::memory_order_release);
+    }
+
+    template<typename T, typename F>
+    auto visit(const cell<T>& c, F&& f) const {
+        T v = load(c);
+        return f(v);
+    }
+
+private:
+    std::mutex writer_;
+};
+
+// Epoch-based reclamation shared by every EpochRcu container. A reader marks
+// its slot with the epoch it entered in; a writer tags a retired object with
+// the epoch at retirement and bumps the epoch. The object is freed once every
+// active slot is newer than the tag: readers that entered later can only have
+// seen the replacement pointer.
+class EpochDomain {
+public:
+    static EpochDomain& instance() {
+        static EpochDomain domain;
+        return domain;
+    }
+
+    ~EpochDomain() {
+        for (auto& r : retired_) r.destroy(r.object);
+    }
+
+    class ReadGuard {
+    public:
+        ReadGuard() : slot_(EpochDomain::instance().enter()) {}
+        ~ReadGuard() { EpochDomain::instance().leave(slot_); }
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+    private:
+        std::size_t slot_;
+    };
+
+    template<typename T>
+    void retire(const T* object) {
+        std::lock_guard<std::mutex> lock(retire_mutex_);
+        uint64_t tag = epoch_.fetch_add(1, std::memory_order_seq_cst);
+        retired_.push_back({const_cast<T*>(object), tag, [](void* p) { delete static_cast<T*>(p); }});
+        if (retired_.size() >= kReclaimBatch) reclaim();
+    }
+
+    std::size_t pending() const {
+        std::lock_guard<std::mutex> lock(retire_mutex_);
+        return retired_.size();
+    }
+
+private:
+    static constexpr std::size_t kMaxReaders = 256;
+    static constexpr std::size_t kReclaimBatch = 64;
+
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> epoch{0};   // 0: not reading
+        std::atomic<bool> claimed{false};
+    };
+
+    struct Retired {
+        void* object;
+        uint64_t tag;
+        void (*destroy)(void*);
+    };
+
+    // Each thread claims a slot on first use and frees it at thread exit
+    struct Registration {
+        std::size_t slot = kMaxReaders;
+        unsigned depth = 0;   // nested ReadGuards
+        ~Registration() {
+            if (slot != kMaxReaders) EpochDomain::instance().slots_[slot].claimed.store(false, std::memory_order_release);
+        }
+    };
+
+    static Registration& registration() {
+        thread_local Registration reg;
+        return reg;
+    }
+
+    std::size_t enter() {
+        Registration& reg = registration();
+        if (reg.slot == kMaxReaders) {
+            for (std::size_t i = 0; i < kMaxReaders; ++i) {
+                bool expected = false;
+                if (slots_[i].claimed.compare_exchange_strong(expected, true)) {
+                    reg.slot = i;
+                    break;
+                }
+            }
+            if (reg.slot == kMaxReaders) throw std::runtime_error("EpochDomain: too many reader threads");
+        }
+        if (reg.depth++ == 0) {
+            // seq_cst store/load pair with retire()'s exchange + scan: either
+            // the writer sees this slot or this reader sees the new pointer
+            slots_[reg.slot].epoch.store(epoch_.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+        }
+        return reg.slot;
+    }
+
+    void leave(std::size_t slot) {
+        if (--registration().depth == 0) slots_[slot].epoch.store(0, std::memory_order_release);
+    }
+
+    void reclaim() {
+        uint64_t oldest = UINT64_MAX;
+        for (auto& s : slots_) {
+            uint64_t e = s.epoch.load(std::memory_order_seq_cst);
+            if (e != 0) oldest = std::min(oldest, e);
+        }
+        auto keep = std::partition(retired_.begin(), retired_.end(),
+                                   [&](const Retired& r) { return r.tag >= oldest; });
+        for (auto it = keep; it != retired_.end(); ++it) it->destroy(it->object);
+        retired_.erase(keep, retired_.end());
+    }
+
+    std::atomic<uint64_t> epoch_{1};
+    Slot slots_[kMaxReaders];
+    mutable std::mutex retire_mutex_;
+    std::vector<Retired> retired_;
+};
+
+template<typename T>
+struct RcuCell {
+    std::atomic<const T*> ptr;
+    explicit RcuCell(const T& v) : ptr(new T(v)) {}
+    ~RcuCell() { delete ptr.load(std::memory_order_relaxed); }
+};
+
+class EpochRcu {
+public:
+    template<typename T> using cell = RcuCell<T>;
+
+    template<typename F>
+    void write(F&& f) {
+        std::lock_guard<std::mutex> lock(writer_);
+        f();
+    }
+
+    template<typename T>
+    T load(const cell<T>& c) const {
+        EpochDomain::ReadGuard guard;
+        return *c.ptr.load(std::memory_order_seq_cst);
+    }
+
+    template<typename T>
+    void store(cell<T>& c, const T& v) {
+        const T* old = c.ptr.exchange(new T(v), std::memory_order_seq_cst);
+        EpochDomain::instance().retire(old);
+    }
+
+    // The reference is valid for the duration of f
+    template<typename T, typename F>
+    auto visit(const cell<T>& c, F&& f) const {
+        EpochDomain::ReadGuard guard;
+        return f(*c.ptr.load(std::memory_order_seq_cst));
+    }
+
+private:
+    std::mutex writer_;
+};
+
+// ============================================================================
+// CONTAINER
+// ============================================================================
+
+template<typename T, typename LockingPolicy,
+         template<typename> class StoragePolicy = ChunkedStorage>
+class Container {
+public:
+    using Cell = typename LockingPolicy::template cell<T>;
+
+    std::size_t add(const T& value) {
+        std::size_t index = 0;
+        lock_.write([&] { index = storage_.push(value); });
+        return index;
+    }
+
+    void set(std::size_t index, const T& value) {
+        assert(index < size());
+        lock_.write([&] { lock_.store(storage_[index], value); });
+    }
+
+    // Unchecked in release builds: the hot path is a load, not a branch
+    T get(std::size_t index) const {
+        assert(index < size());
+        return lock_.load(storage_[index]);
+    }
+
+    T at(std::size_t index) const {
+        if (index >= size()) throw std::out_of_range("Container::at");
+        return lock_.load(storage_[index]);
+    }
+
+    template<typename F>
+    auto visit(std::size_t index, F&& f) const {
+        assert(index < size());
+        return lock_.visit(storage_[index], std::forward<F>(f));
+    }
+
+    std::size_t size() const { return storage_.size(); }
+
+private:
+    StoragePolicy<Cell> storage_;
+    mutable LockingPolicy lock_;
+};
+
+// ============================================================================
+// BENCHMARK
+// ============================================================================
+
+// bid and ask are always written together with ask == bid + 1, so a torn
+// read shows up as a broken invariant
+struct Quote {
+    uint64_t id;
+    double bid;
+    double ask;
+};
+
+struct MixResult {
+    double mops;
+    uint64_t torn;
+    std::size_t final_size;
+};
+
+template<typename Policy>
+MixResult run_mix(int threads, int write_per_mille, int ops_per_thread) {
+    Container<Quote, Policy> container;
+    for (uint64_t i = 0; i < 100'000; ++i) container.add({i, double(i), double(i) + 1});
+
+    std::atomic<uint64_t> torn{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::mt19937_64 rng(t + 1);
+            uint64_t local_torn = 0;
+            double sink = 0;
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            for (int op = 0; op < ops_per_thread; ++op) {
+                uint64_t r = rng();
+                std::size_t index = (r >> 16) % container.size();
+                if (static_cast<int>(r % 1000) < write_per_mille) {
+                    double price = double(r & 0xffff);
+                    if ((r >> 10) % 64 == 0) {
+                        container.add({r, price, price + 1});   // growth during reads
+                    } else {
+                        container.set(index, {r, price, price + 1});
+                    }
+                } else {
+                    Quote q = container.get(index);
+                    local_torn += q.ask != q.bid + 1;
+                    sink += q.bid;
+                }
+            }
+            torn.fetch_add(local_torn + (sink < 0), std::memory_order_relaxed);
+        });
+    }
+    auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& w : workers) w.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return {double(threads) * ops_per_thread / seconds / 1e6, torn.load(), container.size()};
+}
+
+// Readers keep a reference to an element while a writer appends enough to
+// allocate many new chunks; with a std::vector the reference would dangle
+void check_stable_references() {
+    Container<std::string, EpochRcu> names;
+    names.add("first element");
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        for (int i = 0; i < 200'000; ++i) names.add("name " + std::to_string(i));
+        done.store(true);
+    });
+    std::size_t checks = 0;
+    while (!done.load()) {
+        std::size_t n = names.size();
+        names.visit(n - 1, [&](const std::string& s) { checks += !s.empty(); });
+        checks += names.visit(0, [](const std::string& s) { return s == "first element"; });
+    }
+    writer.join();
+    std::cout << "appends during reads: " << names.size() << " elements, " << checks
+              << " concurrent reads, element 0 intact: " << (names.at(0) == "first element" ? "yes" : "no")
+              << "\n";
+}
+
+template<typename Policy>
+void report(const char* name, int threads, int write_per_mille, int ops) {
+    MixResult r = run_mix<Policy>(threads, write_per_mille, ops);
+    std::cout << "  " << std::left << std::setw(18) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(9) << r.mops << " Mops/s   torn reads: " << r.torn << "\n";
+    if (r.torn != 0) {
+        std::cerr << name << " returned torn values\n";
+        std::exit(1);
+    }
+}
+
+int main(int argc, char** argv) {
+    int threads = argc > 1 ? std::atoi(argv[1]) : 4;
+    const int ops = 500'000;
+    std::cout << threads << " threads, " << ops << " ops each, 100000 Quote elements (24 bytes)\n"
+              << "hardware threads: " << std::thread::hardware_concurrency() << "\n";
+
+    for (int writes : {0, 10, 100, 500}) {
+        std::cout << "\nwrites " << writes / 10.0 << "% (1 in 64 writes appends)\n";
+        report<MutexLock>("MutexLock", threads, writes, ops);
+        report<SharedMutexLock>("SharedMutexLock", threads, writes, ops);
+        report<SeqLock>("SeqLock", threads, writes, ops);
+        report<EpochRcu>("EpochRcu", threads, writes, ops);
+    }
+
+    std::cout << "\n";
+    check_stable_references();
+    std::cout << "retired values awaiting reclamation: " << EpochDomain::instance().pending() << "\n";
+    return 0;
+}
@@ -0,0 +1,854 @@
+// COVERAGE-GUIDED MULTI-PROCESS FUZZER
+//
+// What CustomFuzzer in Refreshers/25_testing.cpp sketches, working:
+//   - coverage: the targets are compiled with -fsanitize-coverage and the
+//     callbacks below count edge hits in a 64 KiB map. clang's
+//     trace-pc-guard gives every edge its own counter; GCC only implements
+//     trace-pc, so there an edge is hashed from the previous and current
+//     block address the way AFL does. trace-cmp operands (both compilers)
+//     go into a table indexed by call site, and one mutation writes the
+//     value a comparison was looking for into the input
+//   - features are (edge, hit-count bucket) pairs; an input that produces a
+//     feature not seen before joins the corpus. Entries are distinct inputs
+//     (by hash)
+//   - energy: an entry is picked with weight sum(1 / executions that hit
+//     the feature) over its features, damped by how often it was picked
+//     already, so inputs that reach rare edges get the most mutations
+//   - mutation happens in place in one max_len scratch buffer; the loop
+//     allocates only when it keeps a new corpus entry
+//   - the supervisor initializes once and forks N workers (fork server).
+//     Workers fuzz in-process and share the corpus directory: each writes
+//     its finds there and loads the others' once a second. The input being
+//     run lives in memory shared with the supervisor, so when a worker dies
+//     (signal, abort, sanitizer exit) or hangs past the timeout the
+//     supervisor saves that input to the crash directory and forks a
+//     replacement
+//
+// Build (from Examples/Performance):
+//   g++ -std=c++17 -O2 -c -fsanitize-coverage=trace-pc,trace-cmp fuzz_targets.cpp
+//   g++ -std=c++17 -O2 coverage_fuzzer.cpp fuzz_targets.o -o coverage_fuzzer
+// With clang use -fsanitize-coverage=trace-pc-guard,trace-cmp for the
+// targets. Adding -fsanitize=address to both also catches memory errors.
+// This file must not be instrumented itself.
+//
+// Usage:
+//   coverage_fuzzer          demo: the planted bug with and without
+//                            coverage feedback, then a few seconds per parser
+//   coverage_fuzzer --target NAME [--workers N] [--time S] [--runs N]
+//       [--corpus DIR] [--crashes DIR] [--max-len N] [--timeout-ms N]
+//       [--seed N] [--blind] [--stop-on-crash]
+//   coverage_fuzzer --list
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "fuzz_target.h"
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+inline uint64_t mix64(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+uint64_t hash_bytes(const uint8_t* p, std::size_t n) {
+    uint64_t h = 0xcbf29ce484222325ULL;  // FNV-1a, then mixed
+    for (std::size_t i = 0; i < n; ++i) h = (h ^ p[i]) * 0x100000001b3ULL;
+    return mix64(h ^ n);
+}
+
+// ============================================================================
+// COVERAGE CALLBACKS
+// ============================================================================
+
+namespace cov {
+
+constexpr std::size_t kMapSize = std::size_t{1} << 16;
+alignas(64) uint8_t counters[kMapSize];
+uintptr_t prev_block = 0;
+uint32_t guards = 0;     // edges registered by trace-pc-guard
+bool trace_pc = false;   // trace-pc callbacks seen
+
+struct Cmp {
+    uint64_t a = 0, b = 0;
+    uint8_t size = 0;
+};
+constexpr std::size_t kCmpSlots = 512;
+Cmp cmp_table[kCmpSlots];
+
+inline void hit(std::size_t index) {
+    uint8_t& c = counters[index];
+    if (++c == 0) c = 255;  // saturate; a wrap would read as "not hit"
+}
+
+inline void log_cmp(uintptr_t site, uint64_t a, uint64_t b, uint8_t size) {
+    if (a != b) cmp_table[mix64(site) % kCmpSlots] = {a, b, size};
+}
+
+} // namespace cov
+
+#define FUZZ_CALLER reinterpret_cast<uintptr_t>(__builtin_return_address(0))
+
+extern "C" {
+
+void __sanitizer_cov_trace_pc_guard_init(uint32_t* start, uint32_t* stop) {
+    if (start == stop || *start) return;
+    for (uint32_t* g = start; g < stop; ++g) *g = ++cov::guards;  // 0 would mean "disabled"
+}
+
+void __sanitizer_cov_trace_pc_guard(uint32_t* guard) {
+    if (*guard) cov::hit(*guard % cov::kMapSize);
+}
+
+void __sanitizer_cov_trace_pc() {
+    uintptr_t block = static_cast<uintptr_t>(mix64(FUZZ_CALLER));
+    cov::hit((block ^ cov::prev_block) % cov::kMapSize);
+    cov::prev_block = block >> 1;  // so A->B and B->A differ
+    cov::trace_pc = true;
+}
+
+void __sanitizer_cov_trace_cmp1(uint8_t a, uint8_t b) { cov::log_cmp(FUZZ_CALLER, a, b, 1); }
+void __sanitizer_cov_trace_cmp2(uint16_t a, uint16_t b) { cov::log_cmp(FUZZ_CALLER, a, b, 2); }
+void __sanitizer_cov_trace_cmp4(uint32_t a, uint32_t b) { cov::log_cmp(FUZZ_CALLER, a, b, 4); }
+void __sanitizer_cov_trace_cmp8(uint64_t a, uint64_t b) { cov::log_cmp(FUZZ_CALLER, a, b, 8); }
+void __sanitizer_cov_trace_const_cmp1(uint8_t a, uint8_t b) { cov::log_cmp(FUZZ_CALLER, b, a, 1); }
+void __sanitizer_cov_trace_const_cmp2(uint16_t a, uint16_t b) { cov::log_cmp(FUZZ_CALLER, b, a, 2); }
+void __sanitizer_cov_trace_const_cmp4(uint32_t a, uint32_t b) { cov::log_cmp(FUZZ_CALLER, b, a, 4); }
+void __sanitizer_cov_trace_const_cmp8(uint64_t a, uint64_t b) { cov::log_cmp(FUZZ_CALLER, b, a, 8); }
+void __sanitizer_cov_trace_cmpf(float, float) {}
+void __sanitizer_cov_trace_cmpd(double, double) {}
+
+// cases[0] = number of cases, cases[1] = operand bits, then the case values
+void __sanitizer_cov_trace_switch(uint64_t value, uint64_t* cases) {
+    uint8_t size = static_cast<uint8_t>(cases[1] / 8);
+    for (uint64_t i = 0; i < cases[0]; ++i) cov::log_cmp(FUZZ_CALLER + i, value, cases[2 + i], size);
+}
+
+} // extern "C"
+
+// ============================================================================
+// FEATURES
+// ============================================================================
+
+// AFL's hit-count buckets: 1, 2, 3, 4-7, 8-15, 16-31, 32-127, 128+
+class Features {
+public:
+    Features() : seen_(cov::kMapSize, 0), hits_(cov::kMapSize * 8, 0) {
+        for (int c = 1; c < 256; ++c)
+            bucket_[c] = c == 1 ? 0 : c == 2 ? 1 : c == 3 ? 2 : c < 8 ? 3 : c < 16 ? 4 : c < 32 ? 5 : c < 128 ? 6 : 7;
+        current_.reserve(4096);
+    }
+
+    void begin() { cov::prev_block = 0; }
+
+    // Reads and clears the map; returns how many features were never kept
+    // before. Zero words are skipped, so the scan costs ~8K loads
+    std::size_t collect() {
+        current_.clear();
+        std::size_t fresh = 0;
+        for (std::size_t w = 0; w < cov::kMapSize; w += 8) {
+            uint64_t word;
+            std::memcpy(&word, cov::counters + w, 8);
+            if (!word) continue;
+            std::memset(cov::counters + w, 0, 8);
+            for (std::size_t b = 0; b < 8; ++b, word >>= 8) {
+                uint8_t count = static_cast<uint8_t>(word);
+                if (!count) continue;
+                std::size_t index = w + b;
+                uint32_t bucket = bucket_[count];
+                uint32_t feature = static_cast<uint32_t>(index * 8 + bucket);
+                current_.push_back(feature);
+                ++hits_[feature];
+                if (!(seen_[index] & (1u << bucket))) ++fresh;
+            }
+        }
+        return fresh;
+    }
+
+    // Marks the last execution's features as seen (its input was kept)
+    void keep() {
+        for (uint32_t f : current_) {
+            uint8_t bit = static_cast<uint8_t>(1u << (f & 7));
+            if (!(seen_[f >> 3] & bit)) ++total_;
+            seen_[f >> 3] |= bit;
+        }
+    }
+
+    const std::vector<uint32_t>& current() const { return current_; }
+    uint32_t hits(uint32_t feature) const { return hits_[feature]; }
+    std::size_t total() const { return total_; }
+
+    static bool instrumented() { return cov::guards > 0 || cov::trace_pc; }
+
+private:
+    uint8_t bucket_[256] = {};
+    std::vector<uint8_t> seen_;    // per map index, one bit per bucket
+    std::vector<uint32_t> hits_;   // executions that produced each feature
+    std::vector<uint32_t> current_;
+    std::size_t total_ = 0;
+};
+
+// ============================================================================
+// CORPUS
+// ============================================================================
+
+struct Rng {
+    uint64_t state;
+
+    uint64_t next() {  // splitmix64
+        uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform in [0, n); n > 0
+    std::size_t below(std::size_t n) { return static_cast<std::size_t>((next() >> 32) * n >> 32); }
+    double unit() { return static_cast<double>(next() >> 11) * 0x1.0p-53; }
+};
+
+class Corpus {
+public:
+    struct Entry {
+        std::vector<uint8_t> data;
+        std::vector<uint32_t> features;
+        uint64_t picks = 0;
+    };
+
+    bool contains(uint64_t hash) const { return hashes_.count(hash) != 0; }
+
+    void add(const uint8_t* data, std::size_t size, uint64_t hash, const std::vector<uint32_t>& features) {
+        hashes_.insert(hash);
+        entries_.push_back({std::vector<uint8_t>(data, data + size), features, 0});
+        dirty_ = true;
+    }
+
+    std::size_t size() const { return entries_.size(); }
+    const Entry& operator[](std::size_t i) const { return entries_[i]; }
+
+    // Rare features attract picks; weights are refreshed every 4096 picks
+    std::size_t pick(Rng& rng, const Features& features) {
+        if (dirty_ || ++picks_since_reweigh_ >= 4096) reweigh(features);
+        double r = rng.unit() * cumulative_.back();
+        std::size_t i = static_cast<std::size_t>(std::upper_bound(cumulative_.begin(), cumulative_.end(), r) -
+                                                 cumulative_.begin());
+        i = std::min(i, entries_.size() - 1);
+        ++entries_[i].picks;
+        return i;
+    }
+
+private:
+    void reweigh(const Features& features) {
+        cumulative_.resize(entries_.size());
+        double total = 0;
+        for (std::size_t i = 0; i < entries_.size(); ++i) {
+            double rarity = 0;
+            for (uint32_t f : entries_[i].features) rarity += 1.0 / (1.0 + features.hits(f));
+            double size_penalty = 1.0 + static_cast<double>(entries_[i].data.size()) / 1024.0;
+            total += (1e-9 + rarity) / std::sqrt(1.0 + static_cast<double>(entries_[i].picks)) / size_penalty;
+            cumulative_[i] = total;
+        }
+        dirty_ = false;
+        picks_since_reweigh_ = 0;
+    }
+
+    std::vector<Entry> entries_;
+    std::unordered_set<uint64_t> hashes_;
+    std::vector<double> cumulative_;
+    bool dirty_ = true;
+    std::size_t picks_since_reweigh_ = 0;
+};
+
+// ============================================================================
+// MUTATOR
+// ============================================================================
+
+// Every operation edits data[0, size) in place within capacity max_len
+class Mutator {
+public:
+    Mutator(std::size_t max_len, std::vector<std::string> dictionary)
+        : max_len_(max_len), dictionary_(std::move(dictionary)) {}
+
+    std::size_t mutate(uint8_t* data, std::size_t size, const Corpus& corpus, Rng& rng) {
+        std::size_t stack = std::size_t{1} << rng.below(4);  // 1, 2, 4 or 8 edits
+        for (std::size_t i = 0; i < stack; ++i) size = mutate_once(data, size, corpus, rng);
+        return size;
+    }
+
+private:
+    std::size_t mutate_once(uint8_t* d, std::size_t size, const Corpus& corpus, Rng& rng) {
+        switch (rng.below(10)) {
+        case 0:
+            if (!size) break;
+            d[rng.below(size)] ^= static_cast<uint8_t>(1u << rng.below(8));
+            return size;
+        case 1:
+            if (!size) break;
+            d[rng.below(size)] = static_cast<uint8_t>(rng.next());
+            return size;
+        case 2: {
+            static const int64_t interesting[] = {0, 1, -1, 16, 32, 64, 100, 127, -128, 255, 256, 512, 1000, 1024,
+                                                  4096, 32767, -32768, 65535, 65536, 0x7fffffff, -0x7fffffff - 1};
+            std::size_t width = std::size_t{1} << rng.below(3);
+            if (size < width) break;
+            int64_t v = interesting[rng.below(sizeof interesting / sizeof interesting[0])];
+            std::memcpy(d + rng.below(size - width + 1), &v, width);  // little endian
+            return size;
+        }
+        case 3:
+            if (!size) break;
+            d[rng.below(size)] += static_cast<uint8_t>(static_cast<int>(rng.below(33)) - 16);
+            return size;
+        case 4:
+            if (size < 2) break;
+            return erase(d, size, 1 + rng.below(std::min<std::size_t>(size - 1, 16)), rng);
+        case 5: {
+            if (size < 2) break;
+            std::size_t len = 1 + rng.below(std::min<std::size_t>(size - 1, 32));
+            std::size_t from = rng.below(size - len + 1);
+            std::memmove(d + rng.below(size - len + 1), d + from, len);
+            return size;
+        }
+        case 6: {  // splice in part of another entry
+            const auto& other = corpus[rng.below(corpus.size())].data;
+            if (other.empty()) break;
+            std::size_t len = 1 + rng.below(std::min<std::size_t>(other.size(), 64));
+            return place(d, size, other.data() + rng.below(other.size() - len + 1), len, rng);
+        }
+        case 7: {
+            if (dictionary_.empty()) break;
+            const std::string& token = dictionary_[rng.below(dictionary_.size())];
+            return place(d, size, reinterpret_cast<const uint8_t*>(token.data()), token.size(), rng);
+        }
+        case 8:
+            if (std::size_t n = cmp_replace(d, size, rng)) return n;
+            break;
+        default:
+            break;
+        }
+        uint8_t byte = static_cast<uint8_t>(rng.next());
+        return insert(d, size, &byte, 1, rng.below(size + 1));
+    }
+
+    // Where an operand of a logged comparison occurs, write the other one
+    std::size_t cmp_replace(uint8_t* d, std::size_t size, Rng& rng) {
+        for (int attempt = 0; attempt < 4; ++attempt) {
+            const cov::Cmp& c = cov::cmp_table[rng.below(cov::kCmpSlots)];
+            if (!c.size || c.size > size) continue;
+            for (std::size_t i = 0; i + c.size <= size; ++i) {
+                if (std::memcmp(d + i, &c.a, c.size) == 0) {
+                    std::memcpy(d + i, &c.b, c.size);
+                    return size;
+                }
+            }
+            std::memcpy(d + rng.below(size - c.size + 1), &c.b, c.size);
+            return size;
+        }
+        return 0;
+    }
+
+    std::size_t place(uint8_t* d, std::size_t size, const uint8_t* bytes, std::size_t len, Rng& rng) {
+        if (len <= size && rng.below(2)) {
+            std::memcpy(d + rng.below(size - len + 1), bytes, len);
+            return size;
+        }
+        return insert(d, size, bytes, len, rng.below(size + 1));
+    }
+
+    std::size_t insert(uint8_t* d, std::size_t size, const uint8_t* bytes, std::size_t len, std::size_t pos) {
+        if (size + len > max_len_) return size;
+        std::memmove(d + pos + len, d + pos, size - pos);
+        std::memcpy(d + pos, bytes, len);
+        return size + len;
+    }
+
+    std::size_t erase(uint8_t* d, std::size_t size, std::size_t len, Rng& rng) {
+        std::size_t pos = rng.below(size - len + 1);
+        std::memmove(d + pos, d + pos + len, size - pos - len);
+        return size - len;
+    }
+
+    std::size_t max_len_;
+    std::vector<std::string> dictionary_;
+};
+
+// ============================================================================
+// WORKER
+// ============================================================================
+
+struct Config {
+    const FuzzTarget* target = nullptr;
+    std::size_t workers = 1;
+    double seconds = 10;
+    uint64_t runs = 0;  // total across workers; 0 = no limit
+    std::size_t max_len = 4096;
+    int timeout_ms = 1000;
+    uint64_t seed = 1;
+    bool blind = false;  // no coverage feedback: mutate the seeds only
+    bool stop_on_crash = false;
+    bool quiet = false;
+    fs::path corpus_dir;
+    fs::path crash_dir;
+};
+
+// Lives in MAP_SHARED memory; the worker's input buffer follows it
+struct Slot {
+    std::atomic<uint64_t> execs{0};
+    std::atomic<uint64_t> corpus{0};
+    std::atomic<uint64_t> features{0};
+    std::atomic<uint32_t> running{0};  // 1 while the target runs
+    std::atomic<uint32_t> size{0};     // bytes of the input being run
+};
+
+struct SharedHeader {
+    std::atomic<bool> stop{false};
+};
+
+class SharedMemory {
+public:
+    SharedMemory(std::size_t slots, std::size_t max_len)
+        : stride_((sizeof(Slot) + max_len + 63) & ~std::size_t{63}), bytes_(64 + slots * stride_) {
+        void* p = ::mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) throw std::runtime_error("mmap failed");
+        base_ = static_cast<uint8_t*>(p);
+        new (base_) SharedHeader;
+        for (std::size_t i = 0; i < slots; ++i) new (base_ + 64 + i * stride_) Slot;
+    }
+    ~SharedMemory() { ::munmap(base_, bytes_); }
+
+    SharedMemory(const SharedMemory&) = delete;
+    SharedMemory& operator=(const SharedMemory&) = delete;
+
+    SharedHeader& header() { return *reinterpret_cast<SharedHeader*>(base_); }
+    Slot& slot(std::size_t i) { return *reinterpret_cast<Slot*>(base_ + 64 + i * stride_); }
+    uint8_t* input(std::size_t i) { return base_ + 64 + i * stride_ + sizeof(Slot); }
+
+private:
+    std::size_t stride_;
+    std::size_t bytes_;
+    uint8_t* base_ = nullptr;
+};
+
+class Worker {
+public:
+    Worker(const Config& config, SharedHeader& header, Slot& slot, uint8_t* input, uint64_t seed)
+        : config_(config), header_(header), slot_(slot), input_(input), rng_{seed},
+          mutator_(config.max_len, config.target->dictionary) {}
+
+    void run() {
+        sync();
+        if (corpus_.size() == 0 || config_.blind) {
+            for (const std::string& seed : config_.target->seeds) consider(to_input(seed.data(), seed.size()), true);
+            if (corpus_.size() == 0) consider(0, true);
+        }
+        auto next_sync = Clock::now() + std::chrono::seconds(1);
+        for (uint64_t i = 1; !header_.stop.load(std::memory_order_relaxed); ++i) {
+            const auto& parent = corpus_[corpus_.pick(rng_, features_)].data;
+            std::memcpy(input_, parent.data(), parent.size());
+            std::size_t size = mutator_.mutate(input_, parent.size(), corpus_, rng_);
+            if (!config_.blind) consider(size, false);
+            else execute(size);
+            if ((i & 1023) == 0 && Clock::now() >= next_sync) {
+                sync();
+                next_sync = Clock::now() + std::chrono::seconds(1);
+            }
+        }
+    }
+
+private:
+    std::size_t to_input(const void* data, std::size_t size) {
+        size = std::min(size, config_.max_len);
+        std::memcpy(input_, data, size);
+        return size;
+    }
+
+    // Runs input_[0, size) and returns the number of new features
+    std::size_t execute(std::size_t size) {
+        slot_.size.store(static_cast<uint32_t>(size), std::memory_order_relaxed);
+        slot_.running.store(1, std::memory_order_release);
+        features_.begin();
+        config_.target->run(input_, size);
+        slot_.running.store(0, std::memory_order_release);
+        slot_.execs.fetch_add(1, std::memory_order_relaxed);
+        return features_.collect();
+    }
+
+    // Keeps the input if it adds coverage (or if forced); returns whether
+    // it was new to this worker
+    bool consider(std::size_t size, bool force, bool save = true) {
+        std::size_t fresh = execute(size);
+        if (!fresh && !force) return false;
+        uint64_t hash = hash_bytes(input_, size);
+        if (corpus_.contains(hash)) return false;
+        features_.keep();
+        corpus_.add(input_, size, hash, features_.current());
+        slot_.corpus.store(corpus_.size(), std::memory_order_relaxed);
+        slot_.features.store(features_.total(), std::memory_order_relaxed);
+        if (save && !config_.blind) write_entry(hash, size);
+        return true;
+    }
+
+    static std::string name_of(uint64_t hash) {
+        char name[17];
+        std::snprintf(name, sizeof name, "%016llx", static_cast<unsigned long long>(hash));
+        return name;
+    }
+
+    void write_entry(uint64_t hash, std::size_t size) {
+        std::string name = name_of(hash);
+        known_.insert(name);
+        fs::path final_path = config_.corpus_dir / name;
+        fs::path tmp = config_.corpus_dir / (".tmp-" + std::to_string(::getpid()));
+        {
+            std::ofstream out(tmp, std::ios::binary);
+            out.write(reinterpret_cast<const char*>(input_), static_cast<std::streamsize>(size));
+            if (!out) return;
+        }
+        std::error_code ec;
+        fs::rename(tmp, final_path, ec);  // atomic: readers never see half a file
+    }
+
+    // Runs files other workers (or earlier runs) added to the directory
+    void sync() {
+        if (config_.blind) return;
+        std::error_code ec;
+        for (fs::directory_iterator it(config_.corpus_dir, ec), end; !ec && it != end; it.increment(ec)) {
+            std::string name = it->path().filename().string();
+            if (name.empty() || name[0] == '.' || !known_.insert(name).second) continue;
+            std::ifstream in(it->path(), std::ios::binary);
+            in.read(reinterpret_cast<char*>(input_), static_cast<std::streamsize>(config_.max_len));
+            consider(static_cast<std::size_t>(in.gcount()), false, false);
+        }
+    }
+
+    const Config& config_;
+    SharedHeader& header_;
+    Slot& slot_;
+    uint8_t* input_;  // shared with the supervisor: the crash reproducer
+    Rng rng_;
+    Features features_;
+    Corpus corpus_;
+    Mutator mutator_;
+    std::unordered_set<std::string> known_;
+};
+
+// ============================================================================
+// SUPERVISOR
+// ============================================================================
+
+struct Report {
+    uint64_t execs = 0;
+    double seconds = 0;
+    std::size_t corpus = 0;
+    std::size_t features = 0;
+    std::size_t crashes = 0;
+    std::size_t timeouts = 0;
+    double first_crash_seconds = -1;
+    std::vector<std::string> crash_files;
+};
+
+class Supervisor {
+public:
+    explicit Supervisor(Config config) : config_(std::move(config)), shared_(config_.workers, config_.max_len) {}
+
+    Report run() {
+        fs::create_directories(config_.corpus_dir);
+        fs::create_directories(config_.crash_dir);
+        dry_run();
+
+        workers_.resize(config_.workers);
+        auto start = Clock::now();
+        for (std::size_t i = 0; i < config_.workers; ++i) spawn(i);
+
+        auto next_report = start + std::chrono::seconds(1);
+        bool stopping = false;
+        Clock::time_point stop_at{};
+        for (;;) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            auto now = Clock::now();
+            reap(now, start, stopping);
+            if (!stopping) check_hangs(now);
+
+            uint64_t execs = total_execs();
+            double elapsed = std::chrono::duration<double>(now - start).count();
+            bool done = elapsed >= config_.seconds || (config_.runs && execs >= config_.runs) ||
+                        (config_.stop_on_crash && report_.crashes + report_.timeouts > 0);
+            if (done && !stopping) {
+                stopping = true;
+                stop_at = now;
+                shared_.header().stop.store(true);
+            }
+            if (stopping) {
+                if (std::none_of(workers_.begin(), workers_.end(), [](const Proc& p) { return p.pid > 0; })) break;
+                if (now - stop_at > std::chrono::seconds(2))
+                    for (Proc& p : workers_)
+                        if (p.pid > 0) ::kill(p.pid, SIGKILL);
+            }
+            if (!config_.quiet && now >= next_report) {
+                progress(elapsed, execs);
+                next_report += std::chrono::seconds(1);
+            }
+        }
+        report_.execs = total_execs();
+        report_.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        for (std::size_t i = 0; i < config_.workers; ++i) {
+            report_.corpus = std::max<std::size_t>(report_.corpus, shared_.slot(i).corpus.load());
+            report_.features = std::max<std::size_t>(report_.features, shared_.slot(i).features.load());
+        }
+        return report_;
+    }
+
+private:
+    struct Proc {
+        pid_t pid = -1;
+        uint64_t restarts = 0;
+        uint64_t last_execs = 0;
+        Clock::time_point last_progress{};
+        bool killed_for_hang = false;
+    };
+
+    // Seeds must not crash, and the target should be instrumented
+    void dry_run() {
+        for (const std::string& seed : config_.target->seeds)
+            config_.target->run(reinterpret_cast<const uint8_t*>(seed.data()), seed.size());
+        if (!Features::instrumented() && !config_.quiet)
+            std::cout << "warning: no coverage callbacks fired; build the targets with -fsanitize-coverage\n";
+        std::memset(cov::counters, 0, sizeof cov::counters);
+    }
+
+    void spawn(std::size_t i) {
+        Proc& p = workers_[i];
+        Slot& slot = shared_.slot(i);
+        slot.running.store(0);
+        std::cout.flush();
+        pid_t pid = ::fork();
+        if (pid < 0) throw std::runtime_error("fork failed");
+        if (pid == 0) {
+            uint64_t seed = mix64(config_.seed * 1000003 + i * 7919 + p.restarts);
+            Worker(config_, shared_.header(), slot, shared_.input(i), seed).run();
+            std::fflush(nullptr);
+            ::_exit(0);
+        }
+        p.pid = pid;
+        p.last_execs = slot.execs.load();
+        p.last_progress = Clock::now();
+        p.killed_for_hang = false;
+    }
+
+    void reap(Clock::time_point now, Clock::time_point start, bool stopping) {
+        for (std::size_t i = 0; i < workers_.size(); ++i) {
+            Proc& p = workers_[i];
+            if (p.pid <= 0) continue;
+            int status = 0;
+            if (::waitpid(p.pid, &status, WNOHANG) != p.pid) continue;
+            p.pid = -1;
+            bool clean = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+            if (clean && stopping) continue;
+            if (!clean || !stopping) {
+                std::string why = p.killed_for_hang         ? "timeout"
+                                  : WIFSIGNALED(status)    ? strsignal(WTERMSIG(status))
+                                                           : "exit " + std::to_string(WEXITSTATUS(status));
+                record(i, p.killed_for_hang, why, std::chrono::duration<double>(now - start).count());
+            }
+            if (!stopping) {
+                ++p.restarts;
+                spawn(i);
+            }
+        }
+    }
+
+    void check_hangs(Clock::time_point now) {
+        for (std::size_t i = 0; i < workers_.size(); ++i) {
+            Proc& p = workers_[i];
+            if (p.pid <= 0) continue;
+            uint64_t execs = shared_.slot(i).execs.load(std::memory_order_relaxed);
+            if (execs != p.last_execs || !shared_.slot(i).running.load(std::memory_order_acquire)) {
+                p.last_execs = execs;
+                p.last_progress = now;
+            } else if (!p.killed_for_hang && now - p.last_progress > std::chrono::milliseconds(config_.timeout_ms)) {
+                p.killed_for_hang = true;
+                ::kill(p.pid, SIGKILL);
+            }
+        }
+    }
+
+    void record(std::size_t i, bool timeout, const std::string& why, double at) {
+        std::size_t size = std::min<std::size_t>(shared_.slot(i).size.load(), config_.max_len);
+        const uint8_t* input = shared_.input(i);
+        uint64_t hash = hash_bytes(input, size);
+        (timeout ? report_.timeouts : report_.crashes)++;
+        if (report_.first_crash_seconds < 0) report_.first_crash_seconds = at;
+        if (!crash_hashes_.insert(hash).second) return;
+
+        char name[40];
+        std::snprintf(name, sizeof name, "%s-%016llx", timeout ? "timeout" : "crash",
+                      static_cast<unsigned long long>(hash));
+        fs::path path = config_.crash_dir / name;
+        std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(input), static_cast<std::streamsize>(size));
+        report_.crash_files.push_back(path.string());
+        if (!config_.quiet) {
+            std::cout << "  worker " << i << ": " << why << " on a " << size << "-byte input -> " << path.string()
+                      << "\n";
+        }
+    }
+
+    uint64_t total_execs() {
+        uint64_t total = 0;
+        for (std::size_t i = 0; i < config_.workers; ++i) total += shared_.slot(i).execs.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    void progress(double elapsed, uint64_t execs) {
+        std::size_t corpus = 0, features = 0;
+        for (std::size_t i = 0; i < config_.workers; ++i) {
+            corpus = std::max<std::size_t>(corpus, shared_.slot(i).corpus.load());
+            features = std::max<std::size_t>(features, shared_.slot(i).features.load());
+        }
+        std::cout << "  [" << std::setw(3) << static_cast<int>(elapsed + 0.5) << "s] " << std::setw(10) << execs
+                  << " execs " << std::setw(8) << static_cast<uint64_t>(execs / elapsed) << "/s  corpus "
+                  << std::setw(5) << corpus << "  features " << std::setw(5) << features << "  crashes "
+                  << report_.crashes << "  timeouts " << report_.timeouts << "\n";
+    }
+
+    Config config_;
+    SharedMemory shared_;
+    std::vector<Proc> workers_;
+    std::unordered_set<uint64_t> crash_hashes_;
+    Report report_;
+};
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+const FuzzTarget* find_target(const std::string& name) {
+    for (const FuzzTarget& t : fuzz_targets())
+        if (name == t.name) return &t;
+    return nullptr;
+}
+
+void summary(const char* label, const Report& r) {
+    std::cout << "  " << std::left << std::setw(26) << label << std::right << std::setw(10) << r.execs << " execs "
+              << std::setw(8) << static_cast<uint64_t>(r.execs / r.seconds) << "/s  corpus " << std::setw(4)
+              << r.corpus << "  features " << std::setw(4) << r.features << "  crashes " << r.crashes
+              << "  timeouts " << r.timeouts;
+    if (r.first_crash_seconds >= 0) std::cout << "  first after " << std::fixed << std::setprecision(2)
+                                              << r.first_crash_seconds << " s" << std::defaultfloat;
+    std::cout << "\n";
+}
+
+int demo() {
+    char tmpl[] = "/tmp/coverage_fuzzer.XXXXXX";
+    if (!::mkdtemp(tmpl)) {
+        std::perror("mkdtemp");
+        return 1;
+    }
+    fs::path root = tmpl;
+    std::size_t workers = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "coverage: " << (cov::guards ? "trace-pc-guard (" + std::to_string(cov::guards) + " edges)" : "trace-pc")
+              << ", " << workers << " worker(s), output in " << root.string() << "\n\n";
+
+    std::cout << "planted bug (4 nested byte checks), stop at the first crash, 20 s limit\n";
+    for (bool blind : {false, true}) {
+        Config c;
+        c.target = find_target("magic");
+        c.workers = workers;
+        c.seconds = 20;
+        c.blind = blind;
+        c.stop_on_crash = true;
+        c.quiet = true;
+        c.corpus_dir = root / (blind ? "magic_blind" : "magic") / "corpus";
+        c.crash_dir = root / (blind ? "magic_blind" : "magic") / "crashes";
+        summary(blind ? "blind mutation" : "coverage-guided", Supervisor(c).run());
+    }
+
+    std::cout << "\nparsers, 5 s each (findings are property violations or crashes)\n";
+    for (const char* name : {"binf", "int_line", "frame"}) {
+        Config c;
+        c.target = find_target(name);
+        c.workers = workers;
+        c.seconds = 5;
+        c.quiet = true;
+        c.corpus_dir = root / name / "corpus";
+        c.crash_dir = root / name / "crashes";
+        Report r = Supervisor(c).run();
+        summary(name, r);
+        for (const std::string& f : r.crash_files) std::cout << "    " << f << "\n";
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc == 1) return demo();
+
+    Config config;
+    std::string target = "magic";
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                std::cerr << arg << " needs a value\n";
+                std::exit(1);
+            }
+            return argv[++i];
+        };
+        if (arg == "--list") {
+            for (const FuzzTarget& t : fuzz_targets()) std::cout << std::left << std::setw(10) << t.name << t.description << "\n";
+            return 0;
+        }
+        if (arg == "--target") target = value();
+        else if (arg == "--workers") config.workers = std::max(1, std::stoi(value()));
+        else if (arg == "--time") config.seconds = std::stod(value());
+        else if (arg == "--runs") config.runs = std::stoull(value());
+        else if (arg == "--corpus") config.corpus_dir = value();
+        else if (arg == "--crashes") config.crash_dir = value();
+        else if (arg == "--max-len") config.max_len = std::max(1, std::stoi(value()));
+        else if (arg == "--timeout-ms") config.timeout_ms = std::stoi(value());
+        else if (arg == "--seed") config.seed = std::stoull(value());
+        else if (arg == "--blind") config.blind = true;
+        else if (arg == "--stop-on-crash") config.stop_on_crash = true;
+        else {
+            std::cerr << "unknown option " << arg << "\n";
+            return 1;
+        }
+    }
+    config.target = find_target(target);
+    if (!config.target) {
+        std::cerr << "no target " << target << " (--list)\n";
+        return 1;
+    }
+    if (config.corpus_dir.empty()) config.corpus_dir = "corpus_" + target;
+    if (config.crash_dir.empty()) config.crash_dir = "crashes_" + target;
+
+    std::cout << "fuzzing " << target << " with " << config.workers << " worker(s); corpus " << config.corpus_dir.string()
+              << ", crashes " << config.crash_dir.string() << "\n";
+    Report r = Supervisor(config).run();
+    summary(target.c_str(), r);
+    return r.crashes + r.timeouts > 0 ? 1 : 0;
+}
@@ -0,0 +1,700 @@
+// SCHEMA-COMPILED FIXED-LAYOUT SERIALIZATION VS PROTOBUF
+//
+// For intra-host traffic the protobuf path in Examples/protobuf.cpp pays for
+// varint encoding, per-message objects and a copy into std::vector on every
+// call. This is a fixed-layout binary format for the same messages:
+//   - schema: a plain struct of views (string_view, int32_t, bool) plus a
+//     fields() list of (proto field number, name, member). Everything else
+//     (slot offsets, record size, encoder, reader) is derived at compile time
+//     from that list.
+//   - the structs mirror user.proto / todo.proto: `--generate` prints them
+//     from the compiled-in protobuf descriptors, and at startup every schema
+//     is checked against its descriptor (numbers, names, types), so the two
+//     cannot drift apart
+//   - batch layout: [count u32][record_size u32][records][string heap].
+//     Scalars sit at fixed offsets in each record, strings are (offset, length)
+//     into the heap. Element i is one multiply away, and reading a field is a
+//     load: BatchView hands out string_views into the buffer (zero copy).
+//   - encode_batch sizes the output in one pass and writes it in a second,
+//     into one allocation from any pmr resource (an arena here); Builder
+//     appends messages one at a time into arena-backed vectors
+// Little endian, as in wire_protocol.cpp.
+//
+// Build (from Examples/Performance):
+//   protoc -I.. --cpp_out=. ../user.proto ../todo.proto
+//   g++ -std=c++17 -O2 -I. flat_serialization.cpp user.pb.cc todo.pb.cc -lprotobuf
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory_resource>
+#include <new>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <google/protobuf/arena.h>
+#include <google/protobuf/descriptor.h>
+
+#include "../memory_resources.hpp"
+#include "todo.pb.h"
+#include "user.pb.h"
+
+// ============================================================================
+// REFLECTION
+// ============================================================================
+
+namespace flat {
+
+enum class Kind { Int32, Int64, Bool, String };
+
+// Wire slot for each supported member type
+template<typename M> struct Slot;
+template<> struct Slot<int32_t> { static constexpr std::size_t size = 4; static constexpr Kind kind = Kind::Int32; };
+template<> struct Slot<int64_t> { static constexpr std::size_t size = 8; static constexpr Kind kind = Kind::Int64; };
+template<> struct Slot<bool> { static constexpr std::size_t size = 1; static constexpr Kind kind = Kind::Bool; };
+template<> struct Slot<std::string_view> {
+    static constexpr std::size_t size = 8;   // heap offset u32, length u32
+    static constexpr Kind kind = Kind::String;
+};
+
+template<uint32_t Number, typename Class, typename Member>
+struct Field {
+    static constexpr uint32_t number = Number;
+    using member_type = Member;
+    const char* name;
+    Member Class::*member;
+};
+
+template<uint32_t Number, typename Class, typename Member>
+constexpr Field<Number, Class, Member> field(const char* name, Member Class::*member) {
+    return {name, member};
+}
+
+template<typename T>
+struct Layout {
+    using Fields = decltype(T::fields());
+    static constexpr std::size_t count = std::tuple_size_v<Fields>;
+
+    template<std::size_t I>
+    using FieldAt = std::tuple_element_t<I, Fields>;
+
+    template<std::size_t I>
+    static constexpr std::size_t offset() {
+        if constexpr (I == 0) {
+            return 0;
+        } else {
+            return offset<I - 1>() + Slot<typename FieldAt<I - 1>::member_type>::size;
+        }
+    }
+
+    static constexpr std::size_t record_size = offset<count>();
+
+    // Index of the field with proto number N
+    template<uint32_t N, std::size_t I = 0>
+    static constexpr std::size_t index_of() {
+        static_assert(I < count, "no field with that number");
+        if constexpr (FieldAt<I>::number == N) {
+            return I;
+        } else {
+            return index_of<N, I + 1>();
+        }
+    }
+};
+
+template<typename T, typename F, std::size_t... I>
+void for_each_field(F&& f, std::index_sequence<I...>) {
+    constexpr auto fields = T::fields();
+    (f(std::integral_constant<std::size_t, I>{}, std::get<I>(fields)), ...);
+}
+
+template<typename T, typename F>
+void for_each_field(F&& f) {
+    for_each_field<T>(std::forward<F>(f), std::make_index_sequence<Layout<T>::count>{});
+}
+
+class FormatError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+inline uint32_t load_u32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, 4);
+    return v;
+}
+
+inline void store_u32(uint8_t* p, uint32_t v) { std::memcpy(p, &v, 4); }
+
+// ============================================================================
+// ENCODING
+// ============================================================================
+
+constexpr std::size_t kBatchHeader = 8;
+
+struct Encoded {
+    uint8_t* data;
+    std::size_t size;
+};
+
+// Writes message i's record; string bytes go to heap + *heap_used
+template<typename T>
+void write_record(const T& msg, uint8_t* record, uint8_t* heap, std::size_t* heap_used) {
+    for_each_field<T>([&](auto index, const auto& f) {
+        uint8_t* slot = record + Layout<T>::template offset<decltype(index)::value>();
+        const auto& value = msg.*(f.member);
+        using M = std::decay_t<decltype(value)>;
+        if constexpr (std::is_same_v<M, std::string_view>) {
+            store_u32(slot, static_cast<uint32_t>(*heap_used));
+            store_u32(slot + 4, static_cast<uint32_t>(value.size()));
+            if (!value.empty()) std::memcpy(heap + *heap_used, value.data(), value.size());
+            *heap_used += value.size();
+        } else {
+            std::memcpy(slot, &value, sizeof(M));
+        }
+    });
+}
+
+template<typename T>
+std::size_t string_bytes(const T& msg) {
+    std::size_t total = 0;
+    for_each_field<T>([&](auto, const auto& f) {
+        if constexpr (std::is_same_v<typename std::decay_t<decltype(f)>::member_type, std::string_view>) {
+            total += (msg.*(f.member)).size();
+        }
+    });
+    return total;
+}
+
+// One allocation from mr; the caller frees it (or releases the arena)
+template<typename T>
+Encoded encode_batch(const T* items, std::size_t n, std::pmr::memory_resource* mr) {
+    constexpr std::size_t rs = Layout<T>::record_size;
+    std::size_t heap_size = 0;
+    for (std::size_t i = 0; i < n; ++i) heap_size += string_bytes(items[i]);
+    std::size_t size = kBatchHeader + n * rs + heap_size;
+    if (size > UINT32_MAX) throw FormatError("batch larger than 4 GB");
+
+    auto* out = static_cast<uint8_t*>(mr->allocate(size, 8));
+    store_u32(out, static_cast<uint32_t>(n));
+    store_u32(out + 4, static_cast<uint32_t>(rs));
+    uint8_t* heap = out + kBatchHeader + n * rs;
+    std::size_t used = 0;
+    for (std::size_t i = 0; i < n; ++i) write_record(items[i], out + kBatchHeader + i * rs, heap, &used);
+    return {out, size};
+}
+
+// Incremental: messages arrive one at a time, count unknown up front
+template<typename T>
+class Builder {
+public:
+    explicit Builder(std::pmr::memory_resource* mr) : records_(mr), heap_(mr), mr_(mr) {}
+
+    void add(const T& msg) {
+        std::size_t used = heap_.size();
+        records_.resize(records_.size() + Layout<T>::record_size);
+        heap_.resize(used + string_bytes(msg));
+        write_record(msg, records_.data() + records_.size() - Layout<T>::record_size, heap_.data(), &used);
+        ++count_;
+    }
+
+    // Heap offsets are relative to the heap, so assembling is two copies
+    Encoded finish() const {
+        std::size_t size = kBatchHeader + records_.size() + heap_.size();
+        auto* out = static_cast<uint8_t*>(mr_->allocate(size, 8));
+        store_u32(out, static_cast<uint32_t>(count_));
+        store_u32(out + 4, static_cast<uint32_t>(Layout<T>::record_size));
+        if (!records_.empty()) std::memcpy(out + kBatchHeader, records_.data(), records_.size());
+        if (!heap_.empty()) std::memcpy(out + kBatchHeader + records_.size(), heap_.data(), heap_.size());
+        return {out, size};
+    }
+
+private:
+    std::pmr::vector<uint8_t> records_;
+    std::pmr::vector<uint8_t> heap_;
+    std::pmr::memory_resource* mr_;
+    std::size_t count_ = 0;
+};
+
+// ============================================================================
+// ZERO-COPY READING
+// ============================================================================
+
+template<typename T>
+class RecordView {
+public:
+    RecordView(const uint8_t* record, const uint8_t* heap) : record_(record), heap_(heap) {}
+
+    // Field by proto number, e.g. get<2>() for User.name
+    template<uint32_t Number>
+    auto get() const {
+        constexpr std::size_t I = Layout<T>::template index_of<Number>();
+        using M = typename Layout<T>::template FieldAt<I>::member_type;
+        return read<M>(record_ + Layout<T>::template offset<I>());
+    }
+
+    // The whole message as a view struct; strings point into the buffer
+    T decode() const {
+        T msg{};
+        for_each_field<T>([&](auto index, const auto& f) {
+            using M = typename std::decay_t<decltype(f)>::member_type;
+            msg.*(f.member) = read<M>(record_ + Layout<T>::template offset<decltype(index)::value>());
+        });
+        return msg;
+    }
+
+private:
+    template<typename M>
+    M read(const uint8_t* slot) const {
+        if constexpr (std::is_same_v<M, std::string_view>) {
+            return {reinterpret_cast<const char*>(heap_ + load_u32(slot)), load_u32(slot + 4)};
+        } else if constexpr (std::is_same_v<M, bool>) {
+            // Any byte other than 0/1 copied into a bool is UB, so test it instead
+            return *slot != 0;
+        } else {
+            M v;
+            std::memcpy(&v, slot, sizeof(M));
+            return v;
+        }
+    }
+
+    const uint8_t* record_;
+    const uint8_t* heap_;
+};
+
+template<typename T>
+class BatchView {
+public:
+    // Checks the header and every string bound once, so access is unchecked
+    BatchView(const uint8_t* data, std::size_t size) : data_(data) {
+        if (size < kBatchHeader) throw FormatError("batch too small");
+        count_ = load_u32(data);
+        if (load_u32(data + 4) != Layout<T>::record_size) throw FormatError("record size does not match schema");
+        std::size_t records_end = kBatchHeader + count_ * Layout<T>::record_size;
+        if (records_end > size) throw FormatError("truncated records");
+        heap_ = data + records_end;
+        std::size_t heap_size = size - records_end;
+        for (std::size_t i = 0; i < count_; ++i) {
+            const uint8_t* record = data_ + kBatchHeader + i * Layout<T>::record_size;
+            for_each_field<T>([&](auto index, const auto& f) {
+                if constexpr (std::is_same_v<typename std::decay_t<decltype(f)>::member_type, std::string_view>) {
+                    const uint8_t* slot = record + Layout<T>::template offset<decltype(index)::value>();
+                    if (uint64_t{load_u32(slot)} + load_u32(slot + 4) > heap_size) {
+                        throw FormatError("string outside the batch");
+                    }
+                }
+            });
+        }
+    }
+
+    std::size_t size() const { return count_; }
+
+    RecordView<T> operator[](std::size_t i) const {
+        return {data_ + kBatchHeader + i * Layout<T>::record_size, heap_};
+    }
+
+private:
+    const uint8_t* data_;
+    const uint8_t* heap_;
+    std::size_t count_;
+};
+
+} // namespace flat
+
+// ============================================================================
+// SCHEMAS (mirror user.proto / todo.proto; see --generate)
+// ============================================================================
+
+namespace flat_schema {
+
+struct User {
+    std::string_view id;
+    std::string_view name;
+    std::string_view email;
+    int32_t age = 0;
+
+    static constexpr auto fields() {
+        return std::make_tuple(flat::field<1>("id", &User::id), flat::field<2>("name", &User::name),
+                               flat::field<3>("email", &User::email), flat::field<4>("age", &User::age));
+    }
+};
+
+struct Todo {
+    std::string_view id;
+    std::string_view title;
+    std::string_view description;
+    bool completed = false;
+    std::string_view created_at;
+
+    static constexpr auto fields() {
+        return std::make_tuple(flat::field<1>("id", &Todo::id), flat::field<2>("title", &Todo::title),
+                               flat::field<3>("description", &Todo::description),
+                               flat::field<4>("completed", &Todo::completed),
+                               flat::field<5>("created_at", &Todo::created_at));
+    }
+};
+
+} // namespace flat_schema
+
+// ============================================================================
+// SCHEMA CHECK AND GENERATION
+// ============================================================================
+
+namespace pb = google::protobuf;
+
+const char* cpp_type_for(const pb::FieldDescriptor* fd) {
+    switch (fd->type()) {
+        case pb::FieldDescriptor::TYPE_STRING:
+        case pb::FieldDescriptor::TYPE_BYTES: return "std::string_view";
+        case pb::FieldDescriptor::TYPE_INT32:
+        case pb::FieldDescriptor::TYPE_SINT32:
+        case pb::FieldDescriptor::TYPE_SFIXED32: return "int32_t";
+        case pb::FieldDescriptor::TYPE_INT64:
+        case pb::FieldDescriptor::TYPE_SINT64:
+        case pb::FieldDescriptor::TYPE_SFIXED64: return "int64_t";
+        case pb::FieldDescriptor::TYPE_BOOL: return "bool";
+        default: return nullptr;
+    }
+}
+
+bool kind_matches(flat::Kind kind, const pb::FieldDescriptor* fd) {
+    const char* cpp = cpp_type_for(fd);
+    if (!cpp || fd->is_repeated()) return false;
+    switch (kind) {
+        case flat::Kind::Int32: return std::string(cpp) == "int32_t";
+        case flat::Kind::Int64: return std::string(cpp) == "int64_t";
+        case flat::Kind::Bool: return std::string(cpp) == "bool";
+        case flat::Kind::String: return std::string(cpp) == "std::string_view";
+    }
+    return false;
+}
+
+// Empty when the struct matches the .proto message field for field
+template<typename T>
+std::vector<std::string> schema_mismatches(const pb::Descriptor* d) {
+    std::vector<std::string> problems;
+    std::vector<int> mirrored;
+    flat::for_each_field<T>([&](auto, const auto& f) {
+        using F = std::decay_t<decltype(f)>;
+        mirrored.push_back(static_cast<int>(F::number));
+        const pb::FieldDescriptor* fd = d->FindFieldByNumber(static_cast<int>(F::number));
+        if (!fd) {
+            problems.push_back(d->name() + ": field " + std::to_string(F::number) + " not in the .proto");
+        } else if (fd->name() != f.name) {
+            problems.push_back(d->name() + "." + fd->name() + " is named " + f.name + " in the schema");
+        } else if (!kind_matches(flat::Slot<typename F::member_type>::kind, fd)) {
+            problems.push_back(d->name() + "." + fd->name() + " has a different type");
+        }
+    });
+    for (int i = 0; i < d->field_count(); ++i) {
+        if (std::find(mirrored.begin(), mirrored.end(), d->field(i)->number()) == mirrored.end()) {
+            problems.push_back(d->name() + "." + d->field(i)->name() + " missing from the schema");
+        }
+    }
+    return problems;
+}
+
+// Prints the schema struct for a message, ready to paste into flat_schema
+void generate(const pb::Descriptor* d) {
+    std::cout << "struct " << d->name() << " {\n";
+    for (int i = 0; i < d->field_count(); ++i) {
+        const pb::FieldDescriptor* fd = d->field(i);
+        const char* cpp = cpp_type_for(fd);
+        if (!cpp || fd->is_repeated()) {
+            std::cout << "    // " << fd->name() << ": unsupported type, not generated\n";
+            continue;
+        }
+        std::string init = std::string(cpp) == "bool" ? " = false" : std::string(cpp) == "std::string_view" ? "" : " = 0";
+        std::cout << "    " << cpp << " " << fd->name() << init << ";\n";
+    }
+    std::cout << "\n    static constexpr auto fields() {\n        return std::make_tuple(";
+    bool first = true;
+    for (int i = 0; i < d->field_count(); ++i) {
+        const pb::FieldDescriptor* fd = d->field(i);
+        if (!cpp_type_for(fd) || fd->is_repeated()) continue;
+        std::cout << (first ? "" : ",\n                               ") << "flat::field<" << fd->number() << ">(\""
+                  << fd->name() << "\", &" << d->name() << "::" << fd->name() << ")";
+        first = false;
+    }
+    std::cout << ");\n    }\n};\n\n";
+}
+
+// ============================================================================
+// BENCHMARK
+// ============================================================================
+
+// Global allocation counter: every operator new in the process
+static std::atomic<uint64_t> g_allocations{0};
+
+// GCC flags free() in a replaced operator delete as mismatched; it is not
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+#pragma GCC diagnostic pop
+
+using Clock = std::chrono::steady_clock;
+
+struct Measurement {
+    double ms;
+    double allocations;   // per round
+};
+
+template<typename Body>
+Measurement measure(int rounds, Body&& body) {
+    double best = 1e18;
+    uint64_t allocs = 0;
+    for (int r = 0; r < rounds; ++r) {
+        uint64_t before = g_allocations.load(std::memory_order_relaxed);
+        auto start = Clock::now();
+        body();
+        best = std::min(best, std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        allocs += g_allocations.load(std::memory_order_relaxed) - before;
+    }
+    return {best, double(allocs) / rounds};
+}
+
+void report(const char* what, Measurement m, std::size_t messages, std::size_t bytes) {
+    std::cout << "  " << std::left << std::setw(40) << what << std::right << std::fixed << std::setprecision(2)
+              << std::setw(8) << m.ms << " ms " << std::setw(8) << messages / m.ms / 1e3 << " M msg/s "
+              << std::setw(10) << std::setprecision(0) << m.allocations << " allocs";
+    if (bytes) std::cout << std::setw(8) << std::setprecision(1) << bytes / 1e6 << " MB";
+    std::cout << "\n";
+}
+
+struct UserRow {
+    std::string id, name, email;
+    int32_t age;
+};
+
+struct TodoRow {
+    std::string id, title, description, created_at;
+    bool completed;
+};
+
+std::string random_text(std::mt19937& rng, std::size_t min, std::size_t max) {
+    std::string s(min + rng() % (max - min + 1), ' ');
+    for (auto& c : s) c = static_cast<char>('a' + rng() % 26);
+    return s;
+}
+
+// Backing store for the arenas, reused every round so the timings do not
+// include first-touch page faults
+std::vector<std::byte>& arena_buffer() {
+    static std::vector<std::byte> buffer(64 * 1024 * 1024);
+    return buffer;
+}
+
+void bench_users(std::size_t n, int rounds) {
+    std::mt19937 rng(1);
+    std::vector<UserRow> rows;
+    for (std::size_t i = 0; i < n; ++i) {
+        rows.push_back({"user-" + std::to_string(100000 + i), random_text(rng, 8, 24),
+                        random_text(rng, 8, 16) + "@example.com", static_cast<int32_t>(18 + rng() % 60)});
+    }
+    std::vector<flat_schema::User> views;
+    for (auto& r : rows) views.push_back({r.id, r.name, r.email, r.age});
+    uint64_t expected_ages = 0;
+    for (auto& r : rows) expected_ages += r.age;
+
+    std::cout << "\nUser: ListUsersResponse with " << n << " users (best of " << rounds << ")\n";
+
+    std::string pb_bytes;
+    auto pb_encode = measure(rounds, [&] {
+        simple::ListUsersResponse response;
+        for (auto& r : rows) {
+            simple::User* u = response.add_users();
+            u->set_id(r.id);
+            u->set_name(r.name);
+            u->set_email(r.email);
+            u->set_age(r.age);
+        }
+        response.SerializeToString(&pb_bytes);
+    });
+    report("protobuf encode", pb_encode, n, pb_bytes.size());
+
+    uint64_t ages = 0;
+    auto pb_decode_copy = measure(rounds, [&] {
+        simple::ListUsersResponse response;
+        response.ParseFromString(pb_bytes);
+        std::vector<simple::User> users;   // what SimpleGrpcClient::ListUsers did
+        for (const auto& u : response.users()) users.push_back(u);
+        ages = 0;
+        for (auto& u : users) ages += u.age();
+    });
+    if (ages != expected_ages) std::exit(1);
+    report("protobuf decode + copy to vector", pb_decode_copy, n, 0);
+
+    auto pb_decode_arena = measure(rounds, [&] {
+        pb::Arena arena;
+        auto* response = pb::Arena::CreateMessage<simple::ListUsersResponse>(&arena);
+        response->ParseFromString(pb_bytes);
+        ages = 0;
+        for (const auto& u : response->users()) ages += u.age();
+    });
+    if (ages != expected_ages) std::exit(1);
+    report("protobuf decode on Arena, no copy", pb_decode_arena, n, 0);
+
+    ArenaResource arena(arena_buffer().data(), arena_buffer().size());
+    flat::Encoded encoded{};
+    auto flat_encode = measure(rounds, [&] {
+        arena.release();
+        encoded = flat::encode_batch(views.data(), views.size(), &arena);
+    });
+    report("flat encode_batch into arena", flat_encode, n, encoded.size);
+
+    auto flat_build = measure(rounds, [&] {
+        arena.release();
+        flat::Builder<flat_schema::User> builder(&arena);
+        for (auto& v : views) builder.add(v);
+        encoded = builder.finish();
+    });
+    report("flat Builder (one at a time) into arena", flat_build, n, encoded.size);
+
+    std::size_t name_bytes = 0;
+    auto flat_decode = measure(rounds, [&] {
+        flat::BatchView<flat_schema::User> batch(encoded.data, encoded.size);
+        ages = 0;
+        name_bytes = 0;
+        for (std::size_t i = 0; i < batch.size(); ++i) {
+            ages += static_cast<uint64_t>(batch[i].get<4>());
+            name_bytes += batch[i].get<2>().size();
+        }
+    });
+    if (ages != expected_ages) std::exit(1);
+    report("flat BatchView (validate + read)", flat_decode, n, 0);
+
+    flat::BatchView<flat_schema::User> batch(encoded.data, encoded.size);
+    flat_schema::User back = batch[n / 2].decode();
+    const UserRow& src = rows[n / 2];
+    bool same = back.id == src.id && back.name == src.name && back.email == src.email && back.age == src.age;
+    std::cout << "  round trip of user " << n / 2 << ": " << (same ? "ok" : "MISMATCH") << "\n";
+    if (!same) std::exit(1);
+}
+
+void bench_todos(std::size_t n, int rounds) {
+    std::mt19937 rng(2);
+    std::vector<TodoRow> rows;
+    for (std::size_t i = 0; i < n; ++i) {
+        rows.push_back({"todo-" + std::to_string(i), random_text(rng, 10, 40), random_text(rng, 20, 120),
+                        "2026-10-17T12:00:00Z", (rng() & 3) == 0});
+    }
+    std::vector<flat_schema::Todo> views;
+    for (auto& r : rows) views.push_back({r.id, r.title, r.description, r.completed, r.created_at});
+    std::size_t expected_done = 0;
+    for (auto& r : rows) expected_done += r.completed;
+
+    std::cout << "\nTodo: " << n << " todos, streamed one message each (protobuf) vs one batch (flat)\n";
+
+    std::vector<std::string> pb_stream(n);
+    std::size_t pb_size = 0;
+    auto pb_encode = measure(rounds, [&] {
+        pb_size = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            simple::Todo t;
+            t.set_id(rows[i].id);
+            t.set_title(rows[i].title);
+            t.set_description(rows[i].description);
+            t.set_completed(rows[i].completed);
+            t.set_created_at(rows[i].created_at);
+            t.SerializeToString(&pb_stream[i]);
+            pb_size += pb_stream[i].size();
+        }
+    });
+    report("protobuf encode per message", pb_encode, n, pb_size);
+
+    std::size_t done = 0;
+    auto pb_decode = measure(rounds, [&] {
+        std::vector<simple::Todo> todos;   // what SimpleGrpcClient::GetTodos did
+        simple::Todo t;
+        for (auto& bytes : pb_stream) {
+            t.ParseFromString(bytes);
+            todos.push_back(t);
+        }
+        done = 0;
+        for (auto& todo : todos) done += todo.completed();
+    });
+    if (done != expected_done) std::exit(1);
+    report("protobuf decode + copy to vector", pb_decode, n, 0);
+
+    ArenaResource arena(arena_buffer().data(), arena_buffer().size());
+    flat::Encoded encoded{};
+    auto flat_encode = measure(rounds, [&] {
+        arena.release();
+        encoded = flat::encode_batch(views.data(), views.size(), &arena);
+    });
+    report("flat encode_batch into arena", flat_encode, n, encoded.size);
+
+    auto flat_decode = measure(rounds, [&] {
+        flat::BatchView<flat_schema::Todo> batch(encoded.data, encoded.size);
+        done = 0;
+        for (std::size_t i = 0; i < batch.size(); ++i) done += batch[i].get<4>();
+    });
+    if (done != expected_done) std::exit(1);
+    report("flat BatchView (validate + read)", flat_decode, n, 0);
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "--generate") {
+        generate(simple::User::descriptor());
+        generate(simple::Todo::descriptor());
+        return 0;
+    }
+
+    auto problems = schema_mismatches<flat_schema::User>(simple::User::descriptor());
+    auto todo_problems = schema_mismatches<flat_schema::Todo>(simple::Todo::descriptor());
+    problems.insert(problems.end(), todo_problems.begin(), todo_problems.end());
+    for (auto& p : problems) std::cerr << "schema drift: " << p << "\n";
+    if (!problems.empty()) return 1;
+    std::cout << "schemas match user.proto / todo.proto; User record " << flat::Layout<flat_schema::User>::record_size
+              << " bytes, Todo record " << flat::Layout<flat_schema::Todo>::record_size << " bytes\n";
+
+    // A corrupt length is caught by BatchView, not by a read past the end
+    {
+        std::pmr::monotonic_buffer_resource mr;
+        flat_schema::User u{"u1", "Ada", "ada@example.com", 36};
+        flat::Encoded one = flat::encode_batch(&u, 1, &mr);
+        flat::store_u32(one.data + flat::kBatchHeader + 12, 1000);   // name length
+        try {
+            flat::BatchView<flat_schema::User> bad(one.data, one.size);
+            std::cout << "corrupt batch accepted\n";
+            return 1;
+        } catch (const flat::FormatError& e) {
+            std::cout << "corrupt batch rejected: " << e.what() << "\n";
+        }
+    }
+
+    // A bool byte other than 0/1 reads as true rather than as an invalid bool
+    {
+        using L = flat::Layout<flat_schema::Todo>;
+        std::pmr::monotonic_buffer_resource mr;
+        flat_schema::Todo t{};
+        flat::Encoded one = flat::encode_batch(&t, 1, &mr);
+        one.data[flat::kBatchHeader + L::offset<L::index_of<4>()>()] = 2;
+        flat::BatchView<flat_schema::Todo> batch(one.data, one.size);
+        if (!batch[0].get<4>() || !batch[0].decode().completed) {
+            std::cout << "bool byte 2 read as false\n";
+            return 1;
+        }
+    }
+
+    bench_users(100'000, 10);
+    bench_todos(100'000, 10);
+    return 0;
+}
@@ -0,0 +1,24 @@
+#ifndef FUZZ_TARGET_H
+#define FUZZ_TARGET_H
+
+// Between coverage_fuzzer.cpp (the engine, built without coverage
+// instrumentation) and fuzz_targets.cpp (built with it)
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct FuzzTarget {
+    const char* name;
+    const char* description;
+    // libFuzzer's LLVMFuzzerTestOneInput contract: return 0; a finding is a
+    // crash (signal, abort, uncaught exception)
+    int (*run)(const uint8_t* data, std::size_t size);
+    std::vector<std::string> seeds;
+    std::vector<std::string> dictionary;
+};
+
+const std::vector<FuzzTarget>& fuzz_targets();
+
+#endif // FUZZ_TARGET_H
@@ -0,0 +1,781 @@
+// SAFE MEMORY RECLAMATION FOR LOCK-FREE STRUCTURES
+//
+// A lock-free pop cannot `delete` the node it unlinked: another thread may
+// still be reading `old_head->next`, and a recycled address makes a stale
+// CAS succeed (ABA). Two reclamation schemes solve this:
+//   - Hazard pointers: readers publish the node they are about to touch;
+//     retired nodes are freed only when no hazard slot points at them.
+//   - Epoch-based: readers announce the global epoch they run in; a node
+//     retired in epoch E is freed once the global epoch reaches E + 2.
+// Nodes come from a per-thread pool, so push/pop do not hit malloc.
+//
+// Build: g++ -std=c++20 -O2 -pthread lockfree_reclamation.cpp
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <stack>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+constexpr std::size_t CACHE_LINE  = 64;
+constexpr std::size_t MAX_THREADS = 128;
+
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+inline std::uint32_t thread_random() {
+    thread_local std::uint32_t state =
+        static_cast<std::uint32_t>(std::hash<std::thread::id>{}(std::this_thread::get_id())) | 1u;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+
+// NODE POOL
+
+// Fixed-size blocks recycled through a thread-local cache.
+// The shared list is only touched in batches of BATCH blocks.
+template<std::size_t BlockSize>
+class NodePool {
+public:
+    static void* allocate() {
+        if (cache_destroyed_) {
+            return ::operator new(BlockSize);
+        }
+        auto& cache = local();
+        if (cache.blocks.empty()) {
+            shared().refill(cache.blocks);
+            if (cache.blocks.empty()) {
+                return ::operator new(BlockSize);
+            }
+        }
+        void* p = cache.blocks.back();
+        cache.blocks.pop_back();
+        return p;
+    }
+
+    static void deallocate(void* p) {
+        if (cache_destroyed_) {
+            std::vector<void*> single{p};
+            shared().spill(single, 1);
+            return;
+        }
+        auto& cache = local();
+        cache.blocks.push_back(p);
+        if (cache.blocks.size() >= 2 * BATCH) {
+            shared().spill(cache.blocks, BATCH);
+        }
+    }
+
+private:
+    static constexpr std::size_t BATCH = 64;
+
+    struct Shared {
+        std::mutex mtx;
+        std::vector<void*> blocks;
+
+        void refill(std::vector<void*>& out) {
+            std::lock_guard<std::mutex> lock(mtx);
+            std::size_t n = std::min(BATCH, blocks.size());
+            out.insert(out.end(), blocks.end() - n, blocks.end());
+            blocks.resize(blocks.size() - n);
+        }
+
+        void spill(std::vector<void*>& in, std::size_t n) {
+            std::lock_guard<std::mutex> lock(mtx);
+            blocks.insert(blocks.end(), in.end() - n, in.end());
+            in.resize(in.size() - n);
+        }
+    };
+
+    struct Cache {
+        std::vector<void*> blocks;
+        ~Cache() {
+            shared().spill(blocks, blocks.size());
+            cache_destroyed_ = true;
+        }
+    };
+
+    // Reclaimers running their own thread-exit cleanup may free nodes
+    // after this thread's cache is gone; those go straight to the shared list.
+    static inline thread_local bool cache_destroyed_ = false;
+
+    // Leaked on purpose: thread-local caches flush into it at thread exit,
+    // which may happen after static destructors have run.
+    static Shared& shared() {
+        static Shared* s = new Shared;
+        return *s;
+    }
+
+    static Cache& local() {
+        thread_local Cache cache;
+        return cache;
+    }
+};
+
+template<typename Node, typename... Args>
+Node* pool_new(Args&&... args) {
+    return new (NodePool<sizeof(Node)>::allocate()) Node(std::forward<Args>(args)...);
+}
+
+template<typename Node>
+void pool_delete(Node* node) {
+    node->~Node();
+    NodePool<sizeof(Node)>::deallocate(node);
+}
+
+
+// HAZARD POINTERS
+
+class HazardPointers {
+public:
+    static constexpr std::size_t SLOTS = 2;   // enough for Michael-Scott queue
+
+private:
+    struct alignas(CACHE_LINE) Record {
+        std::atomic<void*> slots[SLOTS] = {};
+        std::atomic<bool> in_use{false};
+    };
+
+    struct Retired {
+        void* ptr;
+        void (*reclaim)(void*);
+    };
+
+    struct ThreadState {
+        Record* record;
+        std::vector<Retired> retired;
+        std::vector<void*> hazards;   // scratch for scan()
+
+        ThreadState() : record(instance().acquire()) {}
+        ~ThreadState() { instance().release(*this); }
+    };
+
+public:
+    static HazardPointers& instance() {
+        static HazardPointers* domain = new HazardPointers;
+        return *domain;
+    }
+
+    class Guard {
+    public:
+        Guard() : record_(instance().local().record) {}
+        ~Guard() { clear(); }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+        // Publish src's current value in `slot` and re-check that it is
+        // still reachable; after this returns the node cannot be freed.
+        template<typename T>
+        T* protect(std::size_t slot, const std::atomic<T*>& src) {
+            T* p = src.load(std::memory_order_relaxed);
+            for (;;) {
+                record_->slots[slot].store(p, std::memory_order_seq_cst);
+                T* again = src.load(std::memory_order_acquire);
+                if (again == p) {
+                    return p;
+                }
+                p = again;
+            }
+        }
+
+        void clear() {
+            for (auto& slot : record_->slots) {
+                slot.store(nullptr, std::memory_order_release);
+            }
+        }
+
+    private:
+        Record* record_;
+    };
+
+    void retire(void* p, void (*reclaim)(void*)) {
+        auto& state = local();
+        state.retired.push_back({p, reclaim});
+        // Threshold proportional to the number of hazard slots keeps
+        // scanning amortized O(1) per retired node.
+        if (state.retired.size() >= 2 * MAX_THREADS * SLOTS) {
+            scan(state);
+        }
+    }
+
+private:
+    HazardPointers() = default;
+
+    ThreadState& local() {
+        thread_local ThreadState state;
+        return state;
+    }
+
+    Record* acquire() {
+        for (auto& record : records_) {
+            bool expected = false;
+            if (!record.in_use.load(std::memory_order_relaxed) &&
+                record.in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                return &record;
+            }
+        }
+        throw std::runtime_error("HazardPointers: more than MAX_THREADS threads");
+    }
+
+    void release(ThreadState& state) {
+        for (auto& slot : state.record->slots) {
+            slot.store(nullptr, std::memory_order_release);
+        }
+        scan(state);
+        if (!state.retired.empty()) {
+            std::lock_guard<std::mutex> lock(orphans_mutex_);
+            orphans_.insert(orphans_.end(), state.retired.begin(), state.retired.end());
+        }
+        state.record->in_use.store(false, std::memory_order_release);
+    }
+
+    void scan(ThreadState& state) {
+        // Adopt nodes left behind by threads that have exited
+        {
+            std::unique_lock<std::mutex> lock(orphans_mutex_, std::try_to_lock);
+            if (lock.owns_lock() && !orphans_.empty()) {
+                state.retired.insert(state.retired.end(), orphans_.begin(), orphans_.end());
+                orphans_.clear();
+            }
+        }
+
+        auto& hazards = state.hazards;
+        hazards.clear();
+        for (auto& record : records_) {
+            for (auto& slot : record.slots) {
+                if (void* p = slot.load(std::memory_order_seq_cst)) {
+                    hazards.push_back(p);
+                }
+            }
+        }
+        std::sort(hazards.begin(), hazards.end());
+
+        auto still_hazardous = std::partition(
+            state.retired.begin(), state.retired.end(),
+            [&](const Retired& r) {
+                return std::binary_search(hazards.begin(), hazards.end(), r.ptr);
+            });
+        for (auto it = still_hazardous; it != state.retired.end(); ++it) {
+            it->reclaim(it->ptr);
+        }
+        state.retired.erase(still_hazardous, state.retired.end());
+    }
+
+    Record records_[MAX_THREADS];
+    std::mutex orphans_mutex_;
+    std::vector<Retired> orphans_;
+};
+
+
+// EPOCH-BASED RECLAMATION
+
+class EpochReclamation {
+private:
+    static constexpr std::uint64_t QUIESCENT = UINT64_MAX;
+    static constexpr std::size_t COLLECT_INTERVAL = 128;
+
+    struct alignas(CACHE_LINE) Slot {
+        std::atomic<std::uint64_t> epoch{QUIESCENT};
+        std::atomic<bool> in_use{false};
+    };
+
+    struct Retired {
+        void* ptr;
+        void (*reclaim)(void*);
+        std::uint64_t epoch;
+    };
+
+    struct ThreadState {
+        Slot* slot;
+        unsigned depth = 0;
+        std::size_t since_collect = 0;
+        std::vector<Retired> retired;
+
+        ThreadState() : slot(instance().acquire()) {}
+        ~ThreadState() { instance().release(*this); }
+    };
+
+public:
+    static EpochReclamation& instance() {
+        static EpochReclamation* domain = new EpochReclamation;
+        return *domain;
+    }
+
+    // Critical section: nodes loaded inside it stay valid until it ends.
+    class Guard {
+    public:
+        Guard() : state_(instance().local()) { instance().enter(state_); }
+        ~Guard() { instance().exit(state_); }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+        template<typename T>
+        T* protect(std::size_t, const std::atomic<T*>& src) {
+            return src.load(std::memory_order_acquire);
+        }
+
+        void clear() {}
+
+    private:
+        ThreadState& state_;
+    };
+
+    void retire(void* p, void (*reclaim)(void*)) {
+        auto& state = local();
+        state.retired.push_back({p, reclaim, global_epoch_.load(std::memory_order_acquire)});
+        if (++state.since_collect >= COLLECT_INTERVAL) {
+            state.since_collect = 0;
+            try_advance();
+            collect(state);
+        }
+    }
+
+private:
+    EpochReclamation() = default;
+
+    ThreadState& local() {
+        thread_local ThreadState state;
+        return state;
+    }
+
+    Slot* acquire() {
+        for (auto& slot : slots_) {
+            bool expected = false;
+            if (!slot.in_use.load(std::memory_order_relaxed) &&
+                slot.in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                return &slot;
+            }
+        }
+        throw std::runtime_error("EpochReclamation: more than MAX_THREADS threads");
+    }
+
+    void release(ThreadState& state) {
+        state.slot->epoch.store(QUIESCENT, std::memory_order_release);
+        try_advance();
+        collect(state);
+        if (!state.retired.empty()) {
+            std::lock_guard<std::mutex> lock(orphans_mutex_);
+            orphans_.insert(orphans_.end(), state.retired.begin(), state.retired.end());
+        }
+        state.slot->in_use.store(false, std::memory_order_release);
+    }
+
+    void enter(ThreadState& state) {
+        if (state.depth++ == 0) {
+            state.slot->epoch.store(global_epoch_.load(std::memory_order_relaxed),
+                                    std::memory_order_relaxed);
+            // Announcement must be visible before any shared pointer is read
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+    }
+
+    void exit(ThreadState& state) {
+        if (--state.depth == 0) {
+            state.slot->epoch.store(QUIESCENT, std::memory_order_release);
+        }
+    }
+
+    // The epoch moves forward only when every active thread has seen it
+    void try_advance() {
+        std::uint64_t current = global_epoch_.load(std::memory_order_acquire);
+        for (auto& slot : slots_) {
+            std::uint64_t e = slot.epoch.load(std::memory_order_acquire);
+            if (e != QUIESCENT && e != current) {
+                return;
+            }
+        }
+        global_epoch_.compare_exchange_strong(current, current + 1, std::memory_order_acq_rel);
+    }
+
+    void collect(ThreadState& state) {
+        {
+            std::unique_lock<std::mutex> lock(orphans_mutex_, std::try_to_lock);
+            if (lock.owns_lock() && !orphans_.empty()) {
+                state.retired.insert(state.retired.end(), orphans_.begin(), orphans_.end());
+                orphans_.clear();
+            }
+        }
+
+        std::uint64_t safe = global_epoch_.load(std::memory_order_acquire);
+        auto reclaimable = std::partition(
+            state.retired.begin(), state.retired.end(),
+            [safe](const Retired& r) { return r.epoch + 2 > safe; });
+        for (auto it = reclaimable; it != state.retired.end(); ++it) {
+            it->reclaim(it->ptr);
+        }
+        state.retired.erase(reclaimable, state.retired.end());
+    }
+
+    alignas(CACHE_LINE) std::atomic<std::uint64_t> global_epoch_{0};
+    Slot slots_[MAX_THREADS];
+    std::mutex orphans_mutex_;
+    std::vector<Retired> orphans_;
+};
+
+
+// TREIBER STACK WITH ELIMINATION BACKOFF
+
+// When the head CAS fails under contention, a push and a pop can meet in
+// a side array and exchange the value without touching the head at all.
+template<typename Node>
+class EliminationArray {
+public:
+    // Returns true if a popper took the node; the node is then freed here.
+    bool offer(Node* node) {
+        Slot& slot = slots_[thread_random() % SLOTS];
+        Node* expected = nullptr;
+        if (!slot.ptr.compare_exchange_strong(expected, node, std::memory_order_acq_rel)) {
+            return false;
+        }
+
+        for (int i = 0; i < SPINS && slot.ptr.load(std::memory_order_acquire) == node; ++i) {
+            cpu_relax();
+        }
+
+        expected = node;
+        if (slot.ptr.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel)) {
+            return false;   // nobody came, withdraw
+        }
+
+        // A popper is moving the value out; wait until it is done with the node
+        while (slot.ptr.load(std::memory_order_acquire) != taken()) {
+            cpu_relax();
+        }
+        pool_delete(node);
+        slot.ptr.store(nullptr, std::memory_order_release);
+        return true;
+    }
+
+    template<typename T>
+    bool take(T& out) {
+        Slot& slot = slots_[thread_random() % SLOTS];
+        Node* node = slot.ptr.load(std::memory_order_acquire);
+        if (node == nullptr || node == busy() || node == taken()) {
+            return false;
+        }
+        if (!slot.ptr.compare_exchange_strong(node, busy(), std::memory_order_acq_rel)) {
+            return false;
+        }
+        out = std::move(node->value);
+        slot.ptr.store(taken(), std::memory_order_release);
+        return true;
+    }
+
+private:
+    static constexpr std::size_t SLOTS = 8;
+    static constexpr int SPINS = 64;
+
+    static Node* busy()  { return reinterpret_cast<Node*>(std::uintptr_t{1}); }
+    static Node* taken() { return reinterpret_cast<Node*>(std::uintptr_t{2}); }
+
+    struct alignas(CACHE_LINE) Slot {
+        std::atomic<Node*> ptr{nullptr};
+    };
+
+    Slot slots_[SLOTS];
+};
+
+template<typename T, typename Reclaimer>
+class TreiberStack {
+private:
+    struct Node {
+        T value;
+        Node* next;
+    };
+
+public:
+    TreiberStack() = default;
+    TreiberStack(const TreiberStack&) = delete;
+    TreiberStack& operator=(const TreiberStack&) = delete;
+
+    ~TreiberStack() {
+        Node* node = head_.load(std::memory_order_relaxed);
+        while (node) {
+            Node* next = node->next;
+            pool_delete(node);
+            node = next;
+        }
+    }
+
+    void push(T value) {
+        Node* node = pool_new<Node>(std::move(value), nullptr);
+        for (;;) {
+            node->next = head_.load(std::memory_order_relaxed);
+            if (head_.compare_exchange_strong(node->next, node,
+                                              std::memory_order_release,
+                                              std::memory_order_relaxed)) {
+                return;
+            }
+            if (elimination_.offer(node)) {
+                return;
+            }
+        }
+    }
+
+    bool pop(T& out) {
+        typename Reclaimer::Guard guard;
+        for (;;) {
+            Node* head = guard.protect(0, head_);
+            if (!head) {
+                return false;
+            }
+            // Safe: `head` is protected, so it has not been freed or reused
+            Node* next = head->next;
+            if (head_.compare_exchange_strong(head, next,
+                                              std::memory_order_acquire,
+                                              std::memory_order_relaxed)) {
+                out = std::move(head->value);
+                guard.clear();
+                Reclaimer::instance().retire(head, &reclaim);
+                return true;
+            }
+            if (elimination_.take(out)) {
+                return true;
+            }
+        }
+    }
+
+private:
+    static void reclaim(void* p) { pool_delete(static_cast<Node*>(p)); }
+
+    alignas(CACHE_LINE) std::atomic<Node*> head_{nullptr};
+    EliminationArray<Node> elimination_;
+};
+
+
+// MICHAEL-SCOTT QUEUE
+
+template<typename T, typename Reclaimer>
+class MSQueue {
+private:
+    struct Node {
+        T value{};
+        std::atomic<Node*> next{nullptr};
+    };
+
+public:
+    MSQueue() {
+        Node* dummy = pool_new<Node>();
+        head_.store(dummy, std::memory_order_relaxed);
+        tail_.store(dummy, std::memory_order_relaxed);
+    }
+
+    MSQueue(const MSQueue&) = delete;
+    MSQueue& operator=(const MSQueue&) = delete;
+
+    ~MSQueue() {
+        Node* node = head_.load(std::memory_order_relaxed);
+        while (node) {
+            Node* next = node->next.load(std::memory_order_relaxed);
+            pool_delete(node);
+            node = next;
+        }
+    }
+
+    void enqueue(T value) {
+        Node* node = pool_new<Node>();
+        node->value = std::move(value);
+
+        typename Reclaimer::Guard guard;
+        for (;;) {
+            Node* tail = guard.protect(0, tail_);
+            Node* next = tail->next.load(std::memory_order_acquire);
+            if (tail != tail_.load(std::memory_order_acquire)) {
+                continue;
+            }
+            if (next) {
+                // Tail is lagging: help the other enqueuer finish
+                tail_.compare_exchange_weak(tail, next, std::memory_order_release,
+                                            std::memory_order_relaxed);
+                continue;
+            }
+            Node* expected = nullptr;
+            if (tail->next.compare_exchange_weak(expected, node, std::memory_order_release,
+                                                 std::memory_order_relaxed)) {
+                tail_.compare_exchange_strong(tail, node, std::memory_order_release,
+                                              std::memory_order_relaxed);
+                return;
+            }
+        }
+    }
+
+    bool dequeue(T& out) {
+        typename Reclaimer::Guard guard;
+        for (;;) {
+            Node* head = guard.protect(0, head_);
+            Node* tail = tail_.load(std::memory_order_acquire);
+            Node* next = guard.protect(1, head->next);
+            if (head != head_.load(std::memory_order_acquire)) {
+                continue;
+            }
+            if (!next) {
+                return false;
+            }
+            if (head == tail) {
+                tail_.compare_exchange_weak(tail, next, std::memory_order_release,
+                                            std::memory_order_relaxed);
+                continue;
+            }
+            // Copy before the CAS: once head moves, another dequeuer owns `next`
+            T value = next->value;
+            if (head_.compare_exchange_strong(head, next, std::memory_order_acq_rel,
+                                              std::memory_order_relaxed)) {
+                out = std::move(value);
+                guard.clear();
+                Reclaimer::instance().retire(head, &reclaim);
+                return true;
+            }
+        }
+    }
+
+private:
+    static void reclaim(void* p) { pool_delete(static_cast<Node*>(p)); }
+
+    alignas(CACHE_LINE) std::atomic<Node*> head_;
+    alignas(CACHE_LINE) std::atomic<Node*> tail_;
+};
+
+
+// BASELINE: mutex-protected std::stack
+
+template<typename T>
+class MutexStack {
+public:
+    void push(T value) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        stack_.push(std::move(value));
+    }
+
+    bool pop(T& out) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (stack_.empty()) return false;
+        out = std::move(stack_.top());
+        stack_.pop();
+        return true;
+    }
+
+private:
+    std::mutex mtx_;
+    std::stack<T> stack_;
+};
+
+
+// STRESS TEST + THROUGHPUT
+
+template<typename Container>
+struct Ops {
+    static void put(Container& c, std::uint64_t v) { c.push(v); }
+    static bool get(Container& c, std::uint64_t& v) { return c.pop(v); }
+};
+
+template<typename T, typename R>
+struct Ops<MSQueue<T, R>> {
+    static void put(MSQueue<T, R>& q, std::uint64_t v) { q.enqueue(v); }
+    static bool get(MSQueue<T, R>& q, std::uint64_t& v) { return q.dequeue(v); }
+};
+
+// Every thread pushes distinct values and pops as many as it can.
+// After draining, the popped count and checksum must match what was pushed:
+// a lost, duplicated or use-after-free corrupted node breaks the checksum.
+template<typename Container>
+bool stress(int threads, int ops_per_thread) {
+    using O = Ops<Container>;
+    Container c;
+    std::atomic<std::uint64_t> popped_sum{0};
+    std::atomic<std::uint64_t> popped_count{0};
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::uint64_t sum = 0, count = 0, v = 0;
+            for (int i = 0; i < ops_per_thread; ++i) {
+                O::put(c, static_cast<std::uint64_t>(t) * ops_per_thread + i + 1);
+                if (O::get(c, v)) {
+                    sum += v;
+                    ++count;
+                }
+            }
+            popped_sum += sum;
+            popped_count += count;
+        });
+    }
+    for (auto& w : workers) w.join();
+
+    std::uint64_t v = 0;
+    while (O::get(c, v)) {
+        popped_sum += v;
+        ++popped_count;
+    }
+
+    std::uint64_t n = static_cast<std::uint64_t>(threads) * ops_per_thread;
+    return popped_count == n && popped_sum == n * (n + 1) / 2;
+}
+
+template<typename Container>
+double throughput_mops(int threads, int ops_per_thread) {
+    using O = Ops<Container>;
+    Container c;
+    std::atomic<bool> go{false};
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            std::uint64_t v = 0;
+            for (int i = 0; i < ops_per_thread; ++i) {
+                O::put(c, static_cast<std::uint64_t>(i));
+                O::get(c, v);
+            }
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& w : workers) w.join();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    return 2.0 * threads * ops_per_thread / elapsed.count() / 1e6;
+}
+
+template<typename Container>
+void run_suite(const char* name) {
+    const int thread_counts[] = {1, 2, 4, 8, 16, 32, 64};
+
+    std::cout << "\n" << name << "\n  stress:";
+    for (int t : thread_counts) {
+        std::cout << " " << t << (stress<Container>(t, 20'000) ? ":ok" : ":FAILED");
+    }
+    std::cout << "\n  Mops/s:";
+    for (int t : thread_counts) {
+        std::cout << " " << t << "=" << throughput_mops<Container>(t, 400'000 / t);
+    }
+    std::cout << "\n";
+}
+
+int main() {
+    using Value = std::uint64_t;
+
+    std::cout.precision(3);
+    run_suite<MutexStack<Value>>("MutexStack (baseline)");
+    run_suite<TreiberStack<Value, HazardPointers>>("TreiberStack + hazard pointers");
+    run_suite<TreiberStack<Value, EpochReclamation>>("TreiberStack + epochs");
+    run_suite<MSQueue<Value, HazardPointers>>("MSQueue + hazard pointers");
+    run_suite<MSQueue<Value, EpochReclamation>>("MSQueue + epochs");
+}
@@ -0,0 +1,635 @@
+// PIECE TABLE TEXT EDITOR WITH COMPACT UNDO
+//
+// The refresher's TextEditor keeps one std::string, so every keystroke in a
+// large document is an O(n) memmove, and undo keeps whole Command objects.
+// Here:
+//   - text lives in two append-only buffers (original file, added text)
+//   - the document is a sequence of pieces (buffer, start, length) held in an
+//     implicit treap keyed by length: insert/erase are O(log n) split/merge
+//   - every node caches its subtree's length and newline count, and each
+//     buffer keeps a sorted newline index, so line <-> offset is O(log n)
+//   - undo/redo records are piece diffs: an offset, an inserted length and
+//     the pieces that were removed. Pieces point into immutable buffers, so
+//     no text is ever copied into history. Consecutive typing and backspace
+//     runs coalesce into one record.
+//
+// Build: g++ -std=c++20 -O3 -march=native piece_table_editor.cpp
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+// PIECE TABLE
+
+struct Piece {
+    std::uint64_t start;
+    std::uint64_t length;
+    std::uint64_t lines;    // newlines inside this piece
+    std::uint8_t buffer;    // ORIGINAL or ADDED
+};
+
+class PieceTable {
+public:
+    static constexpr std::uint8_t ORIGINAL = 0;
+    static constexpr std::uint8_t ADDED = 1;
+
+    explicit PieceTable(std::string original = {}) {
+        buffers[ORIGINAL] = std::move(original);
+        index_newlines(ORIGINAL, 0);
+        nodes.push_back({});   // index 0 is the null node
+        if (!buffers[ORIGINAL].empty()) {
+            root = make_node(make_piece(ORIGINAL, 0, buffers[ORIGINAL].size()));
+        }
+    }
+
+    std::size_t size() const { return nodes[root].size; }
+    std::size_t line_count() const { return nodes[root].lines + 1; }
+
+    void insert(std::size_t pos, std::string_view text) {
+        if (text.empty()) return;
+        std::uint64_t add_start = buffers[ADDED].size();
+        buffers[ADDED].append(text);
+        index_newlines(ADDED, add_start);
+        Piece p = make_piece(ADDED, add_start, text.size());
+
+        auto [left, right] = split(root, pos);
+        // Typing appends to the add buffer right after the previous keystroke:
+        // grow that piece instead of allocating a new node
+        std::uint32_t last = rightmost(left);
+        if (last && nodes[last].piece.buffer == ADDED &&
+            nodes[last].piece.start + nodes[last].piece.length == add_start) {
+            extend_rightmost(left, p.length, p.lines);
+        } else {
+            left = merge(left, make_node(p));
+        }
+        root = merge(left, right);
+    }
+
+    // Removes [pos, pos + len) and returns the pieces that covered it
+    std::vector<Piece> cut(std::size_t pos, std::size_t len) {
+        std::vector<Piece> removed;
+        if (len == 0) return removed;
+        auto [left, rest] = split(root, pos);
+        auto [middle, right] = split(rest, len);
+        collect(middle, removed);
+        free_tree(middle);
+        root = merge(left, right);
+        return removed;
+    }
+
+    // Re-inserts previously cut pieces at pos (no text is copied)
+    void paste(std::size_t pos, const std::vector<Piece>& pieces) {
+        if (pieces.empty()) return;
+        std::uint32_t middle = 0;
+        for (const Piece& p : pieces) middle = merge(middle, make_node(p));
+        auto [left, right] = split(root, pos);
+        root = merge(merge(left, middle), right);
+    }
+
+    std::string substr(std::size_t pos, std::size_t len) const {
+        std::string out;
+        len = std::min(len, size() - std::min(pos, size()));
+        out.reserve(len);
+        append_range(root, pos, pos + len, out);
+        return out;
+    }
+
+    std::string text() const { return substr(0, size()); }
+
+    // Offset of the first character of `line` (0-based)
+    std::size_t line_start(std::size_t line) const {
+        if (line == 0) return 0;
+        line = std::min(line, line_count() - 1);
+        std::size_t base = 0;
+        std::uint32_t n = root;
+        while (n) {
+            const Node& node = nodes[n];
+            std::uint64_t left_lines = nodes[node.left].lines;
+            if (line <= left_lines) {
+                n = node.left;
+                continue;
+            }
+            line -= left_lines;
+            base += nodes[node.left].size;
+            if (line <= node.piece.lines) {
+                const auto& nl = newlines[node.piece.buffer];
+                auto first = std::lower_bound(nl.begin(), nl.end(), node.piece.start);
+                return base + (first[static_cast<std::ptrdiff_t>(line - 1)] - node.piece.start) + 1;
+            }
+            line -= node.piece.lines;
+            base += node.piece.length;
+            n = node.right;
+        }
+        return size();
+    }
+
+    // 0-based line containing offset `pos`
+    std::size_t line_of(std::size_t pos) const {
+        std::size_t lines = 0;
+        std::uint32_t n = root;
+        while (n) {
+            const Node& node = nodes[n];
+            std::uint64_t left_size = nodes[node.left].size;
+            if (pos < left_size) {
+                n = node.left;
+                continue;
+            }
+            pos -= left_size;
+            lines += nodes[node.left].lines;
+            if (pos < node.piece.length) {
+                return lines + count_newlines(node.piece.buffer, node.piece.start, node.piece.start + pos);
+            }
+            pos -= node.piece.length;
+            lines += node.piece.lines;
+            n = node.right;
+        }
+        return lines;
+    }
+
+    std::size_t piece_count() const { return count(root); }
+
+    static std::uint64_t length_of(const std::vector<Piece>& pieces) {
+        std::uint64_t total = 0;
+        for (const Piece& p : pieces) total += p.length;
+        return total;
+    }
+
+private:
+    struct Node {
+        Piece piece{};
+        std::uint32_t left = 0, right = 0;
+        std::uint32_t priority = 0;
+        std::uint64_t size = 0;    // subtree characters
+        std::uint64_t lines = 0;   // subtree newlines
+    };
+
+    Piece make_piece(std::uint8_t buffer, std::uint64_t start, std::uint64_t length) const {
+        return {start, length, count_newlines(buffer, start, start + length), buffer};
+    }
+
+    std::uint64_t count_newlines(std::uint8_t buffer, std::uint64_t lo, std::uint64_t hi) const {
+        const auto& nl = newlines[buffer];
+        return static_cast<std::uint64_t>(std::lower_bound(nl.begin(), nl.end(), hi) -
+                                          std::lower_bound(nl.begin(), nl.end(), lo));
+    }
+
+    void index_newlines(std::uint8_t buffer, std::uint64_t from) {
+        const std::string& b = buffers[buffer];
+        for (const char* p = b.data() + from; (p = static_cast<const char*>(
+                                                   std::memchr(p, '\n', b.data() + b.size() - p)));
+             ++p) {
+            newlines[buffer].push_back(static_cast<std::uint64_t>(p - b.data()));
+        }
+    }
+
+    std::uint32_t make_node(const Piece& p) {
+        std::uint32_t n;
+        if (free_nodes.empty()) {
+            n = static_cast<std::uint32_t>(nodes.size());
+            nodes.emplace_back();
+        } else {
+            n = free_nodes.back();
+            free_nodes.pop_back();
+        }
+        nodes[n] = Node{p, 0, 0, static_cast<std::uint32_t>(rng()), p.length, p.lines};
+        return n;
+    }
+
+    void update(std::uint32_t n) {
+        Node& node = nodes[n];
+        node.size = nodes[node.left].size + node.piece.length + nodes[node.right].size;
+        node.lines = nodes[node.left].lines + node.piece.lines + nodes[node.right].lines;
+    }
+
+    std::uint32_t merge(std::uint32_t a, std::uint32_t b) {
+        if (!a || !b) return a ? a : b;
+        if (nodes[a].priority > nodes[b].priority) {
+            nodes[a].right = merge(nodes[a].right, b);
+            update(a);
+            return a;
+        }
+        nodes[b].left = merge(a, nodes[b].left);
+        update(b);
+        return b;
+    }
+
+    // First `k` characters go left; a piece straddling k is split in two
+    std::pair<std::uint32_t, std::uint32_t> split(std::uint32_t n, std::uint64_t k) {
+        if (!n) return {0, 0};
+        std::uint64_t left_size = nodes[nodes[n].left].size;
+        std::uint64_t length = nodes[n].piece.length;
+
+        if (k <= left_size) {
+            auto [a, b] = split(nodes[n].left, k);
+            nodes[n].left = b;
+            update(n);
+            return {a, n};
+        }
+        if (k >= left_size + length) {
+            auto [a, b] = split(nodes[n].right, k - left_size - length);
+            nodes[n].right = a;
+            update(n);
+            return {n, b};
+        }
+
+        Piece p = nodes[n].piece;
+        std::uint64_t cut_at = k - left_size;
+        nodes[n].piece = make_piece(p.buffer, p.start, cut_at);
+        std::uint32_t tail = make_node(make_piece(p.buffer, p.start + cut_at, p.length - cut_at));
+        std::uint32_t right = nodes[n].right;
+        nodes[n].right = 0;
+        update(n);
+        return {n, merge(tail, right)};
+    }
+
+    std::uint32_t rightmost(std::uint32_t n) const {
+        while (n && nodes[n].right) n = nodes[n].right;
+        return n;
+    }
+
+    void extend_rightmost(std::uint32_t n, std::uint64_t length, std::uint64_t lines) {
+        while (n) {
+            nodes[n].size += length;
+            nodes[n].lines += lines;
+            if (!nodes[n].right) {
+                nodes[n].piece.length += length;
+                nodes[n].piece.lines += lines;
+            }
+            n = nodes[n].right;
+        }
+    }
+
+    void collect(std::uint32_t n, std::vector<Piece>& out) const {
+        if (!n) return;
+        collect(nodes[n].left, out);
+        out.push_back(nodes[n].piece);
+        collect(nodes[n].right, out);
+    }
+
+    void free_tree(std::uint32_t n) {
+        if (!n) return;
+        free_tree(nodes[n].left);
+        free_tree(nodes[n].right);
+        free_nodes.push_back(n);
+    }
+
+    std::size_t count(std::uint32_t n) const {
+        return n ? 1 + count(nodes[n].left) + count(nodes[n].right) : 0;
+    }
+
+    // Appends document range [lo, hi) (relative to this subtree) to out
+    void append_range(std::uint32_t n, std::uint64_t lo, std::uint64_t hi, std::string& out) const {
+        if (!n || lo >= hi) return;
+        const Node& node = nodes[n];
+        std::uint64_t left_size = nodes[node.left].size;
+        if (lo < left_size) append_range(node.left, lo, std::min(hi, left_size), out);
+
+        std::uint64_t piece_lo = left_size, piece_hi = left_size + node.piece.length;
+        std::uint64_t a = std::max(lo, piece_lo), b = std::min(hi, piece_hi);
+        if (a < b) out.append(buffers[node.piece.buffer], node.piece.start + (a - piece_lo), b - a);
+
+        if (hi > piece_hi) append_range(node.right, lo > piece_hi ? lo - piece_hi : 0, hi - piece_hi, out);
+    }
+
+    std::string buffers[2];
+    std::vector<std::uint64_t> newlines[2];
+    std::vector<Node> nodes;
+    std::vector<std::uint32_t> free_nodes;
+    std::uint32_t root = 0;
+    std::minstd_rand rng{12345};
+};
+
+
+// UNDO HISTORY AS PIECE DIFFS
+
+// "At offset, `inserted` characters replaced `removed`." Applying a record
+// returns its inverse, so undo and redo are the same operation.
+struct EditRecord {
+    std::uint64_t offset = 0;
+    std::uint64_t inserted = 0;
+    std::vector<Piece> removed;
+};
+
+class EditHistory {
+public:
+    void record_insert(std::uint64_t pos, std::uint64_t len, bool ends_line) {
+        redo_stack.clear();
+        if (open && !undo_stack.empty()) {
+            EditRecord& top = undo_stack.back();
+            if (top.removed.empty() && top.offset + top.inserted == pos) {
+                top.inserted += len;
+                open = !ends_line;   // a newline closes the typing group
+                return;
+            }
+        }
+        undo_stack.push_back({pos, len, {}});
+        open = !ends_line;
+    }
+
+    void record_erase(std::uint64_t pos, std::vector<Piece> pieces) {
+        redo_stack.clear();
+        if (open && !undo_stack.empty()) {
+            EditRecord& top = undo_stack.back();
+            // Backspace run: the new deletion ends where the previous one began
+            if (top.inserted == 0 && pos + PieceTable::length_of(pieces) == top.offset) {
+                pieces.insert(pieces.end(), top.removed.begin(), top.removed.end());
+                top.removed = std::move(pieces);
+                top.offset = pos;
+                return;
+            }
+        }
+        undo_stack.push_back({pos, 0, std::move(pieces)});
+        open = true;
+    }
+
+    // Cursor jumps, undo and redo end the current coalescing group
+    void seal() { open = false; }
+
+    // Returns the cursor position after the change, or -1 if nothing to do
+    std::int64_t undo(PieceTable& table) { return transfer(table, undo_stack, redo_stack); }
+    std::int64_t redo(PieceTable& table) { return transfer(table, redo_stack, undo_stack); }
+
+    std::size_t undo_depth() const { return undo_stack.size(); }
+
+    std::size_t memory_bytes() const {
+        std::size_t bytes = 0;
+        for (auto* stack : {&undo_stack, &redo_stack}) {
+            for (const auto& r : *stack) bytes += sizeof(EditRecord) + r.removed.capacity() * sizeof(Piece);
+        }
+        return bytes;
+    }
+
+private:
+    std::int64_t transfer(PieceTable& table, std::vector<EditRecord>& from, std::vector<EditRecord>& to) {
+        seal();
+        if (from.empty()) return -1;
+        EditRecord r = std::move(from.back());
+        from.pop_back();
+
+        EditRecord inverse{r.offset, PieceTable::length_of(r.removed), table.cut(r.offset, r.inserted)};
+        table.paste(r.offset, r.removed);
+        std::int64_t cursor = static_cast<std::int64_t>(r.offset + inverse.inserted);
+        to.push_back(std::move(inverse));
+        return cursor;
+    }
+
+    std::vector<EditRecord> undo_stack;
+    std::vector<EditRecord> redo_stack;
+    bool open = false;
+};
+
+
+// EDITOR (same surface as the refresher's TextEditor, without printing)
+
+class TextEditor {
+public:
+    explicit TextEditor(std::string text = {}) : table(std::move(text)) {}
+
+    void insert(std::string_view str) {
+        table.insert(cursor, str);
+        history.record_insert(cursor, str.size(), str.find('\n') != std::string_view::npos);
+        cursor += str.size();
+    }
+
+    // Backspace `count` characters before the cursor
+    void deleteChars(std::size_t count) {
+        count = std::min(count, cursor);
+        if (count == 0) return;
+        cursor -= count;
+        history.record_erase(cursor, table.cut(cursor, count));
+    }
+
+    void moveCursor(std::int64_t offset) {
+        std::int64_t pos = static_cast<std::int64_t>(cursor) + offset;
+        if (pos >= 0 && static_cast<std::size_t>(pos) <= table.size()) {
+            cursor = static_cast<std::size_t>(pos);
+            history.seal();
+        }
+    }
+
+    void gotoLine(std::size_t line, std::size_t column = 0) {
+        std::size_t start = table.line_start(line);
+        std::size_t end = line + 1 < table.line_count() ? table.line_start(line + 1) - 1 : table.size();
+        cursor = std::min(start + column, end);
+        history.seal();
+    }
+
+    bool undo() { return apply(history.undo(table)); }
+    bool redo() { return apply(history.redo(table)); }
+
+    std::string getText() const { return table.text(); }
+    std::string getLines(std::size_t first, std::size_t count) const {
+        std::size_t lo = table.line_start(first);
+        std::size_t hi = first + count < table.line_count() ? table.line_start(first + count) : table.size();
+        return table.substr(lo, hi - lo);
+    }
+
+    std::size_t getCursorPosition() const { return cursor; }
+    std::size_t lineCount() const { return table.line_count(); }
+    const PieceTable& buffer() const { return table; }
+    const EditHistory& undoHistory() const { return history; }
+
+private:
+    bool apply(std::int64_t new_cursor) {
+        if (new_cursor < 0) return false;
+        cursor = static_cast<std::size_t>(new_cursor);
+        return true;
+    }
+
+    PieceTable table;
+    EditHistory history;
+    std::size_t cursor = 0;
+};
+
+
+// BASELINE: std::string document with a cached line-start vector
+
+class StringEditor {
+public:
+    explicit StringEditor(std::string text) : text(std::move(text)) {
+        starts.push_back(0);
+        for (std::size_t i = 0; i < this->text.size(); ++i) {
+            if (this->text[i] == '\n') starts.push_back(i + 1);
+        }
+    }
+
+    void insert(std::string_view str) {
+        text.insert(cursor, str);
+        // Every later line start shifts: O(lines)
+        auto it = std::upper_bound(starts.begin(), starts.end(), cursor);
+        for (auto j = it; j != starts.end(); ++j) *j += str.size();
+        std::vector<std::size_t> added;
+        for (std::size_t i = 0; i < str.size(); ++i) {
+            if (str[i] == '\n') added.push_back(cursor + i + 1);
+        }
+        starts.insert(it, added.begin(), added.end());
+        cursor += str.size();
+    }
+
+    void deleteChars(std::size_t count) {
+        count = std::min(count, cursor);
+        if (count == 0) return;
+        std::size_t lo = cursor - count;
+        text.erase(lo, count);
+        auto first = std::upper_bound(starts.begin(), starts.end(), lo);
+        auto last = std::upper_bound(first, starts.end(), cursor);
+        for (auto j = last; j != starts.end(); ++j) *j -= count;
+        starts.erase(first, last);
+        cursor = lo;
+    }
+
+    void gotoLine(std::size_t line, std::size_t column = 0) {
+        line = std::min(line, starts.size() - 1);
+        std::size_t end = line + 1 < starts.size() ? starts[line + 1] - 1 : text.size();
+        cursor = std::min(starts[line] + column, end);
+    }
+
+    std::size_t lineCount() const { return starts.size(); }
+    const std::string& getText() const { return text; }
+
+private:
+    std::string text;
+    std::vector<std::size_t> starts;
+    std::size_t cursor = 0;
+};
+
+
+// EDITING TRACE
+
+struct Op {
+    enum Kind : std::uint8_t { GOTO, TYPE, BACKSPACE, UNDO, REDO, VIEW } kind;
+    std::uint32_t a = 0, b = 0;   // GOTO: line, column; TYPE: char; BACKSPACE: count
+};
+
+// Keystroke-level trace: jump somewhere, read a screen, type a few words
+// char by char with the odd correction, sometimes undo/redo
+std::vector<Op> make_trace(std::size_t sessions, std::size_t lines, bool with_undo, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::vector<Op> ops;
+    for (std::size_t s = 0; s < sessions; ++s) {
+        ops.push_back({Op::GOTO, static_cast<std::uint32_t>(rng() % lines), static_cast<std::uint32_t>(rng() % 40)});
+        ops.push_back({Op::VIEW, 0, 0});
+        for (int w = 1 + rng() % 3; w > 0; --w) {
+            for (int c = 3 + rng() % 7; c > 0; --c) ops.push_back({Op::TYPE, static_cast<std::uint32_t>('a' + rng() % 26), 0});
+            if (rng() % 5 == 0) {
+                for (int c = 1 + rng() % 3; c > 0; --c) ops.push_back({Op::BACKSPACE, 1, 0});
+            }
+            ops.push_back({Op::TYPE, rng() % 10 == 0 ? std::uint32_t('\n') : std::uint32_t(' '), 0});
+        }
+        if (with_undo && rng() % 10 == 0) {
+            for (int u = 1 + rng() % 3; u > 0; --u) ops.push_back({Op::UNDO, 0, 0});
+            if (rng() % 2) ops.push_back({Op::REDO, 0, 0});
+        }
+    }
+    return ops;
+}
+
+template<typename Editor>
+std::size_t replay(Editor& editor, const std::vector<Op>& ops, std::size_t limit = SIZE_MAX) {
+    std::size_t viewed = 0;
+    for (std::size_t i = 0; i < std::min(limit, ops.size()); ++i) {
+        const Op& op = ops[i];
+        switch (op.kind) {
+        case Op::GOTO: editor.gotoLine(op.a % editor.lineCount(), op.b); break;
+        case Op::TYPE: {
+            char c = static_cast<char>(op.a);
+            editor.insert(std::string_view(&c, 1));
+            break;
+        }
+        case Op::BACKSPACE: editor.deleteChars(op.a); break;
+        case Op::UNDO:
+            if constexpr (requires { editor.undo(); }) editor.undo();
+            break;
+        case Op::REDO:
+            if constexpr (requires { editor.redo(); }) editor.redo();
+            break;
+        case Op::VIEW:
+            if constexpr (requires { editor.getLines(0, 1); }) viewed += editor.getLines(op.a, 50).size();
+            break;
+        }
+    }
+    return viewed;
+}
+
+std::string make_document(std::size_t bytes, unsigned seed) {
+    static const char* words[] = {"piece", "table", "editor", "buffer", "undo", "redo", "cursor",
+                                  "line", "insert", "delete", "rope", "tree", "node", "text"};
+    std::mt19937 rng(seed);
+    std::string doc;
+    doc.reserve(bytes + 64);
+    while (doc.size() < bytes) {
+        for (int w = 4 + rng() % 8; w > 0; --w) {
+            doc += words[rng() % 14];
+            doc += ' ';
+        }
+        doc.back() = '\n';
+    }
+    return doc;
+}
+
+template<typename F>
+double time_s(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double> s = std::chrono::steady_clock::now() - start;
+    return s.count();
+}
+
+int main() {
+    std::cout.precision(4);
+
+    // Correctness on a small document against the string baseline
+    {
+        std::string doc = make_document(2 * 1024 * 1024, 1);
+        auto trace = make_trace(5000, 30000, false, 2);
+        TextEditor pt(doc);
+        StringEditor ref(doc);
+        replay(pt, trace);
+        replay(ref, trace);
+        bool same = pt.getText() == ref.getText() && pt.lineCount() == ref.lineCount();
+
+        auto undo_trace = make_trace(5000, 30000, true, 3);
+        TextEditor u(doc);
+        replay(u, undo_trace);
+        std::string final_text = u.getText();
+        while (u.undo()) {}
+        bool undone = u.getText() == doc;
+        while (u.redo()) {}
+        bool redone = u.getText() == final_text;
+
+        std::cout << "correctness: edits " << (same ? "match" : "MISMATCH") << ", undo-all "
+                  << (undone ? "restores original" : "FAILED") << ", redo-all "
+                  << (redone ? "restores final" : "FAILED") << "\n";
+    }
+
+    // 100 MB document, keystroke trace
+    std::string doc = make_document(100 * 1000 * 1000, 4);
+    std::size_t lines = std::count(doc.begin(), doc.end(), '\n') + 1;
+    auto trace = make_trace(50000, lines, true, 5);
+    std::cout << "document: " << doc.size() / 1e6 << " MB, " << lines << " lines; trace: " << trace.size()
+              << " operations\n";
+
+    TextEditor* editor = nullptr;
+    double load_s = time_s([&] { editor = new TextEditor(doc); });
+    double pt_s = time_s([&] { replay(*editor, trace); });
+    std::cout << "piece table:  load " << load_s * 1e3 << " ms, " << trace.size() / pt_s / 1e3
+              << " k ops/s (" << pt_s * 1e9 / trace.size() << " ns/op), " << editor->buffer().piece_count()
+              << " pieces\n";
+    std::cout << "undo history: " << editor->undoHistory().undo_depth() << " records in "
+              << editor->undoHistory().memory_bytes() / 1024 << " KB (coalesced from keystrokes)\n";
+    delete editor;
+
+    // The string baseline is O(document) per keystroke; time a prefix
+    StringEditor baseline(doc);
+    const std::size_t prefix = 2000;
+    double str_s = time_s([&] { replay(baseline, trace, prefix); });
+    std::cout << "std::string:  " << prefix / str_s / 1e3 << " k ops/s (" << str_s * 1e9 / prefix
+              << " ns/op, first " << prefix << " ops)\n";
+}
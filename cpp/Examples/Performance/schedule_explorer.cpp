@@ -0,0 +1,1181 @@
+// CONTROLLED-SCHEDULING CONCURRENCY TESTS
+//
+// DeterministicScheduler in Refreshers/25_testing.cpp starts its threads
+// together and joins them; which interleaving runs is still up to the OS,
+// so the race tests next to it find bugs by luck. Here the test owns the
+// schedule:
+//   - test threads are fibers (ucontext) on one OS thread. Only one runs at
+//     a time and switching is a user-space context swap, so one execution of
+//     a small test takes microseconds
+//   - sched::mutex, condition_variable, atomic<T> and thread behave like the
+//     std ones, but every visible operation is a schedule point where the
+//     strategy picks which thread goes next. sched::yield() marks a point in
+//     plain code (where the refresher sleeps to widen a race window)
+//   - strategies: random walk; PCT (random thread priorities plus d-1
+//     priority change points, which finds a depth-d bug with probability at
+//     least 1/(n k^(d-1)) per run); and DFS over all schedules with at most
+//     `preemption_bound` preemptions (CHESS-style), which ends once that
+//     space is exhausted. notify_one's choice of waiter is explored as well
+//   - failures: sched::check(), deadlock (nobody runnable), the step limit
+//     (livelock), thread leaks and uncaught exceptions. Each failure comes
+//     with its schedule, which replay() reruns step for step; for random
+//     and PCT the execution's seed reproduces it as well
+//
+// Code under test is written against a Sync policy (StdSync for real
+// threads, ExploreSync here), the way Relacy or CDSChecker tests are.
+// Atomics are modeled as sequentially consistent: this explores
+// interleavings, not weak-memory reorderings (use TSan for those).
+// A failed execution is abandoned mid-flight, so objects on the stacks of
+// its unfinished threads are not destroyed.
+//
+// Build: g++ -std=c++17 -O2 schedule_explorer.cpp -o schedule_explorer
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+namespace sched {
+
+// ============================================================================
+// STRATEGIES
+// ============================================================================
+
+enum class Strategy { Random, PCT, DFS, Replay };
+
+const char* strategy_name(Strategy s) {
+    switch (s) {
+        case Strategy::Random: return "random";
+        case Strategy::PCT: return "pct";
+        case Strategy::DFS: return "dfs";
+        case Strategy::Replay: return "replay";
+    }
+    return "?";
+}
+
+struct Options {
+    Strategy strategy = Strategy::Random;
+    uint64_t seed = 1;
+    size_t executions = 10000;  // upper bound; DFS may exhaust its space first
+    int pct_depth = 3;
+    size_t pct_length = 0;  // k, the expected schedule length; 0 learns it from earlier executions
+    int preemption_bound = 2;
+    size_t max_steps = 20000;  // schedule points per execution
+    size_t stack_size = 64 * 1024;
+};
+
+inline uint64_t mix(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+// Choices are indexes into the options the engine offers. Thread choices
+// come with the running thread, so a strategy can tell preemptions apart
+class Chooser {
+public:
+    virtual ~Chooser() = default;
+    virtual void begin(uint64_t /*execution_seed*/) {}
+    // options are thread ids (thread choice) or waiter positions
+    virtual size_t pick(const std::vector<int>& options, bool thread_choice, int running) = 0;
+    // Called after each execution; false when there is nothing left to run
+    virtual bool end(size_t /*decisions*/) { return true; }
+};
+
+class RandomChooser : public Chooser {
+public:
+    void begin(uint64_t seed) override { state_ = mix(seed); }
+    size_t pick(const std::vector<int>& options, bool, int) override { return next() % options.size(); }
+
+private:
+    uint64_t next() { return state_ = mix(state_); }
+    uint64_t state_ = 0;
+};
+
+// Burckhardt et al., "A Randomized Scheduler with Probabilistic Guarantees
+// of Finding Bugs" (ASPLOS 2010)
+class PctChooser : public Chooser {
+public:
+    PctChooser(int depth, size_t length)
+        : depth_(std::max(1, depth)), length_(length ? length : 16), learn_(length == 0) {}
+
+    void begin(uint64_t seed) override {
+        state_ = mix(seed);
+        priorities_.clear();
+        change_points_.clear();
+        for (int i = 0; i < depth_ - 1; ++i) change_points_.push_back(1 + next() % std::max<size_t>(1, length_));
+        decision_ = 0;
+    }
+
+    size_t pick(const std::vector<int>& options, bool thread_choice, int running) override {
+        if (!thread_choice) return next() % options.size();
+        ++decision_;
+        for (size_t i = 0; i < change_points_.size(); ++i) {
+            if (change_points_[i] == decision_ && running >= 0) priority(running) = i + 1;  // below every initial one
+        }
+        size_t best = 0;
+        for (size_t i = 1; i < options.size(); ++i)
+            if (priority(options[i]) > priority(options[best])) best = i;
+        return best;
+    }
+
+    bool end(size_t decisions) override {
+        if (learn_) length_ = std::max(length_, decisions);
+        return true;
+    }
+
+    size_t length() const { return length_; }
+
+private:
+    uint64_t& priority(int thread) {
+        while (priorities_.size() <= static_cast<size_t>(thread))
+            priorities_.push_back(static_cast<uint64_t>(depth_) + (next() >> 8));  // distinct with high probability
+        return priorities_[thread];
+    }
+    uint64_t next() { return state_ = mix(state_); }
+
+    int depth_;
+    uint64_t state_ = 0;
+    size_t length_;
+    bool learn_;
+    size_t decision_ = 0;
+    std::vector<uint64_t> priorities_;
+    std::vector<size_t> change_points_;
+};
+
+// Depth-first over every schedule with at most `bound` preemptions. The
+// stack holds each decision of the current execution; the next execution
+// replays the prefix and takes the next alternative at the deepest point
+// that has one
+class DfsChooser : public Chooser {
+public:
+    explicit DfsChooser(int bound) : bound_(bound) {}
+
+    void begin(uint64_t) override { depth_ = 0; }
+
+    size_t pick(const std::vector<int>& options, bool thread_choice, int running) override {
+        if (depth_ < stack_.size()) return stack_[depth_++].chosen;
+        Point p;
+        p.options = options;
+        p.thread_choice = thread_choice;
+        p.running = running;
+        p.preemptions_before = depth_ ? stack_[depth_ - 1].preemptions_after() : 0;
+        // Prefer continuing the running thread: no preemption
+        p.chosen = 0;
+        if (thread_choice)
+            for (size_t i = 0; i < options.size(); ++i)
+                if (options[i] == running) p.chosen = i;
+        p.first = p.chosen;
+        stack_.push_back(std::move(p));
+        ++depth_;
+        return stack_.back().chosen;
+    }
+
+    bool end(size_t) override {
+        stack_.resize(depth_);
+        while (!stack_.empty()) {
+            Point& p = stack_.back();
+            while (advance(p)) {
+                if (p.preemptions_after() <= bound_) return true;
+            }
+            stack_.pop_back();
+        }
+        return false;
+    }
+
+private:
+    struct Point {
+        std::vector<int> options;
+        bool thread_choice = true;
+        int running = -1;
+        int preemptions_before = 0;
+        size_t first = 0;   // tried first; the others follow in order
+        size_t chosen = 0;
+        size_t tried = 1;
+
+        bool preempts() const {
+            if (!thread_choice || options[chosen] == running) return false;
+            return std::find(options.begin(), options.end(), running) != options.end();
+        }
+        int preemptions_after() const { return preemptions_before + (preempts() ? 1 : 0); }
+    };
+
+    static bool advance(Point& p) {
+        if (p.tried >= p.options.size()) return false;
+        p.chosen = (p.first + p.tried++) % p.options.size();
+        return true;
+    }
+
+    int bound_;
+    std::vector<Point> stack_;
+    size_t depth_ = 0;
+};
+
+class ReplayChooser : public Chooser {
+public:
+    explicit ReplayChooser(std::vector<size_t> choices) : choices_(std::move(choices)) {}
+    void begin(uint64_t) override { at_ = 0; }
+    size_t pick(const std::vector<int>& options, bool, int) override {
+        size_t c = at_ < choices_.size() ? choices_[at_] : 0;
+        ++at_;
+        return c < options.size() ? c : 0;
+    }
+
+private:
+    std::vector<size_t> choices_;
+    size_t at_ = 0;
+};
+
+// Schedules as text: choice indexes, runs written as "index*count"
+std::string encode(const std::vector<size_t>& choices) {
+    std::ostringstream out;
+    for (size_t i = 0; i < choices.size();) {
+        size_t j = i;
+        while (j < choices.size() && choices[j] == choices[i]) ++j;
+        if (i) out << '.';
+        out << choices[i];
+        if (j - i > 1) out << '*' << (j - i);
+        i = j;
+    }
+    return out.str();
+}
+
+std::vector<size_t> decode(const std::string& text) {
+    std::vector<size_t> out;
+    std::istringstream in(text);
+    std::string run;
+    while (std::getline(in, run, '.')) {
+        if (run.empty()) continue;
+        size_t star = run.find('*');
+        size_t value = std::stoul(run.substr(0, star));
+        size_t count = star == std::string::npos ? 1 : std::stoul(run.substr(star + 1));
+        out.insert(out.end(), count, value);
+    }
+    return out;
+}
+
+// ============================================================================
+// ENGINE
+// ============================================================================
+
+struct Failure {
+    std::string message;
+    std::string schedule;  // for replay()
+    uint64_t seed = 0;     // execution seed (random, PCT)
+    size_t pct_length = 0; // k in force for that execution (PCT)
+    size_t execution = 0;
+};
+
+struct Report {
+    Strategy strategy = Strategy::Random;
+    size_t executions = 0;
+    double seconds = 0;
+    bool exhausted = false;  // DFS explored its whole bounded space
+    size_t longest = 0;      // most schedule points in one execution
+    std::optional<Failure> failure;
+};
+
+class Engine;
+Engine* g_engine = nullptr;
+
+class Engine {
+public:
+    explicit Engine(const Options& options) : options_(options) {}
+
+    ~Engine() {
+        for (auto& f : fibers_) ::munmap(f->stack, f->stack_bytes);
+    }
+
+    Engine(const Engine&) = delete;
+    Engine& operator=(const Engine&) = delete;
+
+    // Runs `test` as thread 0 until every thread finished or a failure
+    std::optional<std::string> execute(const std::function<void()>& test, Chooser& chooser, uint64_t seed) {
+        chooser_ = &chooser;
+        chooser.begin(seed);
+        live_ = 0;
+        steps_ = 0;
+        choices_.clear();
+        failure_.reset();
+        for (auto& f : fibers_) f->state = State::Unused;
+        spawn(test);
+        current_ = 0;
+        Engine* outer = std::exchange(g_engine, this);
+        ::swapcontext(&main_, &fibers_[0]->context);
+        g_engine = outer;
+        return failure_;
+    }
+
+    const std::vector<size_t>& choices() const { return choices_; }
+    size_t steps() const { return steps_; }
+
+    // ---- used by the primitives ----
+
+    int current() const { return current_; }
+
+    int spawn(std::function<void()> fn) {
+        size_t id = 0;
+        while (id < fibers_.size() && fibers_[id]->state != State::Unused) ++id;
+        if (id == fibers_.size()) fibers_.push_back(make_fiber());
+        Fiber& f = *fibers_[id];
+        f.fn = std::move(fn);
+        f.state = State::Runnable;
+        f.waiting_on = nullptr;
+        prepare(f);
+        ++live_;
+        return static_cast<int>(id);
+    }
+
+    // Lets the strategy switch threads before a visible operation
+    void schedule_point() {
+        if (++steps_ > options_.max_steps) fail("step limit reached (livelock, or raise max_steps)");
+        runnable_.clear();
+        for (size_t i = 0; i < fibers_.size(); ++i)
+            if (fibers_[i]->state == State::Runnable) runnable_.push_back(static_cast<int>(i));
+        int next = choose_thread();
+        if (next != current_) switch_to(next);
+    }
+
+    // The running thread cannot continue until wake() picks it
+    void block(const void* on, const char* what) {
+        Fiber& f = *fibers_[current_];
+        f.state = State::Blocked;
+        f.waiting_on = on;
+        f.blocked_in = what;
+        reschedule();
+    }
+
+    void wake_all(const void* on) {
+        for (auto& f : fibers_)
+            if (f->state == State::Blocked && f->waiting_on == on) f->state = State::Runnable;
+    }
+
+    // Which waiter wakes is a decision, explored like thread choices
+    bool wake_one(const void* on) {
+        std::vector<int> waiters;
+        for (size_t i = 0; i < fibers_.size(); ++i)
+            if (fibers_[i]->state == State::Blocked && fibers_[i]->waiting_on == on) waiters.push_back(static_cast<int>(i));
+        if (waiters.empty()) return false;
+        size_t c = waiters.size() == 1 ? 0 : decide(waiters, false);
+        fibers_[waiters[c]]->state = State::Runnable;
+        return true;
+    }
+
+    bool finished(int thread) const { return fibers_[thread]->state == State::Finished; }
+
+    // What joiners of `thread` block on; a finishing thread wakes it
+    const void* fiber_key(int thread) const { return fibers_[thread].get(); }
+
+    [[noreturn]] void fail(const std::string& message) {
+        if (!failure_) failure_ = message;
+        ::swapcontext(&fibers_[current_]->context, &main_);  // abandoned: never resumed
+        std::abort();
+    }
+
+private:
+    enum class State { Unused, Runnable, Blocked, Finished };
+
+    struct Fiber {
+        ucontext_t context;
+        char* stack = nullptr;
+        size_t stack_bytes = 0;
+        std::function<void()> fn;
+        State state = State::Unused;
+        const void* waiting_on = nullptr;
+        const char* blocked_in = "";
+    };
+
+    static size_t page_size() {
+        static const size_t size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        return size;
+    }
+
+    // Stacks are mapped once and reused by later executions. The lowest
+    // page is a guard, so an overflow faults instead of corrupting memory
+    std::unique_ptr<Fiber> make_fiber() {
+        auto f = std::make_unique<Fiber>();
+        f->stack_bytes = options_.stack_size + page_size();
+        void* p = ::mmap(nullptr, f->stack_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) throw std::runtime_error("cannot map a fiber stack");
+        ::mprotect(p, page_size(), PROT_NONE);
+        f->stack = static_cast<char*>(p);
+        return f;
+    }
+
+    // Out of line: getcontext returns twice, which spawn() should not see
+    __attribute__((noinline)) static void prepare(Fiber& f) {
+        ::getcontext(&f.context);
+        f.context.uc_stack.ss_sp = f.stack + page_size();  // above the guard page
+        f.context.uc_stack.ss_size = f.stack_bytes - page_size();
+        f.context.uc_link = nullptr;
+        ::makecontext(&f.context, &Engine::trampoline, 0);
+    }
+
+    static void trampoline() {
+        Engine& e = *g_engine;
+        Fiber& self = *e.fibers_[e.current_];
+        try {
+            self.fn();
+        } catch (const std::exception& ex) {
+            e.fail(std::string("uncaught exception: ") + ex.what());
+        } catch (...) {
+            e.fail("uncaught exception");
+        }
+        self.fn = nullptr;
+        self.state = State::Finished;
+        --e.live_;
+        e.wake_all(&self);  // joiners
+        e.reschedule();
+    }
+
+    // The running thread blocked or finished: somebody else must run
+    void reschedule() {
+        if (++steps_ > options_.max_steps) fail("step limit reached (livelock, or raise max_steps)");
+        runnable_.clear();
+        for (size_t i = 0; i < fibers_.size(); ++i)
+            if (fibers_[i]->state == State::Runnable) runnable_.push_back(static_cast<int>(i));
+        if (runnable_.empty()) {
+            if (live_ == 0) {
+                ::swapcontext(&fibers_[current_]->context, &main_);  // execution complete
+                std::abort();
+            }
+            std::ostringstream why;
+            why << "deadlock:";
+            const char* sep = " ";
+            for (size_t i = 0; i < fibers_.size(); ++i) {
+                if (fibers_[i]->state != State::Blocked) continue;
+                why << sep << "thread " << i << " in " << fibers_[i]->blocked_in;
+                sep = ", ";
+            }
+            fail(why.str());
+        }
+        switch_to(choose_thread());
+    }
+
+    int choose_thread() {
+        if (runnable_.size() == 1) return runnable_[0];
+        return runnable_[decide(runnable_, true)];
+    }
+
+    size_t decide(const std::vector<int>& options, bool thread_choice) {
+        size_t c = chooser_->pick(options, thread_choice, current_);
+        choices_.push_back(c);
+        return c;
+    }
+
+    void switch_to(int next) {
+        int prev = std::exchange(current_, next);
+        ::swapcontext(&fibers_[prev]->context, &fibers_[next]->context);
+    }
+
+    Options options_;
+    Chooser* chooser_ = nullptr;
+    std::vector<std::unique_ptr<Fiber>> fibers_;
+    std::vector<int> runnable_;
+    std::vector<size_t> choices_;
+    ucontext_t main_;
+    int current_ = 0;
+    size_t live_ = 0;
+    size_t steps_ = 0;
+    std::optional<std::string> failure_;
+};
+
+inline Engine& engine() {
+    if (!g_engine) {
+        std::cerr << "sched primitive used outside sched::explore\n";
+        std::abort();
+    }
+    return *g_engine;
+}
+
+// ============================================================================
+// PRIMITIVES
+// ============================================================================
+
+inline void yield() { engine().schedule_point(); }
+
+[[noreturn]] inline void fail(const std::string& message) { engine().fail(message); }
+
+inline void check(bool ok, const char* what) {
+    if (!ok) engine().fail(std::string("check failed: ") + what);
+}
+
+class thread {
+public:
+    thread() = default;
+
+    template<typename F>
+    explicit thread(F&& f) {
+        Engine& e = engine();
+        id_ = e.spawn(std::function<void()>(std::forward<F>(f)));
+        e.schedule_point();  // the new thread may run first
+    }
+
+    thread(thread&& other) noexcept : id_(std::exchange(other.id_, -1)) {}
+    thread& operator=(thread&& other) noexcept {
+        if (joinable()) engine().fail("thread assigned over a joinable thread");
+        id_ = std::exchange(other.id_, -1);
+        return *this;
+    }
+
+    ~thread() {
+        if (joinable()) engine().fail("thread destroyed without join");
+    }
+
+    bool joinable() const { return id_ >= 0; }
+
+    void join() {
+        Engine& e = engine();
+        e.schedule_point();
+        while (!e.finished(id_)) e.block(e.fiber_key(id_), "thread::join");
+        id_ = -1;
+    }
+
+private:
+    int id_ = -1;
+};
+
+class mutex {
+public:
+    mutex() = default;
+    mutex(const mutex&) = delete;
+    mutex& operator=(const mutex&) = delete;
+
+    void lock() {
+        Engine& e = engine();
+        e.schedule_point();
+        while (owner_ >= 0) {
+            if (owner_ == e.current()) e.fail("mutex locked twice by the same thread");
+            e.block(this, "mutex::lock");
+        }
+        owner_ = e.current();
+    }
+
+    bool try_lock() {
+        Engine& e = engine();
+        e.schedule_point();
+        if (owner_ >= 0) return false;
+        owner_ = e.current();
+        return true;
+    }
+
+    void unlock() {
+        Engine& e = engine();
+        e.schedule_point();
+        release(e);
+    }
+
+private:
+    friend class condition_variable;
+
+    void release(Engine& e) {
+        if (owner_ != e.current()) e.fail("mutex unlocked by a thread that does not own it");
+        owner_ = -1;
+        e.wake_all(this);  // they race for it again
+    }
+
+    int owner_ = -1;
+};
+
+class condition_variable {
+public:
+    void wait(std::unique_lock<mutex>& lock) {
+        Engine& e = engine();
+        e.schedule_point();
+        lock.mutex()->release(e);  // atomically with starting to wait
+        e.block(this, "condition_variable::wait");
+        lock.mutex()->lock();
+    }
+
+    template<typename Predicate>
+    void wait(std::unique_lock<mutex>& lock, Predicate pred) {
+        while (!pred()) wait(lock);
+    }
+
+    void notify_one() {
+        Engine& e = engine();
+        e.schedule_point();
+        e.wake_one(this);
+    }
+
+    void notify_all() {
+        Engine& e = engine();
+        e.schedule_point();
+        e.wake_all(this);
+    }
+};
+
+// Sequentially consistent model of std::atomic: the memory orders are
+// accepted and ignored, and compare_exchange_weak never fails spuriously
+template<typename T>
+class atomic {
+public:
+    atomic() = default;
+    constexpr atomic(T value) : value_(value) {}
+    atomic(const atomic&) = delete;
+    atomic& operator=(const atomic&) = delete;
+
+    T load(std::memory_order = std::memory_order_seq_cst) const {
+        engine().schedule_point();
+        return value_;
+    }
+
+    void store(T value, std::memory_order = std::memory_order_seq_cst) {
+        engine().schedule_point();
+        value_ = value;
+    }
+
+    T exchange(T value, std::memory_order = std::memory_order_seq_cst) {
+        engine().schedule_point();
+        return std::exchange(value_, value);
+    }
+
+    bool compare_exchange_strong(T& expected, T desired, std::memory_order = std::memory_order_seq_cst,
+                                 std::memory_order = std::memory_order_seq_cst) {
+        engine().schedule_point();
+        if (value_ == expected) {
+            value_ = desired;
+            return true;
+        }
+        expected = value_;
+        return false;
+    }
+
+    bool compare_exchange_weak(T& expected, T desired, std::memory_order success = std::memory_order_seq_cst,
+                               std::memory_order failure = std::memory_order_seq_cst) {
+        return compare_exchange_strong(expected, desired, success, failure);
+    }
+
+    T fetch_add(T delta, std::memory_order = std::memory_order_seq_cst) {
+        engine().schedule_point();
+        T old = value_;
+        value_ = static_cast<T>(value_ + delta);
+        return old;
+    }
+
+    T fetch_sub(T delta, std::memory_order = std::memory_order_seq_cst) {
+        engine().schedule_point();
+        T old = value_;
+        value_ = static_cast<T>(value_ - delta);
+        return old;
+    }
+
+    operator T() const { return load(); }
+    T operator=(T value) {
+        store(value);
+        return value;
+    }
+    T operator++() { return fetch_add(1) + 1; }
+    T operator--() { return fetch_sub(1) - 1; }
+
+private:
+    T value_{};
+};
+
+// ============================================================================
+// EXPLORATION
+// ============================================================================
+
+Report explore(const std::function<void()>& test, const Options& options) {
+    std::unique_ptr<Chooser> chooser;
+    switch (options.strategy) {
+        case Strategy::Random: chooser = std::make_unique<RandomChooser>(); break;
+        case Strategy::PCT: chooser = std::make_unique<PctChooser>(options.pct_depth, options.pct_length); break;
+        case Strategy::DFS: chooser = std::make_unique<DfsChooser>(options.preemption_bound); break;
+        case Strategy::Replay: throw std::invalid_argument("use replay()");
+    }
+    Engine engine(options);
+    Report report;
+    report.strategy = options.strategy;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < options.executions; ++i) {
+        uint64_t seed = options.seed + i;
+        auto failure = engine.execute(test, *chooser, seed);
+        ++report.executions;
+        report.longest = std::max(report.longest, engine.steps());
+        if (failure) {
+            auto* pct = dynamic_cast<PctChooser*>(chooser.get());
+            report.failure = Failure{*failure, encode(engine.choices()), seed, pct ? pct->length() : 0, i};
+            break;
+        }
+        if (!chooser->end(engine.choices().size())) {
+            report.exhausted = true;
+            break;
+        }
+    }
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+// Reruns one schedule printed in a Failure
+std::optional<std::string> replay(const std::function<void()>& test, const std::string& schedule,
+                                  const Options& options = {}) {
+    Engine engine(options);
+    ReplayChooser chooser(decode(schedule));
+    return engine.execute(test, chooser, 0);
+}
+
+} // namespace sched
+
+// ============================================================================
+// CODE UNDER TEST (ports of the refresher's classes)
+// ============================================================================
+
+struct StdSync {
+    template<typename T> using atomic = std::atomic<T>;
+    using mutex = std::mutex;
+    using condition_variable = std::condition_variable;
+    using thread = std::thread;
+    static void yield() { std::this_thread::yield(); }
+};
+
+struct ExploreSync {
+    template<typename T> using atomic = sched::atomic<T>;
+    using mutex = sched::mutex;
+    using condition_variable = sched::condition_variable;
+    using thread = sched::thread;
+    static void yield() { sched::yield(); }
+};
+
+template<typename Sync>
+class NonDeterministicCounter {
+    int value = 0;
+
+public:
+    void increment() {
+        int temp = value;
+        Sync::yield();  // the refresher sleeps here
+        value = temp + 1;
+    }
+    int get() const { return value; }
+};
+
+template<typename Sync>
+class MutexCounter {
+    int value = 0;
+    mutable typename Sync::mutex mtx;
+
+public:
+    void increment() {
+        std::lock_guard<typename Sync::mutex> lock(mtx);
+        ++value;
+    }
+    int get() const {
+        std::lock_guard<typename Sync::mutex> lock(mtx);
+        return value;
+    }
+};
+
+template<typename Sync>
+class AtomicCounter {
+    typename Sync::template atomic<int> value{0};
+
+public:
+    void increment() { value.fetch_add(1, std::memory_order_relaxed); }
+    int get() const { return value.load(std::memory_order_relaxed); }
+};
+
+template<typename Sync>
+class ProducerConsumer {
+    std::queue<int> queue;
+    mutable typename Sync::mutex mtx;
+    typename Sync::condition_variable cv;
+    bool done = false;
+    const size_t max_size;
+
+public:
+    explicit ProducerConsumer(size_t max_size) : max_size(max_size) {}
+
+    void produce(int value) {
+        std::unique_lock<typename Sync::mutex> lock(mtx);
+        cv.wait(lock, [this] { return queue.size() < max_size || done; });
+        if (!done) {
+            queue.push(value);
+            cv.notify_all();
+        }
+    }
+
+    std::optional<int> consume() {
+        std::unique_lock<typename Sync::mutex> lock(mtx);
+        cv.wait(lock, [this] { return !queue.empty() || done; });
+        if (!queue.empty()) {
+            int value = queue.front();
+            queue.pop();
+            cv.notify_all();
+            return value;
+        }
+        return std::nullopt;
+    }
+
+    void finish() {
+        std::lock_guard<typename Sync::mutex> lock(mtx);
+        done = true;
+        cv.notify_all();
+    }
+
+    size_t size() const {
+        std::lock_guard<typename Sync::mutex> lock(mtx);
+        return queue.size();
+    }
+};
+
+template<typename Sync>
+class BankAccount {
+    typename Sync::template atomic<int> balance{0};
+
+public:
+    void deposit(int amount) { balance.fetch_add(amount, std::memory_order_release); }
+
+    bool withdraw(int amount) {
+        int current = balance.load(std::memory_order_acquire);
+        while (current >= amount) {
+            if (balance.compare_exchange_weak(current, current - amount, std::memory_order_release,
+                                              std::memory_order_acquire))
+                return true;
+        }
+        return false;
+    }
+
+    int getBalance() const { return balance.load(std::memory_order_acquire); }
+
+    // Not atomic as a whole: between the two steps the money is nowhere
+    bool transfer(BankAccount& to, int amount) {
+        if (withdraw(amount)) {
+            to.deposit(amount);
+            return true;
+        }
+        return false;
+    }
+};
+
+template<typename Sync>
+class Philosopher {
+    typename Sync::mutex& left_fork;
+    typename Sync::mutex& right_fork;
+    int meals = 0;
+
+public:
+    Philosopher(typename Sync::mutex& left, typename Sync::mutex& right) : left_fork(left), right_fork(right) {}
+
+    void eat() {
+        std::lock_guard<typename Sync::mutex> left_lock(left_fork);
+        Sync::yield();  // the refresher sleeps here
+        std::lock_guard<typename Sync::mutex> right_lock(right_fork);
+        ++meals;
+    }
+
+    void eat_safely() {
+        std::unique_lock<typename Sync::mutex> left_lock(left_fork, std::defer_lock);
+        std::unique_lock<typename Sync::mutex> right_lock(right_fork, std::defer_lock);
+        std::lock(left_lock, right_lock);
+        ++meals;
+    }
+
+    int getMeals() const { return meals; }
+};
+
+// Treiber stack over a fixed node pool. A popped node belongs to the popper,
+// who may push it again at once: with no safe memory reclamation that is the
+// ABA setup. Tagged packs a modification count next to the head index so a
+// stale compare-exchange fails
+template<typename Sync, bool Tagged>
+class PoolStack {
+public:
+    static constexpr uint32_t kNil = 0xffffffffu;
+
+    explicit PoolStack(size_t capacity) : nodes_(capacity) {}
+
+    void push(uint32_t node, int value) {
+        nodes_[node].value = value;
+        uint64_t head = head_.load();
+        do {
+            nodes_[node].next.store(index(head));
+        } while (!head_.compare_exchange_weak(head, successor(head, node)));
+    }
+
+    // Returns the popped node, or kNil when empty
+    uint32_t pop() {
+        uint64_t head = head_.load();
+        while (index(head) != kNil) {
+            uint32_t next = nodes_[index(head)].next.load();
+            if (head_.compare_exchange_weak(head, successor(head, next))) return index(head);
+        }
+        return kNil;
+    }
+
+    int value(uint32_t node) const { return nodes_[node].value; }
+
+private:
+    struct Node {
+        typename Sync::template atomic<uint32_t> next{kNil};
+        int value = 0;
+    };
+
+    static uint32_t index(uint64_t head) { return static_cast<uint32_t>(head); }
+    static uint64_t successor(uint64_t head, uint32_t node) {
+        return Tagged ? (((head >> 32) + 1) << 32) | node : node;
+    }
+
+    std::vector<Node> nodes_;
+    typename Sync::template atomic<uint64_t> head_{kNil};
+};
+
+// ============================================================================
+// TESTS
+// ============================================================================
+
+template<typename Counter>
+std::function<void()> counter_test(int threads, int increments) {
+    return [=] {
+        Counter counter;
+        std::vector<sched::thread> workers;
+        for (int t = 0; t < threads; ++t)
+            workers.emplace_back([&] {
+                for (int i = 0; i < increments; ++i) counter.increment();
+            });
+        for (auto& w : workers) w.join();
+        if (counter.get() != threads * increments)
+            sched::fail("lost update: expected " + std::to_string(threads * increments) + ", got " +
+                        std::to_string(counter.get()));
+    };
+}
+
+// finish_after_join reproduces the refresher's order: finish() only after
+// every task, consumers included, has been joined
+std::function<void()> producer_consumer_test(bool finish_after_join) {
+    return [=] {
+        const int producers = 2, consumers = 2, items = 3;
+        ProducerConsumer<ExploreSync> pc(2);
+        std::vector<int> consumed;
+        sched::mutex consumed_mtx;
+        std::vector<sched::thread> producer_threads, consumer_threads;
+        for (int p = 0; p < producers; ++p)
+            producer_threads.emplace_back([&pc, p] {
+                for (int j = 0; j < items; ++j) pc.produce(p * 1000 + j);
+            });
+        for (int c = 0; c < consumers; ++c)
+            consumer_threads.emplace_back([&] {
+                while (auto item = pc.consume()) {
+                    std::lock_guard<sched::mutex> lock(consumed_mtx);
+                    consumed.push_back(*item);
+                }
+            });
+        for (auto& t : producer_threads) t.join();
+        if (finish_after_join) {
+            for (auto& t : consumer_threads) t.join();
+            pc.finish();
+        } else {
+            pc.finish();
+            for (auto& t : consumer_threads) t.join();
+        }
+        sched::check(consumed.size() == static_cast<size_t>(producers * items), "every item consumed");
+        sched::check(pc.size() == 0, "queue drained");
+        std::sort(consumed.begin(), consumed.end());
+        sched::check(std::adjacent_find(consumed.begin(), consumed.end()) == consumed.end(), "no duplicates");
+    };
+}
+
+// with_auditor adds a thread that sums the balances while transfers run
+std::function<void()> bank_test(bool with_auditor) {
+    return [=] {
+        const int accounts_n = 3, initial = 100;
+        BankAccount<ExploreSync> accounts[accounts_n];
+        for (auto& a : accounts) a.deposit(initial);
+        std::vector<sched::thread> threads;
+        for (int i = 0; i < 2; ++i)
+            threads.emplace_back([&accounts, i] {
+                for (int j = 0; j < 2; ++j) accounts[i].transfer(accounts[(i + 1) % accounts_n], 30 + 10 * j);
+            });
+        if (with_auditor)
+            threads.emplace_back([&accounts] {
+                int total = 0;
+                for (auto& a : accounts) total += a.getBalance();
+                if (total != accounts_n * initial) sched::fail("auditor saw a total of " + std::to_string(total));
+            });
+        for (auto& t : threads) t.join();
+        int total = 0;
+        for (auto& a : accounts) {
+            sched::check(a.getBalance() >= 0, "no negative balance");
+            total += a.getBalance();
+        }
+        sched::check(total == accounts_n * initial, "money conserved");
+    };
+}
+
+std::function<void()> philosophers_test(bool safely) {
+    return [=] {
+        const int n = 3;
+        std::vector<sched::mutex> forks(n);
+        std::vector<Philosopher<ExploreSync>> philosophers;
+        for (int i = 0; i < n; ++i) philosophers.emplace_back(forks[i], forks[(i + 1) % n]);
+        std::vector<sched::thread> threads;
+        for (int i = 0; i < n; ++i)
+            threads.emplace_back([&philosophers, i, safely] {
+                for (int meal = 0; meal < 2; ++meal) safely ? philosophers[i].eat_safely() : philosophers[i].eat();
+            });
+        for (auto& t : threads) t.join();
+        for (auto& p : philosophers) sched::check(p.getMeals() == 2, "every philosopher ate twice");
+    };
+}
+
+// Starts as 1 2 3 (top first). One thread pops once; the other pops twice
+// and pushes 4 and 5 into the nodes it got back. Every value must come out
+// exactly once
+template<bool Tagged>
+std::function<void()> stack_test() {
+    return [] {
+        using Stack = PoolStack<ExploreSync, Tagged>;
+        Stack stack(3);
+        for (int v = 3; v >= 1; --v) stack.push(static_cast<uint32_t>(v - 1), v);
+        std::vector<int> popped;
+        sched::thread a([&] {
+            uint32_t node = stack.pop();
+            if (node != Stack::kNil) popped.push_back(stack.value(node));
+        });
+        sched::thread b([&] {
+            std::vector<uint32_t> free_nodes;
+            for (int i = 0; i < 2; ++i) {
+                uint32_t node = stack.pop();
+                if (node == Stack::kNil) continue;
+                popped.push_back(stack.value(node));
+                free_nodes.push_back(node);
+            }
+            int value = 4;
+            for (uint32_t node : free_nodes) stack.push(node, value++);
+        });
+        a.join();
+        b.join();
+        for (int i = 0; i < 8; ++i) {  // bounded: a corrupted stack may be cyclic
+            uint32_t node = stack.pop();
+            if (node == Stack::kNil) break;
+            popped.push_back(stack.value(node));
+        }
+        std::sort(popped.begin(), popped.end());
+        if (popped != std::vector<int>{1, 2, 3, 4, 5}) {
+            std::string got;
+            for (int v : popped) got += std::to_string(v) + " ";
+            sched::fail("stack lost or duplicated values: popped " + got);
+        }
+    };
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+void check(bool ok, const std::string& what) {
+    if (!ok) {
+        std::cerr << "CHECK FAILED: " << what << "\n";
+        std::exit(1);
+    }
+}
+
+struct Case {
+    const char* name;
+    std::function<void()> test;
+    bool has_bug;
+};
+
+int main() {
+    std::cout << "Controlled-scheduling concurrency tests\n\n";
+
+    // The same classes still run on real threads
+    {
+        MutexCounter<StdSync> mutex_counter;
+        AtomicCounter<StdSync> atomic_counter;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+            threads.emplace_back([&] {
+                for (int i = 0; i < 10000; ++i) {
+                    mutex_counter.increment();
+                    atomic_counter.increment();
+                }
+            });
+        for (auto& t : threads) t.join();
+        check(mutex_counter.get() == 40000 && atomic_counter.get() == 40000, "StdSync counters");
+        std::cout << "StdSync: MutexCounter and AtomicCounter correct on 4 OS threads\n\n";
+    }
+
+    std::vector<Case> cases = {
+        {"NonDeterministicCounter 2x2", counter_test<NonDeterministicCounter<ExploreSync>>(2, 2), true},
+        {"MutexCounter 3x2", counter_test<MutexCounter<ExploreSync>>(3, 2), false},
+        {"AtomicCounter 3x2", counter_test<AtomicCounter<ExploreSync>>(3, 2), false},
+        {"ProducerConsumer, refresher order", producer_consumer_test(true), true},
+        {"ProducerConsumer, finish first", producer_consumer_test(false), false},
+        {"BankAccount transfers", bank_test(false), false},
+        {"BankAccount + auditor", bank_test(true), true},
+        {"Philosophers eat()", philosophers_test(false), true},
+        {"Philosophers eat_safely()", philosophers_test(true), false},
+        {"PoolStack untagged", stack_test<false>(), true},
+        {"PoolStack tagged", stack_test<true>(), false},
+    };
+
+    const sched::Strategy strategies[] = {sched::Strategy::Random, sched::Strategy::PCT, sched::Strategy::DFS};
+
+    std::cout << std::left << std::setw(36) << "test" << std::setw(8) << "strategy" << std::right << std::setw(10)
+              << "execs" << std::setw(12) << "execs/s" << std::setw(7) << "steps" << "  result\n";
+    std::vector<sched::Failure> examples;
+    for (const Case& c : cases) {
+        bool found_by_dfs = false;
+        for (sched::Strategy strategy : strategies) {
+            sched::Options options;
+            options.strategy = strategy;
+            options.seed = 42;
+            options.executions = strategy == sched::Strategy::DFS ? 200000 : 20000;
+            sched::Report report = sched::explore(c.test, options);
+
+            std::cout << std::left << std::setw(36) << c.name << std::setw(8) << sched::strategy_name(strategy)
+                      << std::right << std::setw(10) << report.executions << std::setw(12) << std::fixed
+                      << std::setprecision(0) << report.executions / std::max(report.seconds, 1e-9) << std::setw(7)
+                      << report.longest << "  ";
+            if (report.failure) {
+                std::cout << "FOUND after " << report.executions << ": " << report.failure->message << "\n";
+                check(c.has_bug, std::string(c.name) + ": unexpected failure " + report.failure->message);
+                auto again = sched::replay(c.test, report.failure->schedule);
+                check(again && *again == report.failure->message, std::string(c.name) + ": replay differs");
+                if (strategy != sched::Strategy::DFS) {
+                    sched::Options rerun = options;
+                    rerun.seed = report.failure->seed;
+                    rerun.pct_length = report.failure->pct_length;
+                    rerun.executions = 1;
+                    auto by_seed = sched::explore(c.test, rerun);
+                    check(by_seed.failure && by_seed.failure->message == report.failure->message,
+                          std::string(c.name) + ": seed does not reproduce");
+                }
+                if (strategy == sched::Strategy::DFS) {
+                    found_by_dfs = true;
+                    examples.push_back(*report.failure);
+                }
+            } else {
+                std::cout << (report.exhausted ? "pass (bounded space exhausted)" : "pass") << "\n";
+            }
+        }
+        check(found_by_dfs == c.has_bug, std::string(c.name) + ": DFS verdict");
+    }
+
+    std::cout << "\nEvery failure above replayed from its schedule (and random/PCT from the\n"
+                 "execution seed) with the same message. Schedules found by DFS:\n";
+    for (const auto& f : examples) std::cout << "  " << f.schedule << "\n    -> " << f.message << "\n";
+    return 0;
+}
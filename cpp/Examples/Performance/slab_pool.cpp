@@ -0,0 +1,485 @@
+// SIZE-CLASS SLAB POOL WITH THREAD CACHES
+//
+// The MemoryPool behind the custom-deleter example in
+// Refreshers/13_smart_pointers.cpp calls malloc per allocation, records
+// every pointer in a vector, and finds and erases it on each free, so
+// deallocate is O(live objects). This pool:
+//   - rounds requests of 8 B .. 4 KB up to one of 18 size classes. Larger
+//     requests go to operator new.
+//   - carves each class out of 64 KB slabs aligned to 64 KB. A slab's
+//     first bytes are a header {owning pool, size class}, so a pointer
+//     finds its pool and class by masking off the low 16 bits. Free is
+//     O(1), and a deleter needs no state.
+//   - gives each thread a per-class free list. Allocate and free touch only
+//     that list; they go to the shared per-class list (one lock) in batches
+//     when it runs empty or grows past twice the batch size.
+//   - provides pool_unique_ptr<T> / pool_make_unique<T> (placement
+//     construct, destroy then free) and pool_make_shared<T> (allocate_shared
+//     through the pool, so the control block and the T share one block)
+//
+// Slabs are kept until the pool and every thread that cached its blocks are
+// gone. All blocks must be freed before the pool is destroyed, as with any
+// pool.
+//
+// Build: g++ -std=c++17 -O2 -pthread slab_pool.cpp
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+// ============================================================================
+// SIZE CLASSES
+// ============================================================================
+
+constexpr std::size_t kSlabSize = 64 * 1024;
+constexpr std::size_t kHeaderSize = 64;
+constexpr std::size_t kMaxSmall = 4096;
+
+// Two classes per power of two above 16 (at most ~33% internal waste);
+// every class from 16 up is a multiple of 16, so blocks are max_align_t aligned
+constexpr std::array<std::uint32_t, 18> kClassSizes = {
+    8, 16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024, 1536, 2048, 2560, 3072, 4096,
+};
+constexpr std::size_t kClasses = kClassSizes.size();
+
+struct ClassTable {
+    std::array<std::uint8_t, kMaxSmall / 8 + 1> by_units{};   // indexed by ceil(size / 8)
+
+    constexpr ClassTable() {
+        std::size_t c = 0;
+        for (std::size_t units = 0; units < by_units.size(); ++units) {
+            while (kClassSizes[c] < units * 8) ++c;
+            by_units[units] = static_cast<std::uint8_t>(c);
+        }
+    }
+};
+constexpr ClassTable kClassTable;
+
+inline std::size_t class_of(std::size_t size) { return kClassTable.by_units[(size + 7) >> 3]; }
+
+// Objects per thread-cache refill: about 8 KB worth, between 4 and 64
+constexpr std::uint32_t batch_for(std::size_t c) {
+    std::uint32_t n = static_cast<std::uint32_t>(8192 / kClassSizes[c]);
+    return n < 4 ? 4 : (n > 64 ? 64 : n);
+}
+
+// ============================================================================
+// SLAB POOL
+// ============================================================================
+
+class SlabPool {
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    // Intrusive singly linked list of free blocks
+    struct FreeList {
+        FreeBlock* head = nullptr;
+        std::uint32_t count = 0;
+
+        void push(void* p) {
+            auto* b = static_cast<FreeBlock*>(p);
+            b->next = head;
+            head = b;
+            ++count;
+        }
+
+        void* pop() {
+            FreeBlock* b = head;
+            head = b->next;
+            --count;
+            return b;
+        }
+    };
+
+    struct Central;
+
+    struct alignas(kHeaderSize) SlabHeader {
+        Central* owner;
+        std::uint32_t size_class;
+    };
+
+    // Shared state: per-class lists and the slabs themselves. Thread caches
+    // hold a shared_ptr, so it outlives the SlabPool object if they do.
+    struct Central : std::enable_shared_from_this<Central> {
+        struct alignas(64) ClassState {
+            std::mutex mutex;
+            FreeList free;
+            char* bump = nullptr;       // uncarved part of the newest slab
+            char* bump_end = nullptr;
+        };
+
+        std::array<ClassState, kClasses> classes;
+        std::mutex slabs_mutex;
+        std::vector<void*> slabs;
+
+        ~Central() {
+            for (void* slab : slabs) std::free(slab);
+        }
+
+        // Moves up to n blocks of class c into out, carving new ones as needed
+        void refill(std::size_t c, std::uint32_t n, FreeList& out) {
+            ClassState& cls = classes[c];
+            std::lock_guard<std::mutex> lock(cls.mutex);
+            while (n > 0 && cls.free.head) {
+                out.push(cls.free.pop());
+                --n;
+            }
+            const std::size_t size = kClassSizes[c];
+            while (n > 0) {
+                if (!cls.bump || static_cast<std::size_t>(cls.bump_end - cls.bump) < size) {
+                    char* slab = new_slab(c);
+                    cls.bump = slab + kHeaderSize;
+                    cls.bump_end = slab + kSlabSize;
+                }
+                out.push(cls.bump);
+                cls.bump += size;
+                --n;
+            }
+        }
+
+        // Returns n blocks from the front of list to class c
+        void take_back(std::size_t c, std::uint32_t n, FreeList& list) {
+            ClassState& cls = classes[c];
+            // Unlink the batch before taking the lock
+            FreeBlock* first = list.head;
+            FreeBlock* last = first;
+            for (std::uint32_t i = 1; i < n; ++i) last = last->next;
+            list.head = last->next;
+            list.count -= n;
+
+            std::lock_guard<std::mutex> lock(cls.mutex);
+            last->next = cls.free.head;
+            cls.free.head = first;
+            cls.free.count += n;
+        }
+
+        char* new_slab(std::size_t c) {
+            void* mem = std::aligned_alloc(kSlabSize, kSlabSize);
+            if (!mem) throw std::bad_alloc();
+            ::new (mem) SlabHeader{this, static_cast<std::uint32_t>(c)};
+            std::lock_guard<std::mutex> lock(slabs_mutex);
+            slabs.push_back(mem);
+            return static_cast<char*>(mem);
+        }
+    };
+
+    struct ThreadCache {
+        std::shared_ptr<Central> central;
+        std::array<FreeList, kClasses> lists;
+
+        ~ThreadCache() {
+            for (std::size_t c = 0; c < kClasses; ++c) {
+                if (lists[c].count) central->take_back(c, lists[c].count, lists[c]);
+            }
+        }
+    };
+
+    // This thread's caches, one per pool it has touched; the last one used is
+    // checked first, and most threads use one pool
+    struct ThreadCaches {
+        Central* last_central = nullptr;
+        ThreadCache* last_cache = nullptr;
+        std::vector<std::unique_ptr<ThreadCache>> caches;
+
+        ThreadCache& get(Central* central) {
+            if (central == last_central) return *last_cache;
+            auto it = std::find_if(caches.begin(), caches.end(),
+                                   [&](auto& tc) { return tc->central.get() == central; });
+            if (it == caches.end()) {
+                caches.push_back(std::make_unique<ThreadCache>());
+                caches.back()->central = central->shared_from_this();
+                it = caches.end() - 1;
+            }
+            last_central = central;
+            last_cache = it->get();
+            return *last_cache;
+        }
+
+        void drop(Central* central) {
+            caches.erase(std::remove_if(caches.begin(), caches.end(),
+                                        [&](auto& tc) { return tc->central.get() == central; }),
+                         caches.end());
+            last_central = nullptr;
+            last_cache = nullptr;
+        }
+    };
+
+    static ThreadCaches& thread_caches() {
+        static thread_local ThreadCaches caches;
+        return caches;
+    }
+
+    static SlabHeader* header_of(void* p) {
+        return reinterpret_cast<SlabHeader*>(reinterpret_cast<std::uintptr_t>(p) & ~(kSlabSize - 1));
+    }
+
+    std::shared_ptr<Central> central = std::make_shared<Central>();
+
+public:
+    SlabPool() = default;
+    SlabPool(const SlabPool&) = delete;
+    SlabPool& operator=(const SlabPool&) = delete;
+
+    // Flushes this thread's cache; other threads flush theirs on exit
+    ~SlabPool() { thread_caches().drop(central.get()); }
+
+    void* allocate(std::size_t size) {
+        if (size > kMaxSmall) return ::operator new(size);
+        if (size == 0) size = 1;
+        const std::size_t c = class_of(size);
+        FreeList& list = thread_caches().get(central.get()).lists[c];
+        if (!list.head) central->refill(c, batch_for(c), list);
+        return list.pop();
+    }
+
+    // Static: the slab header says which pool the block belongs to. `size`
+    // only routes large blocks back to operator delete.
+    static void deallocate(void* p, std::size_t size) {
+        if (!p) return;
+        if (size > kMaxSmall) {
+            ::operator delete(p);
+            return;
+        }
+        SlabHeader* header = header_of(p);
+        const std::size_t c = header->size_class;
+        FreeList& list = thread_caches().get(header->owner).lists[c];
+        list.push(p);
+        const std::uint32_t batch = batch_for(c);
+        if (list.count > 2 * batch) header->owner->take_back(c, batch, list);
+    }
+
+    std::size_t slab_count() const {
+        std::lock_guard<std::mutex> lock(central->slabs_mutex);
+        return central->slabs.size();
+    }
+};
+
+// ============================================================================
+// TYPED HELPERS
+// ============================================================================
+
+// Stateless: unique_ptr stays one pointer wide. No converting constructor,
+// so a pool_unique_ptr<Derived> cannot be freed as a Base of another size.
+template<typename T>
+struct PoolDelete {
+    void operator()(T* p) const {
+        p->~T();
+        SlabPool::deallocate(p, sizeof(T));
+    }
+};
+
+template<typename T>
+using pool_unique_ptr = std::unique_ptr<T, PoolDelete<T>>;
+
+template<typename T, typename... Args>
+pool_unique_ptr<T> pool_make_unique(SlabPool& pool, Args&&... args) {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned types need an aligned pool");
+    void* mem = pool.allocate(sizeof(T));
+    try {
+        return pool_unique_ptr<T>(::new (mem) T(std::forward<Args>(args)...));
+    } catch (...) {
+        SlabPool::deallocate(mem, sizeof(T));
+        throw;
+    }
+}
+
+// Standard allocator over a SlabPool, for allocate_shared and containers
+template<typename T>
+struct PoolAllocator {
+    using value_type = T;
+    SlabPool* pool;
+
+    explicit PoolAllocator(SlabPool& p) noexcept : pool(&p) {}
+    template<typename U>
+    PoolAllocator(const PoolAllocator<U>& other) noexcept : pool(other.pool) {}
+
+    T* allocate(std::size_t n) { return static_cast<T*>(pool->allocate(n * sizeof(T))); }
+    void deallocate(T* p, std::size_t n) noexcept { SlabPool::deallocate(p, n * sizeof(T)); }
+
+    template<typename U>
+    bool operator==(const PoolAllocator<U>& other) const noexcept { return pool == other.pool; }
+    template<typename U>
+    bool operator!=(const PoolAllocator<U>& other) const noexcept { return pool != other.pool; }
+};
+
+// Control block and object in one pool block; destroyed and freed through
+// the allocator when the last reference goes
+template<typename T, typename... Args>
+std::shared_ptr<T> pool_make_shared(SlabPool& pool, Args&&... args) {
+    return std::allocate_shared<T>(PoolAllocator<T>(pool), std::forward<Args>(args)...);
+}
+
+// ============================================================================
+// BASELINE: THE REFRESHER'S POOL
+// ============================================================================
+
+class VectorTrackingPool {
+    std::vector<void*> allocated;
+
+public:
+    void* allocate(std::size_t size) {
+        void* ptr = std::malloc(size);
+        allocated.push_back(ptr);
+        return ptr;
+    }
+
+    void deallocate(void* ptr) {
+        auto it = std::find(allocated.begin(), allocated.end(), ptr);
+        if (it != allocated.end()) {
+            std::free(ptr);
+            allocated.erase(it);
+        }
+    }
+
+    ~VectorTrackingPool() {
+        for (void* ptr : allocated) std::free(ptr);
+    }
+};
+
+// ============================================================================
+// BENCHMARK
+// ============================================================================
+
+// Sizes skewed small, as object graphs are: half under 64 B, a tail to 1 KB
+std::vector<std::uint32_t> make_sizes(std::size_t n, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::vector<std::uint32_t> sizes(n);
+    for (auto& s : sizes) {
+        unsigned r = rng() % 100;
+        s = r < 50 ? 8 + rng() % 56 : (r < 90 ? 64 + rng() % 192 : 256 + rng() % 768);
+    }
+    return sizes;
+}
+
+// Churn: keep `live` blocks, repeatedly free a random one and allocate a new
+// one in its place. Returns nanoseconds per allocate+free pair.
+template<typename Alloc, typename Free>
+double churn(std::size_t live, std::size_t ops, unsigned seed, Alloc&& alloc, Free&& release) {
+    auto sizes = make_sizes(live + ops, seed);
+    std::mt19937 rng(seed * 7 + 1);
+    std::vector<std::uint32_t> victims(ops);
+    for (auto& v : victims) v = static_cast<std::uint32_t>(rng() % live);
+
+    std::vector<std::pair<void*, std::uint32_t>> slots(live);
+    for (std::size_t i = 0; i < live; ++i) slots[i] = {alloc(sizes[i]), sizes[i]};
+
+    auto start = Clock::now();
+    for (std::size_t i = 0; i < ops; ++i) {
+        auto& slot = slots[victims[i]];
+        release(slot.first, slot.second);
+        std::uint32_t size = sizes[live + i];
+        slot = {alloc(size), size};
+        static_cast<char*>(slot.first)[0] = 1;   // touch it, as a constructor would
+    }
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / ops;
+    for (auto& slot : slots) release(slot.first, slot.second);
+    return ns;
+}
+
+template<typename Body>
+double threaded(int threads, Body&& body) {
+    std::vector<double> ns(threads);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) workers.emplace_back([&, t] { ns[t] = body(t); });
+    for (auto& w : workers) w.join();
+    double sum = 0;
+    for (double v : ns) sum += v;
+    return sum / threads;
+}
+
+struct Particle {
+    double position[3];
+    double velocity[3];
+    std::uint32_t id;
+    explicit Particle(std::uint32_t i) : position{}, velocity{}, id(i) {}
+};
+
+template<typename Make>
+double typed_churn(std::size_t live, std::size_t ops, Make&& make) {
+    using Ptr = decltype(make(0u));
+    std::vector<Ptr> slots;
+    slots.reserve(live);
+    for (std::size_t i = 0; i < live; ++i) slots.push_back(make(static_cast<std::uint32_t>(i)));
+    std::mt19937 rng(5);
+    std::uint64_t checksum = 0;
+    auto start = Clock::now();
+    for (std::size_t i = 0; i < ops; ++i) {
+        auto& slot = slots[rng() % live];
+        checksum += slot->id;
+        slot = make(static_cast<std::uint32_t>(i));
+    }
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / ops;
+    if (checksum == 1) std::cout << "";
+    return ns;
+}
+
+void report(const std::string& what, double ns, double baseline_ns, const std::string& baseline = "malloc") {
+    std::cout << "  " << std::left << std::setw(40) << what << std::right << std::fixed << std::setprecision(1)
+              << std::setw(8) << ns << " ns/op  " << std::setw(6) << std::setprecision(2) << baseline_ns / ns
+              << "x vs " << baseline << "\n";
+}
+
+int main() {
+    const std::size_t live = 10'000, ops = 4'000'000;
+
+    auto malloc_alloc = [](std::size_t s) { return std::malloc(s); };
+    auto malloc_free = [](void* p, std::size_t) { std::free(p); };
+
+    std::cout << "churn: " << live << " live blocks, 8 B - 1 KB, free one + allocate one per op\n";
+    double malloc_ns = churn(live, ops, 1, malloc_alloc, malloc_free);
+    report("malloc/free", malloc_ns, malloc_ns);
+
+    {
+        // O(live) per free: run far fewer ops and report per-op cost
+        VectorTrackingPool old_pool;
+        double ns = churn(live, ops / 200, 1, [&](std::size_t s) { return old_pool.allocate(s); },
+                          [&](void* p, std::size_t) { old_pool.deallocate(p); });
+        report("refresher MemoryPool (vector + find)", ns, malloc_ns);
+    }
+
+    SlabPool pool;
+    double slab_ns = churn(live, ops, 1, [&](std::size_t s) { return pool.allocate(s); },
+                           [](void* p, std::size_t s) { SlabPool::deallocate(p, s); });
+    report("SlabPool", slab_ns, malloc_ns);
+
+    const int threads = 4;
+    std::cout << threads << " threads sharing one pool, same churn each:\n";
+    double mt = threaded(threads, [&](int t) { return churn(live, ops / threads, 10 + t, malloc_alloc, malloc_free); });
+    report("malloc/free", mt, mt);
+    double st = threaded(threads, [&](int t) {
+        return churn(live, ops / threads, 10 + t, [&](std::size_t sz) { return pool.allocate(sz); },
+                     [](void* p, std::size_t sz) { SlabPool::deallocate(p, sz); });
+    });
+    report("SlabPool (thread caches)", st, mt);
+
+    std::cout << "typed: replace a random one of " << live << " live Particles per op\n";
+    double mu = typed_churn(live, ops, [](std::uint32_t i) { return std::make_unique<Particle>(i); });
+    report("make_unique", mu, mu, "make_unique");
+    report("pool_make_unique",
+           typed_churn(live, ops, [&](std::uint32_t i) { return pool_make_unique<Particle>(pool, i); }), mu,
+           "make_unique");
+    double ms = typed_churn(live, ops, [](std::uint32_t i) { return std::make_shared<Particle>(i); });
+    report("make_shared", ms, ms, "make_shared");
+    report("pool_make_shared",
+           typed_churn(live, ops, [&](std::uint32_t i) { return pool_make_shared<Particle>(pool, i); }), ms,
+           "make_shared");
+
+    std::cout << "slabs reserved: " << pool.slab_count() << " x " << kSlabSize / 1024 << " KB\n";
+    return 0;
+}
@@ -0,0 +1,228 @@
+// SMALL_FUNCTION VS STD::FUNCTION
+//
+// Measures the wrappers from Examples/small_function.hpp against
+// std::function on the operations the thread pool, event dispatcher and
+// watchdog actually perform:
+//   - construct + destroy, for captures of 8, 24 and 64 bytes (libstdc++'s
+//     std::function stores only 16 bytes inline, small_function 24)
+//   - calling through a vector of wrappers
+//   - passing a lambda as a parameter: function_ref vs const std::function&
+//     (the latter builds a temporary std::function at every call)
+//   - queue push + pop + run, the thread pool's hot loop without threads
+//   - a thread pool style task: shared_ptr<packaged_task> in a std::function
+//     vs the packaged_task moved straight into a small_function
+//
+// Build: g++ -std=c++17 -O2 small_function_bench.cpp
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "../small_function.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+template<typename T>
+inline void do_not_optimize(T& value) {
+    asm volatile("" : "+m"(value) : : "memory");
+}
+
+// Best of 5 runs, in nanoseconds per operation
+template<typename Body>
+double ns_per_op(std::size_t ops, Body&& body) {
+    double best = 1e18;
+    for (int round = 0; round < 5; ++round) {
+        auto start = Clock::now();
+        body();
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        best = std::min(best, ns / ops);
+    }
+    return best;
+}
+
+void report(const std::string& what, double baseline_ns, double ns) {
+    std::cout << "  " << std::left << std::setw(34) << what << std::right << std::fixed << std::setprecision(2)
+              << std::setw(8) << baseline_ns << " ns  " << std::setw(8) << ns << " ns  " << std::setw(6)
+              << baseline_ns / ns << "x\n";
+}
+
+// ============================================================================
+// CONSTRUCT + DESTROY
+// ============================================================================
+
+template<std::size_t Bytes>
+struct Capture {
+    std::array<std::uint64_t, Bytes / 8> words{};
+};
+
+template<typename Wrapper, std::size_t Bytes>
+double construct_cost(std::size_t n) {
+    std::vector<Wrapper> slots(1024);
+    return ns_per_op(n, [&] {
+        Capture<Bytes> capture;
+        for (std::size_t i = 0; i < n; ++i) {
+            capture.words[0] = i;
+            // Assigning over the previous wrapper destroys it, so every
+            // iteration pays one construction and one destruction
+            slots[i & 1023] = [capture](int x) { return static_cast<int>(capture.words[0]) + x; };
+        }
+        do_not_optimize(slots);
+    });
+}
+
+template<std::size_t Bytes>
+void bench_construct(std::size_t n) {
+    double std_ns = construct_cost<std::function<int(int)>, Bytes>(n);
+    double small_ns = construct_cost<small_function<int(int)>, Bytes>(n);
+    report(std::to_string(Bytes) + "-byte capture" +
+               (small_function<int(int)>::stores_inline<Capture<Bytes>>() ? " (inline)" : " (heap)"),
+           std_ns, small_ns);
+}
+
+// ============================================================================
+// CALL THROUGH A VECTOR
+// ============================================================================
+
+template<typename Wrapper>
+double call_cost(std::size_t n, std::size_t rounds) {
+    std::vector<Wrapper> handlers;
+    handlers.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        int k = static_cast<int>(i % 7);
+        handlers.emplace_back([k](int x) { return x * k + 1; });
+    }
+    return ns_per_op(n * rounds, [&] {
+        unsigned acc = 0;
+        for (std::size_t r = 0; r < rounds; ++r) {
+            for (const auto& handler : handlers) acc += static_cast<unsigned>(handler(static_cast<int>(acc & 0xff)));
+        }
+        do_not_optimize(acc);
+    });
+}
+
+// ============================================================================
+// LAMBDA AS A PARAMETER
+// ============================================================================
+
+__attribute__((noinline)) int apply_std(const std::function<int(int)>& f, int x) { return f(x); }
+__attribute__((noinline)) int apply_ref(function_ref<int(int)> f, int x) { return f(x); }
+
+// Captures 24 bytes, which no longer fits std::function's inline buffer
+template<typename Apply>
+double parameter_cost(std::size_t n, Apply apply) {
+    return ns_per_op(n, [&] {
+        unsigned acc = 0;
+        std::int64_t a = 3, b = 5, c = 7;
+        for (std::size_t i = 0; i < n; ++i) {
+            acc += static_cast<unsigned>(
+                apply([a, b, c](int x) { return static_cast<int>(x * a + b - c); }, static_cast<int>(i)));
+        }
+        do_not_optimize(acc);
+    });
+}
+
+// ============================================================================
+// QUEUE PUSH / POP / RUN
+// ============================================================================
+
+template<typename Wrapper>
+double queue_cost(std::size_t n) {
+    std::queue<Wrapper> tasks;
+    std::uint64_t sum = 0;
+    return ns_per_op(n, [&] {
+        for (std::size_t i = 0; i < n; ++i) {
+            std::uint64_t* out = &sum;
+            std::uint64_t a = i, b = i * 3;
+            tasks.emplace([out, a, b] { *out += a ^ b; });
+            if (tasks.size() >= 256) {
+                while (!tasks.empty()) {
+                    Wrapper task = std::move(tasks.front());
+                    tasks.pop();
+                    task();
+                }
+            }
+        }
+        while (!tasks.empty()) {
+            tasks.front()();
+            tasks.pop();
+        }
+        do_not_optimize(sum);
+    });
+}
+
+// ============================================================================
+// THREAD POOL TASK (packaged_task + future)
+// ============================================================================
+
+double pool_task_std(std::size_t n) {
+    std::queue<std::function<void()>> tasks;
+    long total = 0;
+    return ns_per_op(n, [&] {
+        for (std::size_t i = 0; i < n; ++i) {
+            // What ThreadPool::enqueue used to do: bind, shared_ptr, copyable wrapper
+            auto task = std::make_shared<std::packaged_task<int()>>(std::bind([](int v) { return v * 2; },
+                                                                              static_cast<int>(i)));
+            std::future<int> result = task->get_future();
+            tasks.emplace([task]() { (*task)(); });
+            std::function<void()> run = std::move(tasks.front());
+            tasks.pop();
+            run();
+            total += result.get();
+        }
+        do_not_optimize(total);
+    });
+}
+
+double pool_task_small(std::size_t n) {
+    std::queue<small_function<void()>> tasks;
+    long total = 0;
+    return ns_per_op(n, [&] {
+        for (std::size_t i = 0; i < n; ++i) {
+            int v = static_cast<int>(i);
+            std::packaged_task<int()> task([v] { return v * 2; });
+            std::future<int> result = task.get_future();
+            tasks.emplace(std::move(task));
+            small_function<void()> run = std::move(tasks.front());
+            tasks.pop();
+            run();
+            total += result.get();
+        }
+        do_not_optimize(total);
+    });
+}
+
+// ============================================================================
+// BENCHMARK
+// ============================================================================
+
+int main() {
+    const std::size_t n = 2'000'000;
+
+    std::cout << "                                    std::function  small_function  speedup\n";
+
+    std::cout << "construct + destroy\n";
+    bench_construct<8>(n);
+    bench_construct<24>(n);
+    bench_construct<64>(n);
+
+    std::cout << "call\n";
+    report("vector of 4096 handlers", call_cost<std::function<int(int)>>(4096, 500),
+           call_cost<small_function<int(int)>>(4096, 500));
+
+    std::cout << "parameter (std::function vs function_ref)\n";
+    report("lambda with 24-byte capture", parameter_cost(n, apply_std), parameter_cost(n, apply_ref));
+
+    std::cout << "queue\n";
+    report("push + pop + run", queue_cost<std::function<void()>>(n), queue_cost<small_function<void()>>(n));
+    report("packaged_task enqueue + run", pool_task_std(n / 4), pool_task_small(n / 4));
+
+    return 0;
+}
@@ -0,0 +1,744 @@
+// PRODUCTION SORT STRATEGIES
+//
+// Same Strategy shape as the refresher (virtual sort(std::vector<T>&) and
+// getName()), but generic over the element type and a key extractor, and
+// with no I/O inside sort():
+//   - RadixSort          LSD radix on integer / floating keys, skips
+//                        passes where every key shares the digit
+//   - PdqSort            pattern-defeating quicksort: ninther pivot,
+//                        detects sorted runs, many-equal-keys partition,
+//                        heapsort fallback -> O(n log n) worst case
+//   - ParallelSampleSort splitters from an oversampled sample, parallel
+//                        classify + scatter, buckets sorted with PdqSort
+//                        (not stable)
+//   - small arrays       Batcher odd-even merge network, branchless
+//                        compare-exchange, used as PdqSort's base case
+//
+// Build: g++ -std=c++20 -O3 -march=native -pthread sort_strategies.cpp
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+// KEY EXTRACTORS
+
+struct Identity {
+    template<typename T>
+    constexpr const T& operator()(const T& x) const noexcept { return x; }
+};
+
+template<typename KeyFn>
+struct KeyLess {
+    KeyFn key;
+    template<typename T>
+    bool operator()(const T& a, const T& b) const { return key(a) < key(b); }
+};
+
+
+// SORTING NETWORK (n <= 16)
+
+namespace network {
+
+constexpr std::size_t MAX_N = 16;
+
+struct Network {
+    std::array<std::pair<std::uint8_t, std::uint8_t>, 64> pairs{};
+    std::size_t count = 0;
+};
+
+// Batcher's odd-even merge sort on 16 wires, keeping only comparators whose
+// wires are both < n. Dropped wires behave like +infinity inputs, so the
+// restricted network still sorts n elements.
+constexpr Network make_network(std::size_t n) {
+    Network net;
+    for (std::size_t p = 1; p < MAX_N; p *= 2) {
+        for (std::size_t k = p; k >= 1; k /= 2) {
+            for (std::size_t j = k % p; j + k < MAX_N; j += 2 * k) {
+                for (std::size_t i = 0; i < std::min(k, MAX_N - j - k); ++i) {
+                    if ((i + j) / (2 * p) == (i + j + k) / (2 * p) && i + j + k < n) {
+                        net.pairs[net.count++] = {static_cast<std::uint8_t>(i + j),
+                                                  static_cast<std::uint8_t>(i + j + k)};
+                    }
+                }
+            }
+        }
+    }
+    return net;
+}
+
+constexpr auto make_all() {
+    std::array<Network, MAX_N + 1> all{};
+    for (std::size_t n = 0; n <= MAX_N; ++n) all[n] = make_network(n);
+    return all;
+}
+
+inline constexpr auto NETWORKS = make_all();
+
+// Both outputs are selected, never branched on: compiles to cmov / min / max
+template<typename T, typename KeyFn>
+inline void compare_exchange(T& a, T& b, const KeyFn& key) {
+    bool swap = key(b) < key(a);
+    T lo = swap ? b : a;
+    T hi = swap ? a : b;
+    a = lo;
+    b = hi;
+}
+
+template<typename T, typename KeyFn>
+void sort(T* data, std::size_t n, const KeyFn& key) {
+    const Network& net = NETWORKS[n];
+    for (std::size_t c = 0; c < net.count; ++c) {
+        compare_exchange(data[net.pairs[c].first], data[net.pairs[c].second], key);
+    }
+}
+
+// Networks only pay off when elements are cheap to copy and compare
+template<typename T>
+inline constexpr bool usable = std::is_trivially_copyable_v<T> && sizeof(T) <= 16;
+
+} // namespace network
+
+
+// PATTERN-DEFEATING QUICKSORT
+
+namespace pdq {
+
+constexpr std::ptrdiff_t INSERTION_SORT_THRESHOLD = 24;
+constexpr std::ptrdiff_t NINTHER_THRESHOLD = 128;
+constexpr std::ptrdiff_t PARTIAL_INSERTION_SORT_LIMIT = 8;
+
+template<typename It, typename Less>
+void insertion_sort(It begin, It end, Less less) {
+    if (begin == end) return;
+    for (It cur = begin + 1; cur != end; ++cur) {
+        It sift = cur;
+        It sift_1 = cur - 1;
+        if (less(*sift, *sift_1)) {
+            auto tmp = std::move(*sift);
+            do {
+                *sift-- = std::move(*sift_1);
+            } while (sift != begin && less(tmp, *--sift_1));
+            *sift = std::move(tmp);
+        }
+    }
+}
+
+// Requires an element <= everything in [begin, end) right before begin
+template<typename It, typename Less>
+void unguarded_insertion_sort(It begin, It end, Less less) {
+    if (begin == end) return;
+    for (It cur = begin + 1; cur != end; ++cur) {
+        It sift = cur;
+        It sift_1 = cur - 1;
+        if (less(*sift, *sift_1)) {
+            auto tmp = std::move(*sift);
+            do {
+                *sift-- = std::move(*sift_1);
+            } while (less(tmp, *--sift_1));
+            *sift = std::move(tmp);
+        }
+    }
+}
+
+// Insertion sort that gives up after a few moves; true if it finished
+template<typename It, typename Less>
+bool partial_insertion_sort(It begin, It end, Less less) {
+    if (begin == end) return true;
+    std::ptrdiff_t moved = 0;
+    for (It cur = begin + 1; cur != end; ++cur) {
+        It sift = cur;
+        It sift_1 = cur - 1;
+        if (less(*sift, *sift_1)) {
+            auto tmp = std::move(*sift);
+            do {
+                *sift-- = std::move(*sift_1);
+            } while (sift != begin && less(tmp, *--sift_1));
+            *sift = std::move(tmp);
+            moved += cur - sift;
+            if (moved > PARTIAL_INSERTION_SORT_LIMIT) return false;
+        }
+    }
+    return true;
+}
+
+template<typename It, typename Less>
+inline void sort2(It a, It b, Less less) {
+    if (less(*b, *a)) std::iter_swap(a, b);
+}
+
+template<typename It, typename Less>
+inline void sort3(It a, It b, It c, Less less) {
+    sort2(a, b, less);
+    sort2(b, c, less);
+    sort2(a, b, less);
+}
+
+// Pivot is *begin. Elements < pivot go left, >= pivot right.
+// Returns the pivot position and whether no swaps were needed.
+template<typename It, typename Less>
+std::pair<It, bool> partition_right(It begin, It end, Less less) {
+    auto pivot = std::move(*begin);
+    It first = begin;
+    It last = end;
+
+    while (less(*++first, pivot)) {}
+
+    if (first - 1 == begin) {
+        while (first < last && !less(*--last, pivot)) {}
+    } else {
+        while (!less(*--last, pivot)) {}
+    }
+
+    bool already_partitioned = first >= last;
+
+    while (first < last) {
+        std::iter_swap(first, last);
+        while (less(*++first, pivot)) {}
+        while (!less(*--last, pivot)) {}
+    }
+
+    It pivot_pos = first - 1;
+    *begin = std::move(*pivot_pos);
+    *pivot_pos = std::move(pivot);
+    return {pivot_pos, already_partitioned};
+}
+
+// Used when the pivot equals the element before the range: puts every
+// element equal to the pivot on the left, so runs of duplicates are
+// consumed in one linear pass instead of recursing on them.
+template<typename It, typename Less>
+It partition_left(It begin, It end, Less less) {
+    auto pivot = std::move(*begin);
+    It first = begin;
+    It last = end;
+
+    while (less(pivot, *--last)) {}
+
+    if (last + 1 == end) {
+        while (first < last && !less(pivot, *++first)) {}
+    } else {
+        while (!less(pivot, *++first)) {}
+    }
+
+    while (first < last) {
+        std::iter_swap(first, last);
+        while (less(pivot, *--last)) {}
+        while (!less(pivot, *++first)) {}
+    }
+
+    It pivot_pos = last;
+    *begin = std::move(*pivot_pos);
+    *pivot_pos = std::move(pivot);
+    return pivot_pos;
+}
+
+template<typename It, typename Less, typename KeyFn>
+void small_sort(It begin, It end, Less less, const KeyFn& key, bool leftmost) {
+    using T = typename std::iterator_traits<It>::value_type;
+    auto n = static_cast<std::size_t>(end - begin);
+    if constexpr (network::usable<T> && std::is_pointer_v<decltype(&*begin)>) {
+        if (n <= network::MAX_N) {
+            network::sort(&*begin, n, key);
+            return;
+        }
+    }
+    if (leftmost) {
+        insertion_sort(begin, end, less);
+    } else {
+        unguarded_insertion_sort(begin, end, less);
+    }
+}
+
+template<typename It, typename Less, typename KeyFn>
+void sort_loop(It begin, It end, Less less, const KeyFn& key, int bad_allowed, bool leftmost) {
+    while (true) {
+        std::ptrdiff_t size = end - begin;
+        if (size < INSERTION_SORT_THRESHOLD) {
+            small_sort(begin, end, less, key, leftmost);
+            return;
+        }
+
+        // Median of 3, or pseudo-median of 9 (ninther) for larger ranges
+        std::ptrdiff_t s2 = size / 2;
+        if (size > NINTHER_THRESHOLD) {
+            sort3(begin, begin + s2, end - 1, less);
+            sort3(begin + 1, begin + (s2 - 1), end - 2, less);
+            sort3(begin + 2, begin + (s2 + 1), end - 3, less);
+            sort3(begin + (s2 - 1), begin + s2, begin + (s2 + 1), less);
+            std::iter_swap(begin, begin + s2);
+        } else {
+            sort3(begin + s2, begin, end - 1, less);
+        }
+
+        // Pivot equal to the predecessor: everything equal goes left and is done
+        if (!leftmost && !less(*(begin - 1), *begin)) {
+            begin = partition_left(begin, end, less) + 1;
+            continue;
+        }
+
+        auto [pivot_pos, already_partitioned] = partition_right(begin, end, less);
+
+        std::ptrdiff_t l_size = pivot_pos - begin;
+        std::ptrdiff_t r_size = end - (pivot_pos + 1);
+        bool highly_unbalanced = l_size < size / 8 || r_size < size / 8;
+
+        if (highly_unbalanced) {
+            // Too many bad pivots: adversarial input, switch to heapsort
+            if (--bad_allowed == 0) {
+                std::make_heap(begin, end, less);
+                std::sort_heap(begin, end, less);
+                return;
+            }
+
+            // Break patterns that fooled the pivot selection
+            if (l_size >= INSERTION_SORT_THRESHOLD) {
+                std::iter_swap(begin, begin + l_size / 4);
+                std::iter_swap(pivot_pos - 1, pivot_pos - l_size / 4);
+                if (l_size > NINTHER_THRESHOLD) {
+                    std::iter_swap(begin + 1, begin + (l_size / 4 + 1));
+                    std::iter_swap(begin + 2, begin + (l_size / 4 + 2));
+                    std::iter_swap(pivot_pos - 2, pivot_pos - (l_size / 4 + 1));
+                    std::iter_swap(pivot_pos - 3, pivot_pos - (l_size / 4 + 2));
+                }
+            }
+            if (r_size >= INSERTION_SORT_THRESHOLD) {
+                std::iter_swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));
+                std::iter_swap(end - 1, end - r_size / 4);
+                if (r_size > NINTHER_THRESHOLD) {
+                    std::iter_swap(pivot_pos + 2, pivot_pos + (2 + r_size / 4));
+                    std::iter_swap(pivot_pos + 3, pivot_pos + (3 + r_size / 4));
+                    std::iter_swap(end - 2, end - (1 + r_size / 4));
+                    std::iter_swap(end - 3, end - (2 + r_size / 4));
+                }
+            }
+        } else if (already_partitioned &&
+                   partial_insertion_sort(begin, pivot_pos, less) &&
+                   partial_insertion_sort(pivot_pos + 1, end, less)) {
+            // Input looked sorted and a cheap insertion pass confirmed it
+            return;
+        }
+
+        // Recurse into the left part, loop on the right part
+        sort_loop(begin, pivot_pos, less, key, bad_allowed, leftmost);
+        begin = pivot_pos + 1;
+        leftmost = false;
+    }
+}
+
+template<typename It, typename KeyFn = Identity>
+void sort(It begin, It end, KeyFn key = {}) {
+    if (end - begin < 2) return;
+    int bad_allowed = std::bit_width(static_cast<std::size_t>(end - begin));
+    sort_loop(begin, end, KeyLess<KeyFn>{key}, key, bad_allowed, true);
+}
+
+} // namespace pdq
+
+
+// LSD RADIX SORT
+
+namespace radix {
+
+// Map a key to an unsigned integer with the same ordering
+template<typename K>
+auto to_ordered_bits(K k) {
+    if constexpr (std::is_floating_point_v<K>) {
+        using U = std::conditional_t<sizeof(K) == 4, std::uint32_t, std::uint64_t>;
+        U bits = std::bit_cast<U>(k);
+        constexpr U sign = U(1) << (sizeof(U) * 8 - 1);
+        // Negative: flip everything (reverses order); positive: set sign bit
+        return (bits & sign) ? ~bits : (bits | sign);
+    } else if constexpr (std::is_signed_v<K>) {
+        using U = std::make_unsigned_t<K>;
+        return static_cast<U>(static_cast<U>(k) ^ (U(1) << (sizeof(U) * 8 - 1)));
+    } else {
+        return k;
+    }
+}
+
+// Stable. Needs T default-constructible for the scratch buffer.
+template<typename T, typename KeyFn = Identity>
+void sort(std::vector<T>& data, KeyFn key = {}) {
+    using K = std::remove_cvref_t<decltype(key(data[0]))>;
+    static_assert(std::is_arithmetic_v<K>, "radix sort needs integer or floating keys");
+
+    const std::size_t n = data.size();
+    if (n < 256) {
+        pdq::sort(data.begin(), data.end(), key);
+        return;
+    }
+
+    constexpr std::size_t DIGITS = sizeof(K);
+    // One read pass builds the histograms of every byte position
+    std::vector<std::array<std::size_t, 256>> counts(DIGITS);
+    for (auto& c : counts) c.fill(0);
+    for (const T& x : data) {
+        auto bits = to_ordered_bits(key(x));
+        for (std::size_t d = 0; d < DIGITS; ++d) {
+            ++counts[d][(bits >> (8 * d)) & 0xFF];
+        }
+    }
+
+    std::vector<T> buffer(n);
+    T* src = data.data();
+    T* dst = buffer.data();
+
+    for (std::size_t d = 0; d < DIGITS; ++d) {
+        auto& count = counts[d];
+        // Every key has the same byte here: the pass would be a plain copy
+        if (std::find(count.begin(), count.end(), n) != count.end()) continue;
+
+        std::size_t offset[256];
+        std::size_t sum = 0;
+        for (std::size_t b = 0; b < 256; ++b) {
+            offset[b] = sum;
+            sum += count[b];
+        }
+        const unsigned shift = static_cast<unsigned>(8 * d);
+        for (std::size_t i = 0; i < n; ++i) {
+            auto digit = (to_ordered_bits(key(src[i])) >> shift) & 0xFF;
+            dst[offset[digit]++] = std::move(src[i]);
+        }
+        std::swap(src, dst);
+    }
+
+    if (src != data.data()) {
+        std::move(src, src + n, data.data());
+    }
+}
+
+} // namespace radix
+
+
+// PARALLEL SAMPLE SORT
+
+namespace sample {
+
+template<typename T, typename KeyFn = Identity>
+void sort(std::vector<T>& data, KeyFn key = {}, unsigned threads = 0) {
+    const std::size_t n = data.size();
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    if (threads == 1 || n < (std::size_t{1} << 16)) {
+        pdq::sort(data.begin(), data.end(), key);
+        return;
+    }
+
+    using K = std::remove_cvref_t<decltype(key(data[0]))>;
+    const std::size_t buckets = std::size_t{4} * threads;   // several per thread for balance
+    constexpr std::size_t OVERSAMPLE = 32;
+
+    // 1. Splitters: every OVERSAMPLE-th key of a sorted, evenly strided sample
+    std::vector<K> sample;
+    sample.reserve(buckets * OVERSAMPLE);
+    std::size_t stride = n / (buckets * OVERSAMPLE);
+    for (std::size_t i = 0; i < buckets * OVERSAMPLE; ++i) sample.push_back(key(data[i * stride]));
+    pdq::sort(sample.begin(), sample.end());
+    std::vector<K> splitters;
+    for (std::size_t b = 1; b < buckets; ++b) splitters.push_back(sample[b * OVERSAMPLE]);
+
+    auto run = [threads](auto&& fn) {
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t) workers.emplace_back(fn, t);
+        for (auto& w : workers) w.join();
+    };
+
+    // 2. Classify: per-thread histograms over contiguous chunks
+    std::vector<std::uint16_t> bucket_of(n);
+    std::vector<std::vector<std::size_t>> counts(threads, std::vector<std::size_t>(buckets, 0));
+    const std::size_t chunk = (n + threads - 1) / threads;
+
+    run([&](unsigned t) {
+        std::size_t lo = t * chunk, hi = std::min(n, lo + chunk);
+        auto& count = counts[t];
+        for (std::size_t i = lo; i < hi; ++i) {
+            auto b = static_cast<std::uint16_t>(
+                std::upper_bound(splitters.begin(), splitters.end(), key(data[i])) - splitters.begin());
+            bucket_of[i] = b;
+            ++count[b];
+        }
+    });
+
+    // 3. Offsets: bucket-major, then thread order inside a bucket. Not a
+    //    stable sort: the buckets are sorted with (unstable) PdqSort
+    std::vector<std::size_t> bucket_start(buckets + 1, 0);
+    {
+        std::size_t sum = 0;
+        for (std::size_t b = 0; b < buckets; ++b) {
+            bucket_start[b] = sum;
+            for (unsigned t = 0; t < threads; ++t) {
+                std::size_t c = counts[t][b];
+                counts[t][b] = sum;
+                sum += c;
+            }
+        }
+        bucket_start[buckets] = sum;
+    }
+
+    // 4. Scatter into the buffer
+    std::vector<T> buffer(n);
+    run([&](unsigned t) {
+        std::size_t lo = t * chunk, hi = std::min(n, lo + chunk);
+        auto& offset = counts[t];
+        for (std::size_t i = lo; i < hi; ++i) {
+            buffer[offset[bucket_of[i]]++] = std::move(data[i]);
+        }
+    });
+
+    // 5. Sort buckets, handed out dynamically to even out skew
+    std::atomic<std::size_t> next{0};
+    run([&](unsigned) {
+        for (std::size_t b; (b = next.fetch_add(1)) < buckets;) {
+            pdq::sort(buffer.begin() + bucket_start[b], buffer.begin() + bucket_start[b + 1], key);
+        }
+    });
+
+    data.swap(buffer);
+}
+
+} // namespace sample
+
+
+// STRATEGY INTERFACE
+
+template<typename T, typename KeyFn = Identity>
+class SortStrategy {
+public:
+    virtual ~SortStrategy() = default;
+    virtual void sort(std::vector<T>& data) const = 0;
+    virtual std::string getName() const = 0;
+};
+
+template<typename T, typename KeyFn = Identity>
+class StdSort : public SortStrategy<T, KeyFn> {
+    KeyFn key;
+public:
+    explicit StdSort(KeyFn k = {}) : key(k) {}
+    void sort(std::vector<T>& data) const override { std::sort(data.begin(), data.end(), KeyLess<KeyFn>{key}); }
+    std::string getName() const override { return "std::sort"; }
+};
+
+template<typename T, typename KeyFn = Identity>
+class PdqSort : public SortStrategy<T, KeyFn> {
+    KeyFn key;
+public:
+    explicit PdqSort(KeyFn k = {}) : key(k) {}
+    void sort(std::vector<T>& data) const override { pdq::sort(data.begin(), data.end(), key); }
+    std::string getName() const override { return "pdqsort"; }
+};
+
+template<typename T, typename KeyFn = Identity>
+class RadixSort : public SortStrategy<T, KeyFn> {
+    KeyFn key;
+public:
+    explicit RadixSort(KeyFn k = {}) : key(k) {}
+    void sort(std::vector<T>& data) const override { radix::sort(data, key); }
+    std::string getName() const override { return "LSD radix"; }
+};
+
+template<typename T, typename KeyFn = Identity>
+class ParallelSampleSort : public SortStrategy<T, KeyFn> {
+    KeyFn key;
+    unsigned threads;
+public:
+    explicit ParallelSampleSort(KeyFn k = {}, unsigned t = 0) : key(k), threads(t) {}
+    void sort(std::vector<T>& data) const override { sample::sort(data, key, threads); }
+    std::string getName() const override { return "sample sort"; }
+};
+
+// The refresher's QuickSort: Lomuto partition, last element as pivot
+template<typename T, typename KeyFn = Identity>
+class LomutoQuickSort : public SortStrategy<T, KeyFn> {
+    KeyFn key;
+
+    void quickSort(std::vector<T>& data, long low, long high) const {
+        while (low < high) {
+            long pi = partition(data, low, high);
+            quickSort(data, low, pi - 1);
+            low = pi + 1;
+        }
+    }
+
+    long partition(std::vector<T>& data, long low, long high) const {
+        auto pivot = key(data[high]);
+        long i = low - 1;
+        for (long j = low; j < high; ++j) {
+            if (key(data[j]) < pivot) std::swap(data[++i], data[j]);
+        }
+        std::swap(data[i + 1], data[high]);
+        return i + 1;
+    }
+
+public:
+    explicit LomutoQuickSort(KeyFn k = {}) : key(k) {}
+    void sort(std::vector<T>& data) const override {
+        if (!data.empty()) quickSort(data, 0, static_cast<long>(data.size()) - 1);
+    }
+    std::string getName() const override { return "Lomuto quicksort"; }
+};
+
+
+// BENCHMARK
+
+struct Order {
+    std::uint64_t id;
+    double price;
+    std::uint32_t quantity;
+};
+
+using Generator = std::function<std::vector<std::uint32_t>(std::size_t, std::mt19937&)>;
+
+std::vector<std::pair<std::string, Generator>> distributions() {
+    return {
+        {"random", [](std::size_t n, std::mt19937& rng) {
+            std::vector<std::uint32_t> v(n);
+            for (auto& x : v) x = rng();
+            return v;
+        }},
+        {"sorted", [](std::size_t n, std::mt19937&) {
+            std::vector<std::uint32_t> v(n);
+            for (std::size_t i = 0; i < n; ++i) v[i] = static_cast<std::uint32_t>(i);
+            return v;
+        }},
+        {"reversed", [](std::size_t n, std::mt19937&) {
+            std::vector<std::uint32_t> v(n);
+            for (std::size_t i = 0; i < n; ++i) v[i] = static_cast<std::uint32_t>(n - i);
+            return v;
+        }},
+        {"nearly sorted", [](std::size_t n, std::mt19937& rng) {
+            std::vector<std::uint32_t> v(n);
+            for (std::size_t i = 0; i < n; ++i) v[i] = static_cast<std::uint32_t>(i);
+            for (std::size_t k = 0; k < n / 100; ++k) std::swap(v[rng() % n], v[rng() % n]);
+            return v;
+        }},
+        {"few unique", [](std::size_t n, std::mt19937& rng) {
+            std::vector<std::uint32_t> v(n);
+            for (auto& x : v) x = rng() % 16;
+            return v;
+        }},
+        {"organ pipe", [](std::size_t n, std::mt19937&) {
+            std::vector<std::uint32_t> v(n);
+            for (std::size_t i = 0; i < n; ++i) v[i] = static_cast<std::uint32_t>(i < n / 2 ? i : n - i);
+            return v;
+        }},
+        {"sawtooth", [](std::size_t n, std::mt19937&) {
+            std::vector<std::uint32_t> v(n);
+            for (std::size_t i = 0; i < n; ++i) v[i] = static_cast<std::uint32_t>(i % 1000);
+            return v;
+        }},
+    };
+}
+
+template<typename F>
+double time_ms(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double, std::milli> ms = std::chrono::steady_clock::now() - start;
+    return ms.count();
+}
+
+void benchmark_distributions(std::size_t n) {
+    std::vector<std::unique_ptr<SortStrategy<std::uint32_t>>> strategies;
+    strategies.push_back(std::make_unique<StdSort<std::uint32_t>>());
+    strategies.push_back(std::make_unique<PdqSort<std::uint32_t>>());
+    strategies.push_back(std::make_unique<RadixSort<std::uint32_t>>());
+    strategies.push_back(std::make_unique<ParallelSampleSort<std::uint32_t>>());
+    LomutoQuickSort<std::uint32_t> lomuto;
+
+    std::cout << "n = " << n << " uint32, milliseconds\n";
+    std::cout << "distribution  ";
+    for (auto& s : strategies) std::cout << " | " << s->getName();
+    std::cout << " | " << lomuto.getName() << "\n";
+
+    std::mt19937 rng(123);
+    for (auto& [name, gen] : distributions()) {
+        auto input = gen(n, rng);
+        auto expected = input;
+        std::sort(expected.begin(), expected.end());
+
+        std::cout << name << std::string(14 - name.size(), ' ');
+        for (auto& s : strategies) {
+            auto v = input;
+            double ms = time_ms([&] { s->sort(v); });
+            std::cout << " | " << ms << (v == expected ? "" : " WRONG");
+        }
+        // Lomuto degrades to O(n^2) on sorted input and duplicates
+        if (name == "random") {
+            auto v = input;
+            std::cout << " | " << time_ms([&] { lomuto.sort(v); });
+        } else {
+            std::cout << " | (O(n^2), skipped)";
+        }
+        std::cout << "\n";
+    }
+}
+
+void benchmark_key_extractor(std::size_t n) {
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> price(-500.0, 500.0);
+    std::vector<Order> orders(n);
+    for (std::size_t i = 0; i < n; ++i) orders[i] = {i, price(rng), static_cast<std::uint32_t>(rng() % 100)};
+
+    auto by_price = [](const Order& o) { return o.price; };
+    auto check = [&](const std::vector<Order>& v) {
+        return std::is_sorted(v.begin(), v.end(), KeyLess<decltype(by_price)>{by_price});
+    };
+
+    std::cout << "\n" << n << " Orders sorted by price (double key), milliseconds\n";
+    StdSort<Order, decltype(by_price)> s1(by_price);
+    PdqSort<Order, decltype(by_price)> s2(by_price);
+    RadixSort<Order, decltype(by_price)> s3(by_price);
+    ParallelSampleSort<Order, decltype(by_price)> s4(by_price);
+    for (const SortStrategy<Order, decltype(by_price)>* s :
+         std::initializer_list<const SortStrategy<Order, decltype(by_price)>*>{&s1, &s2, &s3, &s4}) {
+        auto v = orders;
+        double ms = time_ms([&] { s->sort(v); });
+        std::cout << "  " << s->getName() << ": " << ms << (check(v) ? "" : " WRONG") << "\n";
+    }
+}
+
+void benchmark_small_arrays() {
+    constexpr std::size_t arrays = 1 << 18;
+    std::mt19937 rng(9);
+
+    std::cout << "\n" << arrays << " small int arrays, milliseconds\n";
+    for (std::size_t size : {4, 8, 12, 16}) {
+        std::vector<int> input(arrays * size);
+        for (auto& x : input) x = static_cast<int>(rng());
+
+        auto v1 = input, v2 = input, v3 = input;
+        double t_net = time_ms([&] {
+            for (std::size_t a = 0; a < arrays; ++a) network::sort(v1.data() + a * size, size, Identity{});
+        });
+        double t_ins = time_ms([&] {
+            for (std::size_t a = 0; a < arrays; ++a)
+                pdq::insertion_sort(v2.begin() + a * size, v2.begin() + (a + 1) * size, std::less<>{});
+        });
+        double t_std = time_ms([&] {
+            for (std::size_t a = 0; a < arrays; ++a) std::sort(v3.begin() + a * size, v3.begin() + (a + 1) * size);
+        });
+        std::cout << "  n=" << size << "  network " << t_net << " | insertion " << t_ins
+                  << " | std::sort " << t_std << (v1 == v3 && v2 == v3 ? "" : " WRONG") << "\n";
+    }
+}
+
+int main() {
+    std::cout.precision(4);
+    benchmark_distributions(2'000'000);
+    benchmark_key_extractor(1'000'000);
+    benchmark_small_arrays();
+}
@@ -0,0 +1,611 @@
+// ZERO-COPY VERSIONED WIRE PROTOCOL ENGINE
+//
+// A working version of MessageProcessor from
+// Refreshers/28_ffi_and_good_practices.cpp, same 16-byte header
+// (version, size, type, checksum):
+//   - FrameParser consumes a byte stream in arbitrary chunks. Frames that
+//     lie wholly inside a chunk are handed out as views into that chunk (no
+//     copy); only a frame split across chunks is reassembled in an internal
+//     buffer.
+//   - V1View / V2View read fields straight from the frame bytes. v1 payloads
+//     are variable length (at most 256 bytes, the old fixed array size);
+//     v2 adds flags and a timestamp.
+//   - checksum: Adler-32 over everything after the header, with an AVX2
+//     version (sad/maddubs, 32 bytes per step) and a scalar fallback
+//   - FrameWriter appends frames into buffers from a BufferPool, so a batch
+//     of frames costs no allocation once the pool is warm
+//   - version negotiation: each side sends a HELLO (always a v1 frame) with
+//     its supported range; both pick the highest common version
+// Fields are little endian; the code assumes a little-endian host.
+//
+// Build: g++ -std=c++17 -O2 -march=native wire_protocol.cpp
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// ============================================================================
+// WIRE FORMAT
+// ============================================================================
+
+namespace wire {
+
+// Header: version u32 | size u32 (whole frame) | type u32 | checksum u32
+// v2 adds:  flags u32 | timestamp u64, then the payload
+constexpr std::size_t kHeaderSize = 16;
+constexpr std::size_t kV2HeaderSize = kHeaderSize + 12;
+constexpr std::size_t kV1MaxPayload = 256;
+constexpr std::size_t kMaxFrame = 16 * 1024 * 1024;
+constexpr uint32_t kHelloType = 0xFFFF0001u;
+
+template<typename T>
+T read(const uint8_t* p) {
+    T v;
+    std::memcpy(&v, p, sizeof(T));
+    return v;
+}
+
+template<typename T>
+void write(uint8_t* p, T v) {
+    std::memcpy(p, &v, sizeof(T));
+}
+
+class ProtocolError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+} // namespace wire
+
+// ============================================================================
+// CHECKSUM
+// ============================================================================
+
+namespace checksum {
+
+constexpr uint32_t kMod = 65521;
+constexpr std::size_t kNmax = 5552;   // most bytes before s2 can overflow 32 bits
+
+uint32_t adler32_scalar(const uint8_t* p, std::size_t n, uint32_t adler = 1) {
+    uint32_t s1 = adler & 0xffff, s2 = adler >> 16;
+    while (n > 0) {
+        std::size_t block = std::min(n, kNmax);
+        n -= block;
+        while (block--) {
+            s1 += *p++;
+            s2 += s1;
+        }
+        s1 %= kMod;
+        s2 %= kMod;
+    }
+    return (s2 << 16) | s1;
+}
+
+#if defined(__AVX2__)
+inline uint64_t hsum_epi32(__m256i v) {
+    alignas(32) uint32_t lanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), v);
+    uint64_t total = 0;
+    for (uint32_t lane : lanes) total += lane;
+    return total;
+}
+
+// Per 32-byte step: s1 grows by the byte sum (vpsadbw) and s2 by 32 * s1
+// plus the byte sum weighted 32..1 (vpmaddubsw + vpmaddwd). The 32 * s1
+// terms are accumulated as a running sum of s1 and scaled once per block.
+uint32_t adler32_avx2(const uint8_t* p, std::size_t n, uint32_t adler = 1) {
+    uint32_t s1 = adler & 0xffff, s2 = adler >> 16;
+    const __m256i weights = _mm256_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16,
+                                             15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+    const __m256i ones = _mm256_set1_epi16(1);
+    const __m256i zero = _mm256_setzero_si256();
+
+    while (n >= 32) {
+        std::size_t block = std::min(n, kNmax) & ~std::size_t{31};
+        n -= block;
+        __m256i byte_sums = zero, prefix = zero, weighted = zero;
+        for (std::size_t i = 0; i < block; i += 32) {
+            __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+            prefix = _mm256_add_epi32(prefix, byte_sums);
+            byte_sums = _mm256_add_epi32(byte_sums, _mm256_sad_epu8(bytes, zero));
+            weighted = _mm256_add_epi32(weighted, _mm256_madd_epi16(_mm256_maddubs_epi16(bytes, weights), ones));
+        }
+        p += block;
+        uint64_t wide_s2 = s2 + uint64_t{s1} * block + 32 * hsum_epi32(prefix) + hsum_epi32(weighted);
+        s1 = static_cast<uint32_t>((s1 + hsum_epi32(byte_sums)) % kMod);
+        s2 = static_cast<uint32_t>(wide_s2 % kMod);
+    }
+    return adler32_scalar(p, n, (s2 << 16) | s1);
+}
+#endif
+
+using Function = uint32_t (*)(const uint8_t*, std::size_t, uint32_t);
+
+#if defined(__AVX2__)
+constexpr Function best = adler32_avx2;
+#else
+constexpr Function best = adler32_scalar;
+#endif
+
+} // namespace checksum
+
+// ============================================================================
+// TYPED VIEWS
+// ============================================================================
+
+// Non-owning; valid while the bytes it points at are
+class FrameView {
+public:
+    FrameView(const uint8_t* frame, std::size_t size) : frame_(frame), size_(size) {}
+
+    uint32_t version() const { return wire::read<uint32_t>(frame_); }
+    uint32_t type() const { return wire::read<uint32_t>(frame_ + 8); }
+    std::size_t size() const { return size_; }
+    const uint8_t* data() const { return frame_; }
+
+protected:
+    const uint8_t* frame_;
+    std::size_t size_;
+};
+
+class V1View : public FrameView {
+public:
+    explicit V1View(FrameView f) : FrameView(f) {}
+
+    std::string_view payload() const {
+        return {reinterpret_cast<const char*>(frame_ + wire::kHeaderSize), size_ - wire::kHeaderSize};
+    }
+};
+
+class V2View : public FrameView {
+public:
+    explicit V2View(FrameView f) : FrameView(f) {}
+
+    uint32_t flags() const { return wire::read<uint32_t>(frame_ + 16); }
+    uint64_t timestamp() const { return wire::read<uint64_t>(frame_ + 20); }
+    std::string_view payload() const {
+        return {reinterpret_cast<const char*>(frame_ + wire::kV2HeaderSize), size_ - wire::kV2HeaderSize};
+    }
+};
+
+// ============================================================================
+// VERSION NEGOTIATION
+// ============================================================================
+
+struct VersionRange {
+    uint32_t min;
+    uint32_t max;
+};
+
+constexpr VersionRange kSupported{1, 2};
+
+// Highest version both sides speak
+std::optional<uint32_t> negotiate(VersionRange local, VersionRange remote) {
+    uint32_t hi = std::min(local.max, remote.max);
+    uint32_t lo = std::max(local.min, remote.min);
+    if (hi < lo) return std::nullopt;
+    return hi;
+}
+
+VersionRange parse_hello(FrameView f) {
+    if (f.type() != wire::kHelloType || f.size() != wire::kHeaderSize + 8) {
+        throw wire::ProtocolError("not a HELLO frame");
+    }
+    return {wire::read<uint32_t>(f.data() + 16), wire::read<uint32_t>(f.data() + 20)};
+}
+
+// ============================================================================
+// INCREMENTAL PARSER
+// ============================================================================
+
+class FrameParser {
+public:
+    struct Stats {
+        uint64_t frames = 0;
+        uint64_t reassembled = 0;     // frames that had to be copied together
+        uint64_t bad_checksum = 0;    // dropped
+    };
+
+    explicit FrameParser(VersionRange accepted = kSupported, checksum::Function sum = checksum::best)
+        : accepted_(accepted), checksum_(sum) {}
+
+    // Limits later frames to one version, e.g. after negotiation
+    void accept(VersionRange versions) { accepted_ = versions; }
+
+    // Calls on_frame(FrameView) for each complete, verified frame. Views of
+    // frames inside `data` point into it; a reassembled frame's view is
+    // valid only during the callback. Throws wire::ProtocolError on a bad
+    // header: without a resync marker the rest of the stream is lost.
+    template<typename Handler>
+    void feed(const uint8_t* data, std::size_t n, Handler&& on_frame) {
+        if (!pending_.empty()) {
+            if (pending_.size() < wire::kHeaderSize) {
+                std::size_t take = std::min(wire::kHeaderSize - pending_.size(), n);
+                pending_.insert(pending_.end(), data, data + take);
+                data += take;
+                n -= take;
+                if (pending_.size() < wire::kHeaderSize) return;
+            }
+            std::size_t need = frame_size(pending_.data());
+            std::size_t take = std::min(need - pending_.size(), n);
+            pending_.insert(pending_.end(), data, data + take);
+            data += take;
+            n -= take;
+            if (pending_.size() < need) return;
+            ++stats_.reassembled;
+            deliver(pending_.data(), need, on_frame);
+            pending_.clear();
+        }
+
+        // Zero-copy path: whole frames inside this chunk
+        while (n >= wire::kHeaderSize) {
+            std::size_t size = frame_size(data);
+            if (size > n) break;
+            deliver(data, size, on_frame);
+            data += size;
+            n -= size;
+        }
+        pending_.assign(data, data + n);
+    }
+
+    const Stats& stats() const { return stats_; }
+    std::size_t buffered() const { return pending_.size(); }
+
+private:
+    std::size_t frame_size(const uint8_t* header) const {
+        uint32_t version = wire::read<uint32_t>(header);
+        uint32_t size = wire::read<uint32_t>(header + 4);
+        bool hello = wire::read<uint32_t>(header + 8) == wire::kHelloType && version == 1;
+        if (!hello && (version < accepted_.min || version > accepted_.max)) {
+            throw wire::ProtocolError("unsupported version " + std::to_string(version));
+        }
+        std::size_t min_size = version == 2 ? wire::kV2HeaderSize : wire::kHeaderSize;
+        std::size_t max_size = version == 1 ? wire::kHeaderSize + wire::kV1MaxPayload : wire::kMaxFrame;
+        if (size < min_size || size > max_size) {
+            throw wire::ProtocolError("bad frame size " + std::to_string(size));
+        }
+        return size;
+    }
+
+    template<typename Handler>
+    void deliver(const uint8_t* frame, std::size_t size, Handler& on_frame) {
+        uint32_t expected = wire::read<uint32_t>(frame + 12);
+        if (checksum_(frame + wire::kHeaderSize, size - wire::kHeaderSize, 1) != expected) {
+            ++stats_.bad_checksum;
+            return;
+        }
+        ++stats_.frames;
+        on_frame(FrameView(frame, size));
+    }
+
+    VersionRange accepted_;
+    checksum::Function checksum_;
+    std::vector<uint8_t> pending_;   // capacity is kept across frames
+    Stats stats_;
+};
+
+// ============================================================================
+// POOLED WRITER
+// ============================================================================
+
+class BufferPool;
+
+// Growable byte buffer that goes back to its pool when destroyed
+class PooledBuffer {
+public:
+    PooledBuffer(PooledBuffer&& other) noexcept
+        : pool_(std::exchange(other.pool_, nullptr)), bytes_(std::move(other.bytes_)),
+          capacity_(other.capacity_), size_(other.size_) {}
+    PooledBuffer& operator=(PooledBuffer&&) = delete;
+    ~PooledBuffer();
+
+    const uint8_t* data() const { return bytes_.get(); }
+    std::size_t size() const { return size_; }
+    void clear() { size_ = 0; }
+
+    // Extends the buffer by n bytes and returns where they start
+    uint8_t* grow(std::size_t n) {
+        if (size_ + n > capacity_) {
+            std::size_t capacity = std::max(capacity_ * 2, size_ + n);
+            std::unique_ptr<uint8_t[]> bigger(new uint8_t[capacity]);
+            if (size_) std::memcpy(bigger.get(), bytes_.get(), size_);
+            bytes_ = std::move(bigger);
+            capacity_ = capacity;
+        }
+        uint8_t* at = bytes_.get() + size_;
+        size_ += n;
+        return at;
+    }
+
+private:
+    friend class BufferPool;
+    PooledBuffer(BufferPool* pool, std::unique_ptr<uint8_t[]> bytes, std::size_t capacity)
+        : pool_(pool), bytes_(std::move(bytes)), capacity_(capacity) {}
+
+    BufferPool* pool_;
+    std::unique_ptr<uint8_t[]> bytes_;
+    std::size_t capacity_;
+    std::size_t size_ = 0;
+};
+
+// Single-threaded; buffers keep whatever capacity they grew to
+class BufferPool {
+public:
+    explicit BufferPool(std::size_t initial_capacity) : initial_capacity_(initial_capacity) {}
+
+    PooledBuffer acquire() {
+        if (free_.empty()) {
+            ++allocated_;
+            return PooledBuffer(this, std::unique_ptr<uint8_t[]>(new uint8_t[initial_capacity_]), initial_capacity_);
+        }
+        Slot slot = std::move(free_.back());
+        free_.pop_back();
+        return PooledBuffer(this, std::move(slot.bytes), slot.capacity);
+    }
+
+    std::size_t allocated() const { return allocated_; }
+
+private:
+    friend class PooledBuffer;
+    struct Slot {
+        std::unique_ptr<uint8_t[]> bytes;
+        std::size_t capacity;
+    };
+
+    void release(std::unique_ptr<uint8_t[]> bytes, std::size_t capacity) {
+        free_.push_back({std::move(bytes), capacity});
+    }
+
+    std::size_t initial_capacity_;
+    std::size_t allocated_ = 0;
+    std::vector<Slot> free_;
+};
+
+PooledBuffer::~PooledBuffer() {
+    if (pool_ && bytes_) pool_->release(std::move(bytes_), capacity_);
+}
+
+class FrameWriter {
+public:
+    explicit FrameWriter(uint32_t version = kSupported.max) : version_(version) {}
+
+    void set_version(uint32_t version) { version_ = version; }
+    uint32_t version() const { return version_; }
+
+    // Appends one frame; flags and timestamp are dropped for v1
+    void append(PooledBuffer& out, uint32_t type, std::string_view payload, uint32_t flags = 0,
+                uint64_t timestamp = 0) const {
+        std::size_t header = version_ == 2 ? wire::kV2HeaderSize : wire::kHeaderSize;
+        if (version_ == 1 && payload.size() > wire::kV1MaxPayload) {
+            throw wire::ProtocolError("payload too large for v1");
+        }
+        std::size_t size = header + payload.size();
+        uint8_t* frame = out.grow(size);
+        wire::write<uint32_t>(frame, version_);
+        wire::write<uint32_t>(frame + 4, static_cast<uint32_t>(size));
+        wire::write<uint32_t>(frame + 8, type);
+        if (version_ == 2) {
+            wire::write<uint32_t>(frame + 16, flags);
+            wire::write<uint64_t>(frame + 20, timestamp);
+        }
+        if (!payload.empty()) std::memcpy(frame + header, payload.data(), payload.size());
+        wire::write<uint32_t>(frame + 12, checksum::best(frame + wire::kHeaderSize, size - wire::kHeaderSize, 1));
+    }
+
+    // HELLO is always v1 so any peer can read it
+    static void append_hello(PooledBuffer& out, VersionRange supported) {
+        uint8_t body[8];
+        wire::write<uint32_t>(body, supported.min);
+        wire::write<uint32_t>(body + 4, supported.max);
+        FrameWriter(1).append(out, wire::kHelloType, std::string_view(reinterpret_cast<const char*>(body), 8));
+    }
+
+private:
+    uint32_t version_;
+};
+
+// ============================================================================
+// DEMO AND BENCHMARK
+// ============================================================================
+
+using Clock = std::chrono::steady_clock;
+
+double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+void demo_negotiation() {
+    std::cout << "version negotiation:\n";
+    struct Case {
+        const char* name;
+        VersionRange client, server;
+    } cases[] = {{"new client, old server", {1, 2}, {1, 1}},
+                 {"both current", {1, 2}, {1, 2}},
+                 {"no overlap", {3, 4}, {1, 2}}};
+    BufferPool pool(64);
+    for (const Case& c : cases) {
+        PooledBuffer hello = pool.acquire();
+        FrameWriter::append_hello(hello, c.client);
+        FrameParser server_side(c.server);
+        std::optional<uint32_t> agreed;
+        server_side.feed(hello.data(), hello.size(), [&](FrameView f) { agreed = negotiate(c.server, parse_hello(f)); });
+        std::cout << "  " << std::left << std::setw(24) << c.name << std::right << "-> "
+                  << (agreed ? "v" + std::to_string(*agreed) : std::string("no common version")) << "\n";
+    }
+}
+
+void check_checksum() {
+    std::mt19937 rng(3);
+    std::vector<uint8_t> bytes(100'000);
+    for (auto& b : bytes) b = static_cast<uint8_t>(rng());
+    for (std::size_t n : {0, 1, 31, 32, 33, 5551, 5552, 5553, 11'104, 100'000}) {
+        if (checksum::adler32_scalar(bytes.data(), n) != checksum::best(bytes.data(), n, 1)) {
+            std::cerr << "checksum mismatch at n=" << n << "\n";
+            std::exit(1);
+        }
+    }
+    std::vector<uint8_t> ff(20'000, 0xff);   // worst case for the sums
+    if (checksum::adler32_scalar(ff.data(), ff.size()) != checksum::best(ff.data(), ff.size(), 1)) {
+        std::cerr << "checksum mismatch on 0xff bytes\n";
+        std::exit(1);
+    }
+
+    // Each round continues the previous checksum so none can be hoisted
+    const int rounds = 2000;
+    uint32_t sink = 1;
+    auto start = Clock::now();
+    for (int r = 0; r < rounds; ++r) sink = checksum::adler32_scalar(bytes.data(), bytes.size(), sink);
+    double scalar = seconds_since(start);
+    uint32_t chained = 1;
+    start = Clock::now();
+    for (int r = 0; r < rounds; ++r) chained = checksum::best(bytes.data(), bytes.size(), chained);
+    double best = seconds_since(start);
+    if (chained != sink) {
+        std::cerr << "chained checksum mismatch\n";
+        std::exit(1);
+    }
+    double gb = double(bytes.size()) * rounds / 1e9;
+    std::cout << "adler32 throughput: scalar " << std::fixed << std::setprecision(2) << gb / scalar << " GB/s, "
+#if defined(__AVX2__)
+              << "avx2 "
+#else
+              << "scalar (no AVX2) "
+#endif
+              << gb / best << " GB/s\n";
+}
+
+struct Workload {
+    std::vector<std::string> payloads;
+};
+
+Workload make_workload(std::size_t count) {
+    std::mt19937 rng(11);
+    Workload w;
+    w.payloads.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        w.payloads.emplace_back(16 + rng() % 240, static_cast<char>('a' + rng() % 26));
+    }
+    return w;
+}
+
+int main() {
+    check_checksum();
+    demo_negotiation();
+
+    const std::size_t count = 1'000'000;
+    const Workload w = make_workload(count);
+    std::cout << "\n" << count << " v2 frames, payload 16-255 bytes\n";
+
+    // Build: one owning vector per message vs pooled batches of 256 frames
+    auto start = Clock::now();
+    std::size_t naive_bytes = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::string& p = w.payloads[i];
+        std::vector<uint8_t> frame(wire::kV2HeaderSize + p.size());
+        wire::write<uint32_t>(frame.data(), 2);
+        wire::write<uint32_t>(frame.data() + 4, static_cast<uint32_t>(frame.size()));
+        wire::write<uint32_t>(frame.data() + 8, 7);
+        wire::write<uint32_t>(frame.data() + 16, 0);
+        wire::write<uint64_t>(frame.data() + 20, i);
+        std::memcpy(frame.data() + wire::kV2HeaderSize, p.data(), p.size());
+        wire::write<uint32_t>(frame.data() + 12,
+                              checksum::adler32_scalar(frame.data() + 16, frame.size() - 16));
+        naive_bytes += frame.size();
+    }
+    double naive_build = seconds_since(start);
+
+    BufferPool pool(64 * 1024);
+    FrameWriter writer(2);
+    auto build_batches = [&](auto&& send) {
+        for (std::size_t i = 0; i < count; i += 256) {
+            PooledBuffer batch = pool.acquire();
+            for (std::size_t j = i; j < std::min(count, i + 256); ++j) writer.append(batch, 7, w.payloads[j], 0, j);
+            send(batch);
+        }
+    };
+    std::size_t pooled_bytes = 0;
+    start = Clock::now();
+    build_batches([&](const PooledBuffer& batch) { pooled_bytes += batch.size(); });
+    double pooled_build = seconds_since(start);
+    if (pooled_bytes != naive_bytes) {
+        std::cerr << "pooled build size mismatch\n";
+        return 1;
+    }
+
+    std::vector<uint8_t> stream;   // what goes on the wire, for the parse benchmark
+    stream.reserve(pooled_bytes);
+    build_batches([&](const PooledBuffer& batch) { stream.insert(stream.end(), batch.data(), batch.data() + batch.size()); });
+    std::cout << std::fixed << std::setprecision(2) << "build  vector per message, scalar sum  "
+              << count / naive_build / 1e6 << " M msg/s\n"
+              << "build  pooled batches, best sum        " << count / pooled_build / 1e6 << " M msg/s ("
+              << pool.allocated() << " buffer allocated)\n";
+
+    // Parse: the stream arrives in random-sized chunks, so frames straddle
+    // chunk boundaries
+    std::mt19937 rng(5);
+    std::vector<std::size_t> chunks;
+    for (std::size_t off = 0; off < stream.size();) {
+        std::size_t c = std::min<std::size_t>(1 + rng() % 16384, stream.size() - off);
+        chunks.push_back(c);
+        off += c;
+    }
+
+    auto parse = [&](checksum::Function sum, bool copy_each, const char* label) {
+        FrameParser parser(kSupported, sum);
+        uint64_t timestamps = 0, payload_bytes = 0;
+        auto t0 = Clock::now();
+        std::size_t off = 0;
+        for (std::size_t c : chunks) {
+            parser.feed(stream.data() + off, c, [&](FrameView f) {
+                if (copy_each) {
+                    // what a parser returning owning messages would do
+                    std::vector<uint8_t> owned(f.data(), f.data() + f.size());
+                    V2View v(FrameView(owned.data(), owned.size()));
+                    timestamps += v.timestamp();
+                    payload_bytes += v.payload().size();
+                } else {
+                    V2View v(f);
+                    timestamps += v.timestamp();
+                    payload_bytes += v.payload().size();
+                }
+            });
+            off += c;
+        }
+        double s = seconds_since(t0);
+        bool ok = parser.stats().frames == count && parser.stats().bad_checksum == 0 &&
+                  timestamps == uint64_t(count) * (count - 1) / 2 && parser.buffered() == 0;
+        std::cout << "parse  " << std::left << std::setw(32) << label << std::right << count / s / 1e6
+                  << " M msg/s, " << stream.size() / s / 1e9 << " GB/s, " << parser.stats().reassembled
+                  << " reassembled" << (ok ? "" : "  MISMATCH") << "\n";
+        if (!ok) std::exit(1);
+        return payload_bytes;
+    };
+    parse(checksum::adler32_scalar, true, "copy per message, scalar sum");
+    parse(checksum::adler32_scalar, false, "zero-copy, scalar sum");
+    parse(checksum::best, false, "zero-copy, best sum");
+
+    // A corrupted frame is dropped, the stream continues
+    std::vector<uint8_t> corrupt(stream.begin(), stream.begin() + 4096);
+    corrupt[wire::kV2HeaderSize + 3] ^= 0x01;
+    FrameParser parser;
+    parser.feed(corrupt.data(), corrupt.size(), [](FrameView) {});
+    std::cout << "corrupted first payload byte: " << parser.stats().bad_checksum << " dropped, "
+              << parser.stats().frames << " delivered, " << parser.buffered() << " bytes awaiting more input\n";
+    return 0;
+}
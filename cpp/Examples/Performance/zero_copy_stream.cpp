@@ -0,0 +1,569 @@
+// ZERO-COPY OUTPUT STREAM DECORATORS
+//
+// The string-based decorator chain (Refreshers/26_design_patterns.cpp)
+// copies the payload at every layer: `buffer += data`, a new string per
+// compress, another per encrypt, then the sink. Here data travels as a list
+// of pooled 64 KB chunks whose ownership is handed down the chain:
+//   - caller bytes are copied exactly once, into a chunk
+//   - in-place transforms (XOR encryption) mutate the chunk they were given
+//   - size-changing transforms (compression) write into fresh pooled chunks
+//     and return the input chunks to the pool
+//   - the file sink flushes the whole list with one writev()
+//
+// Build: g++ -std=c++20 -O3 -march=native zero_copy_stream.cpp
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <span>
+#include <string>
+#include <sys/uio.h>
+#include <system_error>
+#include <unistd.h>
+#include <vector>
+
+using ByteSpan = std::span<const std::uint8_t>;
+
+
+// CHUNKS AND POOL
+
+struct Chunk {
+    static constexpr std::size_t CAPACITY = 64 * 1024;
+
+    std::size_t size = 0;
+    alignas(64) std::uint8_t data[CAPACITY];
+
+    std::size_t room() const { return CAPACITY - size; }
+    ByteSpan bytes() const { return {data, size}; }
+};
+
+class ChunkPool;
+
+struct ChunkReturn {
+    ChunkPool* pool;
+    void operator()(Chunk* c) const;
+};
+
+using ChunkPtr = std::unique_ptr<Chunk, ChunkReturn>;
+using ChunkList = std::vector<ChunkPtr>;
+
+// Single-threaded free list: a stream chain is driven by one thread
+class ChunkPool {
+public:
+    ChunkPool() = default;
+    ChunkPool(const ChunkPool&) = delete;
+    ChunkPool& operator=(const ChunkPool&) = delete;
+
+    ChunkPtr acquire() {
+        Chunk* c;
+        if (free_.empty()) {
+            c = new Chunk;
+            ++allocated_;
+        } else {
+            c = free_.back().release();
+            free_.pop_back();
+        }
+        c->size = 0;
+        return ChunkPtr(c, ChunkReturn{this});
+    }
+
+    void release(Chunk* c) { free_.emplace_back(c); }
+
+    std::size_t allocated() const { return allocated_; }
+
+private:
+    std::vector<std::unique_ptr<Chunk>> free_;
+    std::size_t allocated_ = 0;
+};
+
+inline void ChunkReturn::operator()(Chunk* c) const { pool->release(c); }
+
+
+// STREAM INTERFACE
+
+class OutputStream {
+public:
+    virtual ~OutputStream() = default;
+
+    // Copying entry point for callers that own their bytes
+    virtual void write(ByteSpan data) = 0;
+
+    // Zero-copy entry point: takes ownership of the chunks, leaves `chunks` empty
+    virtual void write(ChunkList& chunks) = 0;
+
+    virtual void flush() = 0;
+};
+
+// Sink: gathers the chunk list into an iovec array and issues one writev
+class FileStream : public OutputStream {
+public:
+    explicit FileStream(const std::string& path)
+        : fd(::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)) {
+        if (fd < 0) throw std::system_error(errno, std::generic_category(), "open " + path);
+    }
+
+    ~FileStream() override { ::close(fd); }
+
+    void write(ByteSpan data) override {
+        iovec iov{const_cast<std::uint8_t*>(data.data()), data.size()};
+        write_all(&iov, 1);
+    }
+
+    void write(ChunkList& chunks) override {
+        iovs.clear();
+        for (auto& c : chunks) {
+            if (c->size) iovs.push_back({c->data, c->size});
+        }
+        write_all(iovs.data(), iovs.size());
+        chunks.clear();   // back to the pool
+    }
+
+    void flush() override {}   // every write already reached the kernel
+
+private:
+    void write_all(iovec* iov, std::size_t count) {
+        while (count > 0) {
+            ssize_t n = ::writev(fd, iov, static_cast<int>(std::min<std::size_t>(count, IOV_MAX)));
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                throw std::system_error(errno, std::generic_category(), "writev");
+            }
+            // Partial write: skip the iovecs that went out, trim the next one
+            auto left = static_cast<std::size_t>(n);
+            while (count > 0 && left >= iov->iov_len) {
+                left -= iov->iov_len;
+                ++iov;
+                --count;
+            }
+            if (count > 0) {
+                iov->iov_base = static_cast<std::uint8_t*>(iov->iov_base) + left;
+                iov->iov_len -= left;
+            }
+        }
+    }
+
+    int fd;
+    std::vector<iovec> iovs;
+};
+
+class StreamDecorator : public OutputStream {
+public:
+    StreamDecorator(std::unique_ptr<OutputStream> stream, ChunkPool& pool)
+        : stream(std::move(stream)), pool(pool) {}
+
+    // Unbuffered spans are copied into chunks once and handed to the chunk path
+    void write(ByteSpan data) override {
+        ChunkList chunks;
+        while (!data.empty()) {
+            chunks.push_back(pool.acquire());
+            Chunk& c = *chunks.back();
+            std::size_t n = std::min(data.size(), Chunk::CAPACITY);
+            std::memcpy(c.data, data.data(), n);
+            c.size = n;
+            data = data.subspan(n);
+        }
+        write(chunks);
+    }
+
+    void write(ChunkList& chunks) override { stream->write(chunks); }
+
+    void flush() override { stream->flush(); }
+
+protected:
+    std::unique_ptr<OutputStream> stream;
+    ChunkPool& pool;
+};
+
+class BufferedStream : public StreamDecorator {
+public:
+    BufferedStream(std::unique_ptr<OutputStream> stream, ChunkPool& pool, std::size_t size = 256 * 1024)
+        : StreamDecorator(std::move(stream), pool), bufferSize(size) {}
+
+    // Call flush() to see write errors; a destructor must not throw
+    ~BufferedStream() override {
+        try {
+            flush_buffer();
+        } catch (const std::exception& e) {
+            std::cerr << "BufferedStream: flush on destruction failed: " << e.what() << "\n";
+        }
+    }
+
+    void write(ByteSpan data) override {
+        while (!data.empty()) {
+            if (buffer.empty() || buffer.back()->room() == 0) buffer.push_back(pool.acquire());
+            Chunk& c = *buffer.back();
+            std::size_t n = std::min(data.size(), c.room());
+            std::memcpy(c.data + c.size, data.data(), n);
+            c.size += n;
+            buffered += n;
+            data = data.subspan(n);
+            if (buffered >= bufferSize) flush_buffer();
+        }
+    }
+
+    // Already-chunked data is adopted, not copied
+    void write(ChunkList& chunks) override {
+        for (auto& c : chunks) {
+            buffered += c->size;
+            buffer.push_back(std::move(c));
+        }
+        chunks.clear();
+        if (buffered >= bufferSize) flush_buffer();
+    }
+
+    void flush() override {
+        flush_buffer();
+        StreamDecorator::flush();
+    }
+
+private:
+    void flush_buffer() {
+        if (buffer.empty()) return;
+        stream->write(buffer);
+        buffer.clear();
+        buffered = 0;
+    }
+
+    ChunkList buffer;
+    std::size_t buffered = 0;
+    std::size_t bufferSize;
+};
+
+
+// PACKBITS (run-length) CODEC, shared by both chains
+
+// Worst case: one header byte per 128 literals
+constexpr std::size_t packbits_bound(std::size_t n) { return n + (n + 127) / 128; }
+
+inline std::uint64_t load64(const std::uint8_t* p) { std::uint64_t v; std::memcpy(&v, p, 8); return v; }
+
+inline bool has_zero_byte(std::uint64_t v) {
+    return ((v - 0x0101010101010101ull) & ~v & 0x8080808080808080ull) != 0;
+}
+
+inline std::size_t packbits_encode(const std::uint8_t* src, std::size_t n, std::uint8_t* dst) {
+    std::uint8_t* op = dst;
+    std::size_t i = 0;
+    while (i < n) {
+        std::size_t run = 1;
+        while (i + run < n && run < 128 && src[i + run] == src[i]) ++run;
+        if (run >= 3) {
+            *op++ = static_cast<std::uint8_t>(257 - run);
+            *op++ = src[i];
+            i += run;
+            continue;
+        }
+        // Literal run: skip 8 positions at a time while no 3-byte repeat starts there
+        std::size_t start = i;
+        while (i < n && i - start < 128) {
+            if (i + 10 <= n && i - start + 8 <= 128) {
+                std::uint64_t w = load64(src + i);
+                if (!has_zero_byte((w ^ load64(src + i + 1)) | (w ^ load64(src + i + 2)))) {
+                    i += 8;
+                    continue;
+                }
+            }
+            if (i + 2 < n && src[i] == src[i + 1] && src[i] == src[i + 2]) break;
+            ++i;
+        }
+        *op++ = static_cast<std::uint8_t>(i - start - 1);
+        std::memcpy(op, src + start, i - start);
+        op += i - start;
+    }
+    return static_cast<std::size_t>(op - dst);
+}
+
+inline std::vector<std::uint8_t> packbits_decode(ByteSpan in) {
+    std::vector<std::uint8_t> out;
+    for (std::size_t i = 0; i < in.size();) {
+        std::uint8_t h = in[i++];
+        if (h < 128) {
+            std::size_t len = std::min<std::size_t>(h + 1u, in.size() - i);
+            out.insert(out.end(), in.begin() + i, in.begin() + i + len);
+            i += len;
+        } else if (h > 128 && i < in.size()) {
+            out.insert(out.end(), 257u - h, in[i++]);
+        }
+    }
+    return out;
+}
+
+class CompressedStream : public StreamDecorator {
+public:
+    using StreamDecorator::StreamDecorator;
+    using StreamDecorator::write;
+
+    // Size-changing transform: encode into fresh pooled chunks, packing each
+    // output chunk as full as the worst-case bound allows
+    void write(ChunkList& chunks) override {
+        ChunkList out;
+        for (auto& in : chunks) {
+            const std::uint8_t* src = in->data;
+            std::size_t left = in->size;
+            while (left > 0) {
+                if (out.empty() || out.back()->room() < 256) out.push_back(pool.acquire());
+                Chunk& c = *out.back();
+                std::size_t piece = std::min(left, (c.room() - 1) * 128 / 129);
+                c.size += packbits_encode(src, piece, c.data + c.size);
+                src += piece;
+                left -= piece;
+            }
+        }
+        chunks.clear();   // inputs return to the pool
+        stream->write(out);
+    }
+};
+
+class EncryptedStream : public StreamDecorator {
+public:
+    EncryptedStream(std::unique_ptr<OutputStream> stream, ChunkPool& pool, std::uint8_t key = 42)
+        : StreamDecorator(std::move(stream), pool), key(key) {}
+
+    using StreamDecorator::write;
+
+    // In-place transform: the chunk is ours, so mutate it and pass it on
+    void write(ChunkList& chunks) override {
+        for (auto& c : chunks) {
+            // Locals, so byte stores cannot alias c->size or key and the loop vectorises
+            std::uint8_t* p = c->data;
+            const std::size_t n = c->size;
+            const std::uint8_t k = key;
+            for (std::size_t i = 0; i < n; ++i) p[i] ^= k;
+        }
+        stream->write(chunks);
+    }
+
+private:
+    std::uint8_t key;
+};
+
+
+// STRING-BASED CHAIN (same shape as the refresher, real transforms, no printing)
+
+namespace legacy {
+
+class OutputStream {
+public:
+    virtual ~OutputStream() = default;
+    virtual void write(const std::string& data) = 0;
+    virtual void flush() = 0;
+};
+
+class FileStream : public OutputStream {
+public:
+    explicit FileStream(const std::string& path)
+        : fd(::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)) {
+        if (fd < 0) throw std::system_error(errno, std::generic_category(), "open " + path);
+    }
+    ~FileStream() override { ::close(fd); }
+
+    void write(const std::string& data) override {
+        for (std::size_t done = 0; done < data.size();) {
+            ssize_t n = ::write(fd, data.data() + done, data.size() - done);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                throw std::system_error(errno, std::generic_category(), "write");
+            }
+            done += static_cast<std::size_t>(n);
+        }
+    }
+    void flush() override {}
+
+private:
+    int fd;
+};
+
+class StreamDecorator : public OutputStream {
+public:
+    explicit StreamDecorator(std::unique_ptr<OutputStream> stream) : stream(std::move(stream)) {}
+    void write(const std::string& data) override { stream->write(data); }
+    void flush() override { stream->flush(); }
+
+protected:
+    std::unique_ptr<OutputStream> stream;
+};
+
+class BufferedStream : public StreamDecorator {
+public:
+    BufferedStream(std::unique_ptr<OutputStream> stream, std::size_t size)
+        : StreamDecorator(std::move(stream)), bufferSize(size) {}
+    ~BufferedStream() override {
+        try {
+            flush();
+        } catch (const std::exception& e) {
+            std::cerr << "legacy::BufferedStream: flush on destruction failed: " << e.what() << "\n";
+        }
+    }
+
+    void write(const std::string& data) override {
+        buffer += data;
+        if (buffer.size() >= bufferSize) flush();
+    }
+    void flush() override {
+        if (!buffer.empty()) {
+            stream->write(buffer);
+            buffer.clear();
+        }
+        StreamDecorator::flush();
+    }
+
+private:
+    std::string buffer;
+    std::size_t bufferSize;
+};
+
+class CompressedStream : public StreamDecorator {
+public:
+    using StreamDecorator::StreamDecorator;
+    void write(const std::string& data) override {
+        std::string compressed(packbits_bound(data.size()), '\0');
+        compressed.resize(packbits_encode(reinterpret_cast<const std::uint8_t*>(data.data()), data.size(),
+                                          reinterpret_cast<std::uint8_t*>(compressed.data())));
+        stream->write(compressed);
+    }
+};
+
+class EncryptedStream : public StreamDecorator {
+public:
+    EncryptedStream(std::unique_ptr<OutputStream> stream, std::uint8_t key)
+        : StreamDecorator(std::move(stream)), key(key) {}
+    void write(const std::string& data) override {
+        std::string encrypted = data;
+        for (char& c : encrypted) c = static_cast<char>(c ^ key);
+        stream->write(encrypted);
+    }
+
+private:
+    std::uint8_t key;
+};
+
+} // namespace legacy
+
+
+// BENCHMARK
+
+// Fixed-width records with space/zero padding, so run-length coding has work to do
+std::vector<std::string> make_records(std::size_t count) {
+    std::mt19937 rng(7);
+    std::vector<std::string> records;
+    records.reserve(count);
+    char line[256];
+    for (std::size_t i = 0; i < count; ++i) {
+        int n = std::snprintf(line, sizeof(line), "%012zu|%-24s|%010u|%-40s|\n", i,
+                              i % 3 ? "order.created" : "order.shipped",
+                              static_cast<unsigned>(rng() % 100000),
+                              rng() % 4 ? "ok" : "retry scheduled by upstream gateway");
+        records.emplace_back(line, static_cast<std::size_t>(n));
+    }
+    return records;
+}
+
+std::vector<std::uint8_t> decode_file(const std::string& path, std::uint8_t key, bool compressed) {
+    std::ifstream in(path, std::ios::binary);
+    std::vector<std::uint8_t> raw((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    for (auto& b : raw) b ^= key;
+    return compressed ? packbits_decode(raw) : raw;
+}
+
+template<typename F>
+double time_s(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double> s = std::chrono::steady_clock::now() - start;
+    return s.count();
+}
+
+constexpr std::uint8_t KEY = 123;
+constexpr std::size_t BUFFER_SIZE = 256 * 1024;
+
+// Buffered -> [Compressed ->] Encrypted -> File
+void run_string_chain(const std::vector<std::string>& records, const std::string& path, bool compress) {
+    std::unique_ptr<legacy::OutputStream> s = std::make_unique<legacy::FileStream>(path);
+    s = std::make_unique<legacy::EncryptedStream>(std::move(s), KEY);
+    if (compress) s = std::make_unique<legacy::CompressedStream>(std::move(s));
+    s = std::make_unique<legacy::BufferedStream>(std::move(s), BUFFER_SIZE);
+    for (auto& r : records) s->write(r);
+    s->flush();
+}
+
+void run_zero_copy_chain(const std::vector<std::string>& records, const std::string& path, bool compress,
+                         ChunkPool& pool) {
+    std::unique_ptr<OutputStream> s = std::make_unique<FileStream>(path);
+    s = std::make_unique<EncryptedStream>(std::move(s), pool, KEY);
+    if (compress) s = std::make_unique<CompressedStream>(std::move(s), pool);
+    s = std::make_unique<BufferedStream>(std::move(s), pool, BUFFER_SIZE);
+    for (auto& r : records) s->write(ByteSpan(reinterpret_cast<const std::uint8_t*>(r.data()), r.size()));
+    s->flush();
+}
+
+int main() {
+    const std::string zc_path = "/tmp/zero_copy_stream.bin";
+    const std::string string_path = "/tmp/string_stream.bin";
+
+    auto records = make_records(2'000'000);
+    std::string expected;
+    for (auto& r : records) expected += r;
+    double mb = expected.size() / 1e6;
+
+    auto matches = [&](const std::string& path, bool compressed) {
+        auto decoded = decode_file(path, KEY, compressed);
+        return decoded.size() == expected.size() && std::memcmp(decoded.data(), expected.data(), expected.size()) == 0;
+    };
+
+    std::cout.precision(4);
+    std::cout << records.size() << " records, " << mb << " MB\n";
+
+    ChunkPool pool;
+    for (bool compress : {true, false}) {
+        std::cout << (compress ? "buffered->compressed->encrypted->sink\n" : "buffered->encrypted->sink\n");
+
+        // /dev/null isolates the chain's own cost; a real file adds page-cache
+        // writeback, which dominates and is noisy
+        for (bool to_file : {false, true}) {
+            const std::string string_out = to_file ? string_path : "/dev/null";
+            const std::string zc_out = to_file ? zc_path : "/dev/null";
+
+            // Alternate the chains and keep the best of 5 so warmup favours neither
+            double string_s = 1e9, zc_s = 1e9;
+            for (int round = 0; round < 5; ++round) {
+                string_s = std::min(string_s, time_s([&] { run_string_chain(records, string_out, compress); }));
+                zc_s = std::min(zc_s, time_s([&] { run_zero_copy_chain(records, zc_out, compress, pool); }));
+            }
+
+            std::cout << "  " << (to_file ? "file     " : "/dev/null") << "  string chain " << mb / string_s
+                      << " MB/s, zero-copy chain " << mb / zc_s << " MB/s";
+            if (to_file && !(matches(string_path, compress) && matches(zc_path, compress))) {
+                std::cout << "  OUTPUT MISMATCH";
+            }
+            std::cout << "\n";
+        }
+    }
+    std::cout << "chunks ever allocated by the pool: " << pool.allocated() << "\n";
+
+    // A failed flush is reported by flush(); the destructor retries it and
+    // swallows the error instead of terminating
+    {
+        BufferedStream s(std::make_unique<FileStream>("/dev/full"), pool, BUFFER_SIZE);
+        s.write(ByteSpan(reinterpret_cast<const std::uint8_t*>(records[0].data()), records[0].size()));
+        try {
+            s.flush();
+            std::cout << "write to /dev/full did not fail\n";
+        } catch (const std::system_error& e) {
+            std::cout << "flush to /dev/full: " << e.what() << "\n";
+        }
+    }
+
+    std::remove(zc_path.c_str());
+    std::remove(string_path.c_str());
+}
@@ -74,6 +74,10 @@ struct HttpResponse {
     long responseTime{0};
 };
 
+// One blocking transfer per call. For high request rates see
+// Performance/async_http_client.cpp: curl multi handle with connection and
+// TLS session reuse, HTTP/2 multiplexing, a concurrency limit and a token
+// cache that refreshes ahead of expiry.
 class SecureHttpClient {
 public:
     SecureHttpClient();
@@ -123,6 +127,8 @@ private:
     
     // Security helpers
     std::string EncryptSensitiveData(const std::string& data);
+    // Prefer CURLOPT_PINNEDPUBLICKEY: curl checks it during the handshake,
+    // once per connection, instead of after every request
     bool ValidateServerCertificate(CURL* curl);
     
     // Token auto-refresh
@@ -0,0 +1,838 @@
+#ifndef BENCH_HARNESS_H
+#define BENCH_HARNESS_H
+
+// Microbenchmark harness, the grown-up version of PerformanceTest in
+// Refreshers/25_testing.cpp:
+//
+//   calibration   iterations per sample grow until one sample takes at
+//                 least min_sample_time, so timer resolution and call
+//                 overhead stop mattering
+//   statistics    per-sample ns/iteration; median, MAD and percentiles,
+//                 with samples more than outlier_mads scaled MADs from the
+//                 median dropped before mean/stddev/min/max
+//   pinning       optional sched affinity to one CPU for the whole run
+//   counters      perf_event_open, read around each timed start/stop section
+//                 and reported per iteration: cycles, instructions, cache
+//                 misses, branch misses (hardware; often missing in VMs and
+//                 containers) and page faults, context switches (software).
+//                 Events that cannot be opened are reported as NaN / null
+//   reports       JSON with the raw samples, read back by compare(), which
+//                 flags a change only if the median moved by more than a
+//                 threshold and a Mann-Whitney U test says the two sample
+//                 sets differ
+//
+// Usage, in the style of Google Benchmark:
+//
+//   bench::Result r = bench::run("vector_sum", [&](bench::State& state) {
+//       // untimed setup
+//       for (auto _ : state) bench::do_not_optimize(std::accumulate(...));
+//       state.set_items_processed(v.size());
+//   });
+//
+// The body runs once per sample; only the loop over state is timed, minus
+// any pause()/resume() sections inside it.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <istream>
+#include <iterator>
+#include <limits>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace bench {
+
+template<typename T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline void clobber_memory() { asm volatile("" : : : "memory"); }
+
+// ============================================================================
+// HARDWARE / SOFTWARE COUNTERS
+// ============================================================================
+
+enum Counter { cycles, instructions, cache_misses, branch_misses, page_faults, context_switches, counter_count };
+
+inline const char* counter_name(int c) {
+    static const char* const names[counter_count] = {"cycles", "instructions", "cache_misses",
+                                                      "branch_misses", "page_faults", "context_switches"};
+    return names[c];
+}
+
+using CounterValues = std::array<double, counter_count>;
+
+inline CounterValues no_counters() {
+    CounterValues v;
+    v.fill(std::numeric_limits<double>::quiet_NaN());
+    return v;
+}
+
+// One fd per event on the calling thread, always counting (hardware events
+// in user space only); callers take differences of read() snapshots. Values
+// are scaled by enabled/running time in case the kernel multiplexes the PMU.
+class PerfCounters {
+public:
+    struct Snapshot {
+        std::array<std::uint64_t, counter_count> value{}, enabled{}, running{};
+    };
+
+    PerfCounters() {
+        fds_.fill(-1);
+#if defined(__linux__)
+        static const std::uint32_t types[counter_count] = {PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+                                                           PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+                                                           PERF_TYPE_SOFTWARE, PERF_TYPE_SOFTWARE};
+        static const std::uint64_t configs[counter_count] = {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES,
+            PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_SW_PAGE_FAULTS, PERF_COUNT_SW_CONTEXT_SWITCHES};
+        for (int c = 0; c < counter_count; ++c) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof attr);
+            attr.size = sizeof attr;
+            attr.type = types[c];
+            attr.config = configs[c];
+            // Software events fire in the kernel (fault handler, scheduler)
+            attr.exclude_kernel = types[c] == PERF_TYPE_HARDWARE;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            fds_[c] = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+#endif
+    }
+
+    ~PerfCounters() {
+#if defined(__linux__)
+        for (int fd : fds_) {
+            if (fd >= 0) ::close(fd);
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool available(int c) const { return fds_[c] >= 0; }
+
+    bool any_available() const {
+        return std::any_of(fds_.begin(), fds_.end(), [](int fd) { return fd >= 0; });
+    }
+
+    Snapshot read() const {
+        Snapshot s;
+#if defined(__linux__)
+        for (int c = 0; c < counter_count; ++c) {
+            std::uint64_t buf[3];
+            if (fds_[c] >= 0 && ::read(fds_[c], buf, sizeof buf) == static_cast<ssize_t>(sizeof buf)) {
+                s.value[c] = buf[0];
+                s.enabled[c] = buf[1];
+                s.running[c] = buf[2];
+            }
+        }
+#endif
+        return s;
+    }
+
+    // Adds b - a to sum; unavailable events stay NaN
+    void accumulate(const Snapshot& a, const Snapshot& b, CounterValues& sum) const {
+        for (int c = 0; c < counter_count; ++c) {
+            if (!available(c)) continue;
+            double value = static_cast<double>(b.value[c] - a.value[c]);
+            std::uint64_t running = b.running[c] - a.running[c];
+            std::uint64_t enabled = b.enabled[c] - a.enabled[c];
+            if (running > 0 && running < enabled) value *= static_cast<double>(enabled) / static_cast<double>(running);
+            sum[c] = (std::isnan(sum[c]) ? 0.0 : sum[c]) + value;
+        }
+    }
+
+private:
+    std::array<int, counter_count> fds_;
+};
+
+// Pins the calling thread to one CPU until destroyed; a negative cpu or a
+// failed call leaves the affinity alone
+class CpuPin {
+public:
+    explicit CpuPin(int cpu) {
+#if defined(__linux__)
+        if (cpu < 0 || cpu >= CPU_SETSIZE) return;
+        if (pthread_getaffinity_np(pthread_self(), sizeof old_, &old_) != 0) return;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        if (pthread_setaffinity_np(pthread_self(), sizeof set, &set) == 0) cpu_ = cpu;
+#else
+        (void)cpu;
+#endif
+    }
+
+    ~CpuPin() {
+#if defined(__linux__)
+        if (cpu_ >= 0) pthread_setaffinity_np(pthread_self(), sizeof old_, &old_);
+#endif
+    }
+
+    CpuPin(const CpuPin&) = delete;
+    CpuPin& operator=(const CpuPin&) = delete;
+
+    int cpu() const { return cpu_; }
+
+private:
+    int cpu_ = -1;
+#if defined(__linux__)
+    cpu_set_t old_;
+#endif
+};
+
+// ============================================================================
+// STATE
+// ============================================================================
+
+class State {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // unused: `for (auto _ : state)` must not warn
+    struct __attribute__((unused)) Value {};
+
+    class iterator {
+    public:
+        iterator(State* state, std::uint64_t left) : state_(state), left_(left) {}
+        Value operator*() const { return {}; }
+        iterator& operator++() {
+            --left_;
+            return *this;
+        }
+        bool operator!=(const iterator&) {
+            if (left_ != 0) return true;
+            state_->stop();
+            return false;
+        }
+
+    private:
+        State* state_;
+        std::uint64_t left_;
+    };
+
+    State(std::uint64_t iterations, const PerfCounters* counters) : iterations_(iterations), counters_(counters) {}
+
+    iterator begin() {
+        started_loop_ = true;
+        start();
+        return iterator(this, iterations_);
+    }
+    iterator end() { return iterator(this, 0); }
+
+    std::uint64_t iterations() const { return iterations_; }
+
+    // Excludes a section of the loop (e.g. regenerating input) from timing
+    void pause() { stop(); }
+    void resume() { start(); }
+
+    // Per iteration, for items/s and bytes/s
+    void set_items_processed(std::uint64_t per_iteration) { items_ = per_iteration; }
+    void set_bytes_processed(std::uint64_t per_iteration) { bytes_ = per_iteration; }
+
+    bool completed() const { return started_loop_ && !running_; }
+    double elapsed_ns() const { return std::chrono::duration<double, std::nano>(elapsed_).count(); }
+    const CounterValues& counters() const { return counter_sum_; }
+    std::uint64_t items_processed() const { return items_; }
+    std::uint64_t bytes_processed() const { return bytes_; }
+
+private:
+    // Counters are read outside the timed window and the clock outside the
+    // counted one, so neither measures the other
+    void start() {
+        running_ = true;
+        if (counters_) snapshot_ = counters_->read();
+        started_ = Clock::now();
+    }
+
+    void stop() {
+        auto now = Clock::now();
+        elapsed_ += now - started_;
+        if (counters_) counters_->accumulate(snapshot_, counters_->read(), counter_sum_);
+        running_ = false;
+    }
+
+    std::uint64_t iterations_;
+    const PerfCounters* counters_;
+    bool started_loop_ = false;
+    bool running_ = false;
+    Clock::time_point started_;
+    Clock::duration elapsed_{};
+    PerfCounters::Snapshot snapshot_;
+    CounterValues counter_sum_ = no_counters();
+    std::uint64_t items_ = 0;
+    std::uint64_t bytes_ = 0;
+};
+
+// ============================================================================
+// STATISTICS
+// ============================================================================
+
+struct Options {
+    std::chrono::nanoseconds min_sample_time = std::chrono::milliseconds(10);
+    std::chrono::nanoseconds max_run_time = std::chrono::seconds(3);  // per benchmark, after calibration
+    std::size_t samples = 20;
+    std::size_t min_samples = 5;  // taken even past max_run_time
+    std::size_t warmup_samples = 2;
+    std::uint64_t max_iterations = std::uint64_t{1} << 32;
+    double outlier_mads = 5.0;
+    int pin_cpu = -1;
+    bool counters = true;
+};
+
+struct Result {
+    std::string name;
+    std::uint64_t iterations = 0;    // per sample
+    std::vector<double> samples_ns;  // ns per iteration, all samples in run order
+    std::size_t outliers = 0;
+    double outlier_mads = 0;         // the threshold that picked them
+
+    // ns per iteration
+    double median = 0, mad = 0;  // MAD scaled by 1.4826, comparable to a stddev
+    double p10 = 0, p90 = 0, p99 = 0;
+    double mean = 0, stddev = 0, min = 0, max = 0;  // without outliers
+
+    double items_per_second = 0;
+    double bytes_per_second = 0;
+    CounterValues counters = no_counters();  // per iteration
+    int pinned_cpu = -1;
+};
+
+// Linear interpolation between closest ranks
+inline double percentile(const std::vector<double>& sorted, double q) {
+    if (sorted.empty()) return std::numeric_limits<double>::quiet_NaN();
+    double pos = q * static_cast<double>(sorted.size() - 1);
+    std::size_t lo = static_cast<std::size_t>(pos);
+    std::size_t hi = std::min(lo + 1, sorted.size() - 1);
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (pos - static_cast<double>(lo));
+}
+
+inline void summarize(Result& r, double outlier_mads) {
+    if (r.samples_ns.empty()) throw std::invalid_argument("benchmark '" + r.name + "' has no samples");
+    r.outlier_mads = outlier_mads;
+    std::vector<double> sorted = r.samples_ns;
+    std::sort(sorted.begin(), sorted.end());
+    r.median = percentile(sorted, 0.5);
+    r.p10 = percentile(sorted, 0.10);
+    r.p90 = percentile(sorted, 0.90);
+    r.p99 = percentile(sorted, 0.99);
+
+    std::vector<double> deviation;
+    deviation.reserve(sorted.size());
+    for (double x : sorted) deviation.push_back(std::abs(x - r.median));
+    std::sort(deviation.begin(), deviation.end());
+    r.mad = 1.4826 * percentile(deviation, 0.5);
+
+    std::vector<double> kept;
+    for (double x : sorted) {
+        if (r.mad == 0 || std::abs(x - r.median) <= outlier_mads * r.mad) kept.push_back(x);
+    }
+    if (kept.empty()) kept = sorted;  // a threshold below the spread of the middle samples
+    r.outliers = sorted.size() - kept.size();
+
+    double sum = 0;
+    for (double x : kept) sum += x;
+    r.mean = sum / static_cast<double>(kept.size());
+    double sq = 0;
+    for (double x : kept) sq += (x - r.mean) * (x - r.mean);
+    r.stddev = kept.size() > 1 ? std::sqrt(sq / static_cast<double>(kept.size() - 1)) : 0.0;
+    r.min = kept.front();
+    r.max = kept.back();
+}
+
+// ============================================================================
+// RUNNER
+// ============================================================================
+
+inline Result run(const std::string& name, const std::function<void(State&)>& body, const Options& options = Options()) {
+    if (options.samples == 0) throw std::invalid_argument("Options::samples must be at least 1");
+    CpuPin pin(options.pin_cpu);
+    PerfCounters perf_storage;
+    const PerfCounters* perf = options.counters && perf_storage.any_available() ? &perf_storage : nullptr;
+
+    auto sample = [&](std::uint64_t iterations, const PerfCounters* counters) {
+        State state(iterations, counters);
+        body(state);
+        if (!state.completed()) throw std::logic_error("benchmark '" + name + "' did not run its state loop");
+        return state;
+    };
+
+    // Calibrate: aim past min_sample_time, growing at most 10x per step
+    const double target_ns = std::chrono::duration<double, std::nano>(options.min_sample_time).count();
+    std::uint64_t n = 1;
+    for (;;) {
+        double ns = sample(n, nullptr).elapsed_ns();
+        if (ns >= target_ns || n >= options.max_iterations) break;
+        double scale = ns > 0 ? 1.4 * target_ns / ns : 10.0;
+        n = std::min<std::uint64_t>(options.max_iterations,
+                                    std::max<std::uint64_t>(n + 1, static_cast<std::uint64_t>(
+                                                                       static_cast<double>(n) * std::min(scale, 10.0))));
+    }
+    for (std::size_t i = 0; i < options.warmup_samples; ++i) sample(n, nullptr);
+
+    Result r;
+    r.name = name;
+    r.iterations = n;
+    r.pinned_cpu = pin.cpu();
+    CounterValues counter_sum = no_counters();
+    std::uint64_t items = 0, bytes = 0;
+    auto deadline = State::Clock::now() + options.max_run_time;
+    const std::size_t min_samples = std::max<std::size_t>(options.min_samples, 1);
+    while (r.samples_ns.size() < options.samples &&
+           (r.samples_ns.size() < min_samples || State::Clock::now() < deadline)) {
+        State state = sample(n, perf);
+        r.samples_ns.push_back(state.elapsed_ns() / static_cast<double>(n));
+        for (int c = 0; c < counter_count; ++c) {
+            if (!std::isnan(state.counters()[c])) {
+                counter_sum[c] = (std::isnan(counter_sum[c]) ? 0.0 : counter_sum[c]) + state.counters()[c];
+            }
+        }
+        items = state.items_processed();
+        bytes = state.bytes_processed();
+    }
+
+    summarize(r, options.outlier_mads);
+    double total_iterations = static_cast<double>(n) * static_cast<double>(r.samples_ns.size());
+    for (int c = 0; c < counter_count; ++c) r.counters[c] = counter_sum[c] / total_iterations;
+    if (items) r.items_per_second = static_cast<double>(items) * 1e9 / r.median;
+    if (bytes) r.bytes_per_second = static_cast<double>(bytes) * 1e9 / r.median;
+    return r;
+}
+
+// ============================================================================
+// REPORTING
+// ============================================================================
+
+namespace detail {
+
+// Restores a caller's stream formatting on scope exit
+class FormatGuard {
+public:
+    explicit FormatGuard(std::ostream& out)
+        : out_(out), flags_(out.flags()), precision_(out.precision()), fill_(out.fill()) {}
+    ~FormatGuard() {
+        out_.flags(flags_);
+        out_.precision(precision_);
+        out_.fill(fill_);
+    }
+
+    FormatGuard(const FormatGuard&) = delete;
+    FormatGuard& operator=(const FormatGuard&) = delete;
+
+private:
+    std::ostream& out_;
+    std::ios_base::fmtflags flags_;
+    std::streamsize precision_;
+    char fill_;
+};
+
+} // namespace detail
+
+inline std::string format_ns(double ns) {
+    static const char* const units[] = {" ns", " us", " ms", " s"};
+    int unit = 0;
+    while (unit < 3 && ns >= 1000) {
+        ns /= 1000;
+        ++unit;
+    }
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(ns < 10 ? 2 : ns < 100 ? 1 : 0) << ns << units[unit];
+    return out.str();
+}
+
+inline std::string format_rate(double per_second, const char* unit) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+    if (per_second >= 1e9) out << per_second / 1e9 << " G";
+    else if (per_second >= 1e6) out << per_second / 1e6 << " M";
+    else if (per_second >= 1e3) out << per_second / 1e3 << " k";
+    else out << per_second << " ";
+    out << unit << "/s";
+    return out.str();
+}
+
+inline void print_header(std::ostream& out) {
+    out << std::left << std::setw(28) << "benchmark" << std::right << std::setw(11) << "median" << std::setw(8)
+        << "+-MAD" << std::setw(11) << "p90" << std::setw(10) << "iters" << std::setw(5) << "out" << std::setw(14)
+        << "throughput" << "  counters/iter\n";
+}
+
+inline void print(std::ostream& out, const Result& r) {
+    detail::FormatGuard guard(out);
+    std::ostringstream spread;
+    spread << std::fixed << std::setprecision(1) << 100.0 * r.mad / r.median << "%";
+    std::string rate = r.bytes_per_second > 0   ? format_rate(r.bytes_per_second, "B")
+                       : r.items_per_second > 0 ? format_rate(r.items_per_second, "item")
+                                                : "";
+    out << std::left << std::setw(28) << r.name << std::right << std::setw(11) << format_ns(r.median) << std::setw(8)
+        << spread.str() << std::setw(11) << format_ns(r.p90) << std::setw(10) << r.iterations << std::setw(5)
+        << r.outliers << std::setw(14) << rate << " ";
+    const CounterValues& c = r.counters;
+    out << std::fixed << std::setprecision(2);
+    if (!std::isnan(c[cycles]) && !std::isnan(c[instructions])) {
+        out << " IPC " << c[instructions] / c[cycles] << " cyc " << std::setprecision(0) << c[cycles];
+    }
+    if (!std::isnan(c[cache_misses])) out << std::setprecision(2) << " cmiss " << c[cache_misses];
+    if (!std::isnan(c[branch_misses])) out << std::setprecision(2) << " bmiss " << c[branch_misses];
+    if (!std::isnan(c[page_faults])) out << std::setprecision(3) << " pf " << c[page_faults];
+    if (!std::isnan(c[context_switches])) out << std::setprecision(3) << " cs " << c[context_switches];
+    out << "\n";
+}
+
+namespace detail {
+
+inline void write_json_string(std::ostream& out, const std::string& s) {
+    out << '"';
+    for (char ch : s) {
+        switch (ch) {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(ch) < 0x20) {
+                    FormatGuard guard(out);
+                    out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(ch);
+                } else {
+                    out << ch;
+                }
+        }
+    }
+    out << '"';
+}
+
+inline void write_json_number(std::ostream& out, double v) {
+    if (std::isfinite(v)) out << v;
+    else out << "null";
+}
+
+// Just enough JSON to read back write_json() output: objects, arrays,
+// strings, numbers, true/false/null
+struct JsonValue {
+    enum Kind { null, boolean, number, string, array, object } kind = null;
+    double num = 0;
+    bool flag = false;
+    std::string str;
+    std::vector<JsonValue> items;   // array elements, or object values
+    std::vector<std::string> keys;  // object keys, parallel to items
+
+    const JsonValue* find(const std::string& key) const {
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            if (keys[i] == key) return &items[i];
+        }
+        return nullptr;
+    }
+};
+
+class JsonParser {
+public:
+    explicit JsonParser(const std::string& text) : p_(text.data()), end_(text.data() + text.size()) {}
+
+    JsonValue parse() {
+        JsonValue v = value();
+        skip();
+        if (p_ != end_) fail("trailing characters");
+        return v;
+    }
+
+private:
+    [[noreturn]] void fail(const char* what) { throw std::runtime_error(std::string("bad benchmark JSON: ") + what); }
+
+    void skip() {
+        while (p_ != end_ && (*p_ == ' ' || *p_ == '\n' || *p_ == '\r' || *p_ == '\t')) ++p_;
+    }
+
+    bool consume(char c) {
+        skip();
+        if (p_ != end_ && *p_ == c) {
+            ++p_;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char c) {
+        if (!consume(c)) fail("unexpected character");
+    }
+
+    bool literal(const char* word) {
+        std::size_t n = std::strlen(word);
+        if (static_cast<std::size_t>(end_ - p_) >= n && std::memcmp(p_, word, n) == 0) {
+            p_ += n;
+            return true;
+        }
+        return false;
+    }
+
+    std::string string_value() {
+        expect('"');
+        std::string s;
+        while (p_ != end_ && *p_ != '"') {
+            char c = *p_++;
+            if (c != '\\') {
+                s += c;
+                continue;
+            }
+            if (p_ == end_) fail("truncated escape");
+            char e = *p_++;
+            switch (e) {
+                case 'n': s += '\n'; break;
+                case 't': s += '\t'; break;
+                case 'r': s += '\r'; break;
+                case 'b': s += '\b'; break;
+                case 'f': s += '\f'; break;
+                case 'u':
+                    if (end_ - p_ < 4) fail("truncated escape");
+                    s += static_cast<char>(std::stoi(std::string(p_, 4), nullptr, 16));  // ASCII only
+                    p_ += 4;
+                    break;
+                default: s += e;
+            }
+        }
+        if (p_ == end_) fail("unterminated string");
+        ++p_;
+        return s;
+    }
+
+    JsonValue value() {
+        skip();
+        if (p_ == end_) fail("unexpected end");
+        JsonValue v;
+        if (*p_ == '{') {
+            ++p_;
+            v.kind = JsonValue::object;
+            if (consume('}')) return v;
+            do {
+                skip();
+                v.keys.push_back(string_value());
+                expect(':');
+                v.items.push_back(value());
+            } while (consume(','));
+            expect('}');
+        } else if (*p_ == '[') {
+            ++p_;
+            v.kind = JsonValue::array;
+            if (consume(']')) return v;
+            do v.items.push_back(value());
+            while (consume(','));
+            expect(']');
+        } else if (*p_ == '"') {
+            v.kind = JsonValue::string;
+            v.str = string_value();
+        } else if (literal("true")) {
+            v.kind = JsonValue::boolean;
+            v.flag = true;
+        } else if (literal("false")) {
+            v.kind = JsonValue::boolean;
+        } else if (literal("null")) {
+            v.kind = JsonValue::null;
+        } else {
+            char* after = nullptr;
+            std::string rest(p_, std::min<std::size_t>(static_cast<std::size_t>(end_ - p_), 64));
+            v.kind = JsonValue::number;
+            v.num = std::strtod(rest.c_str(), &after);
+            if (after == rest.c_str()) fail("expected a value");
+            p_ += after - rest.c_str();
+        }
+        return v;
+    }
+
+    const char* p_;
+    const char* end_;
+};
+
+inline double json_number(const JsonValue& object, const char* key) {
+    const JsonValue* v = object.find(key);
+    return v && v->kind == JsonValue::number ? v->num : std::numeric_limits<double>::quiet_NaN();
+}
+
+} // namespace detail
+
+inline void write_json(std::ostream& out, const std::vector<Result>& results) {
+    detail::FormatGuard guard(out);
+    out << std::defaultfloat << std::setprecision(10) << "{\n  \"benchmarks\": [";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        out << (i ? ",\n" : "\n") << "    {\"name\": ";
+        detail::write_json_string(out, r.name);
+        out << ", \"iterations\": " << r.iterations << ", \"pinned_cpu\": " << r.pinned_cpu;
+        const std::pair<const char*, double> stats[] = {
+            {"median_ns", r.median}, {"mad_ns", r.mad}, {"p10_ns", r.p10}, {"p90_ns", r.p90},
+            {"p99_ns", r.p99}, {"mean_ns", r.mean}, {"stddev_ns", r.stddev}, {"min_ns", r.min},
+            {"max_ns", r.max}, {"items_per_second", r.items_per_second}, {"bytes_per_second", r.bytes_per_second},
+            {"outlier_mads", r.outlier_mads}};
+        for (const auto& [key, value] : stats) {
+            out << ", \"" << key << "\": ";
+            detail::write_json_number(out, value);
+        }
+        out << ", \"outliers\": " << r.outliers << ",\n     \"counters\": {";
+        for (int c = 0; c < counter_count; ++c) {
+            out << (c ? ", " : "") << '"' << counter_name(c) << "\": ";
+            detail::write_json_number(out, r.counters[c]);
+        }
+        out << "},\n     \"samples_ns\": [";
+        for (std::size_t s = 0; s < r.samples_ns.size(); ++s) {
+            out << (s ? ", " : "");
+            detail::write_json_number(out, r.samples_ns[s]);
+        }
+        out << "]}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+inline std::vector<Result> read_json(std::istream& in) {
+    std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    detail::JsonValue root = detail::JsonParser(text).parse();
+    const detail::JsonValue* list = root.find("benchmarks");
+    if (!list || list->kind != detail::JsonValue::array) throw std::runtime_error("bad benchmark JSON: no benchmarks");
+
+    std::vector<Result> results;
+    for (const detail::JsonValue& b : list->items) {
+        const detail::JsonValue* name = b.find("name");
+        const detail::JsonValue* samples = b.find("samples_ns");
+        if (!name || !samples || samples->items.empty()) throw std::runtime_error("bad benchmark JSON: entry");
+        Result r;
+        r.name = name->str;
+        r.iterations = static_cast<std::uint64_t>(detail::json_number(b, "iterations"));
+        for (const detail::JsonValue& s : samples->items) r.samples_ns.push_back(s.num);
+        // Reports written before outlier_mads was recorded used the default
+        double outlier_mads = detail::json_number(b, "outlier_mads");
+        summarize(r, std::isnan(outlier_mads) ? Options().outlier_mads : outlier_mads);
+        r.items_per_second = detail::json_number(b, "items_per_second");
+        r.bytes_per_second = detail::json_number(b, "bytes_per_second");
+        if (const detail::JsonValue* counters = b.find("counters")) {
+            for (int c = 0; c < counter_count; ++c) r.counters[c] = detail::json_number(*counters, counter_name(c));
+        }
+        results.push_back(std::move(r));
+    }
+    return results;
+}
+
+// ============================================================================
+// REGRESSION COMPARATOR
+// ============================================================================
+
+// Two-sided p-value that a and b come from the same distribution (normal
+// approximation with tie-corrected variance; fine from ~8 samples each)
+inline double mann_whitney_p(const std::vector<double>& a, const std::vector<double>& b) {
+    std::vector<std::pair<double, int>> all;
+    for (double x : a) all.push_back({x, 0});
+    for (double x : b) all.push_back({x, 1});
+    std::sort(all.begin(), all.end());
+
+    double rank_sum_a = 0, tie_term = 0;
+    for (std::size_t i = 0; i < all.size();) {
+        std::size_t j = i;
+        while (j < all.size() && all[j].first == all[i].first) ++j;
+        double rank = (static_cast<double>(i + j) + 1.0) / 2.0;  // average of ranks i+1 .. j
+        for (std::size_t k = i; k < j; ++k) {
+            if (all[k].second == 0) rank_sum_a += rank;
+        }
+        double t = static_cast<double>(j - i);
+        tie_term += t * t * t - t;
+        i = j;
+    }
+    double n1 = static_cast<double>(a.size()), n2 = static_cast<double>(b.size()), n = n1 + n2;
+    double u = rank_sum_a - n1 * (n1 + 1) / 2;
+    double variance = n1 * n2 / 12.0 * ((n + 1) - tie_term / (n * (n - 1)));
+    if (variance <= 0) return 1.0;
+    double z = (u - n1 * n2 / 2) / std::sqrt(variance);
+    return std::erfc(std::abs(z) / std::sqrt(2.0));
+}
+
+struct Comparison {
+    enum Verdict { same, faster, slower, only_baseline, only_current };
+    std::string name;
+    Verdict verdict = same;
+    double baseline_median = 0, current_median = 0;
+    double change = 0;  // current / baseline - 1
+    double p_value = 1;
+};
+
+// A change counts only if the medians differ by more than threshold AND the
+// samples differ at significance alpha; either alone is noise or too small
+// to care about
+inline std::vector<Comparison> compare(const std::vector<Result>& baseline, const std::vector<Result>& current,
+                                       double threshold = 0.05, double alpha = 0.01) {
+    std::vector<Comparison> out;
+    for (const Result& cur : current) {
+        Comparison c;
+        c.name = cur.name;
+        c.current_median = cur.median;
+        auto base = std::find_if(baseline.begin(), baseline.end(), [&](const Result& b) { return b.name == cur.name; });
+        if (base == baseline.end()) {
+            c.verdict = Comparison::only_current;
+            out.push_back(c);
+            continue;
+        }
+        c.baseline_median = base->median;
+        c.change = cur.median / base->median - 1.0;
+        c.p_value = mann_whitney_p(base->samples_ns, cur.samples_ns);
+        if (c.p_value < alpha && std::abs(c.change) > threshold) {
+            c.verdict = c.change > 0 ? Comparison::slower : Comparison::faster;
+        }
+        out.push_back(c);
+    }
+    for (const Result& b : baseline) {
+        if (std::none_of(current.begin(), current.end(), [&](const Result& r) { return r.name == b.name; })) {
+            Comparison c;
+            c.name = b.name;
+            c.verdict = Comparison::only_baseline;
+            c.baseline_median = b.median;
+            out.push_back(c);
+        }
+    }
+    return out;
+}
+
+inline void print(std::ostream& out, const std::vector<Comparison>& comparisons) {
+    static const char* const verdicts[] = {"same", "FASTER", "SLOWER", "removed", "new"};
+    out << std::left << std::setw(28) << "benchmark" << std::right << std::setw(11) << "baseline" << std::setw(11)
+        << "current" << std::setw(9) << "change" << std::setw(10) << "p" << "  verdict\n";
+    for (const Comparison& c : comparisons) {
+        out << std::left << std::setw(28) << c.name << std::right << std::setw(11)
+            << (c.verdict == Comparison::only_current ? "-" : format_ns(c.baseline_median)) << std::setw(11)
+            << (c.verdict == Comparison::only_baseline ? "-" : format_ns(c.current_median));
+        if (c.verdict == Comparison::only_current || c.verdict == Comparison::only_baseline) {
+            out << std::setw(9) << "" << std::setw(10) << "";
+        } else {
+            std::ostringstream change, p;
+            change << std::showpos << std::fixed << std::setprecision(1) << 100.0 * c.change << "%";
+            p << std::setprecision(2) << c.p_value;
+            out << std::setw(9) << change.str() << std::setw(10) << p.str();
+        }
+        out << "  " << verdicts[c.verdict] << "\n";
+    }
+}
+
+inline bool has_regression(const std::vector<Comparison>& comparisons) {
+    return std::any_of(comparisons.begin(), comparisons.end(),
+                       [](const Comparison& c) { return c.verdict == Comparison::slower; });
+}
+
+} // namespace bench
+
+#endif  // BENCH_HARNESS_H
@@ -1,11 +1,14 @@
-#include <functional>
 #include <vector>
 #include <memory>
 
+#include "small_function.hpp"
+
 template<typename EventType>
 class SimpleEventDispatcher {
 private:
-    using Handler = std::function<void(const EventType&)>;
+    // Handlers are moved in once and called many times; small captures stay
+    // inline in the vector instead of each living in its own heap block
+    using Handler = small_function<void(const EventType&)>;
     std::vector<Handler> handlers_;
     
 public:
@@ -0,0 +1,513 @@
+#ifndef MEMORY_RESOURCES_H
+#define MEMORY_RESOURCES_H
+
+// std::pmr::memory_resource versions of the hand-written allocators, so any
+// pmr container (pmr::vector, pmr::string, pmr::unordered_map, ...) can use
+// them, and they can be stacked:
+//
+//   ArenaResource          LinearAllocator, StackAllocator, ArenaAllocator:
+//                          bump allocation, free is a no-op, release() drops
+//                          everything; over a caller buffer or upstream blocks
+//   FixedPoolResource      PoolAllocator<T, N>, CustomAllocator: free list of
+//                          equal-size blocks; other sizes go upstream
+//                          (as a FallbackResource primary: to the fallback)
+//   AlignedResource        AlignedAllocator: raises every request to a
+//                          minimum alignment (cache line, SIMD width)
+//   FallbackResource       primary first, fallback when the primary is full
+//   SynchronizedResource   one mutex around an unsynchronized resource
+//   PerThreadResource      one lazily created instance per thread, no lock
+//   ProfilingResource      opt-in: allocation counts and bytes per call site,
+//                          a size histogram, current and peak usage
+//
+// Like the std::pmr resources, ArenaResource and FixedPoolResource are not
+// thread-safe; wrap them in SynchronizedResource or PerThreadResource.
+// MinimalAllocator<T> is std::pmr::polymorphic_allocator<T>.
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Resources that can say whether they handed out a pointer, and can fail
+// without throwing; both are needed to put them in front of a fallback
+class OwningResource : public std::pmr::memory_resource {
+public:
+    virtual bool owns(const void* p) const noexcept = 0;
+    virtual void* try_allocate(std::size_t bytes, std::size_t alignment) noexcept = 0;
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        if (void* p = try_allocate(bytes, alignment)) return p;
+        throw std::bad_alloc();
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+// ============================================================================
+// ARENA
+// ============================================================================
+
+class ArenaResource : public OwningResource {
+public:
+    // Grows by allocating blocks of at least block_size from upstream
+    explicit ArenaResource(std::size_t block_size = 64 * 1024,
+                           std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : upstream_(upstream), block_size_(block_size) {}
+
+    // Serves from [buffer, buffer + size) first; with no upstream it never
+    // grows and fails when the buffer is full (the StackAllocator case)
+    ArenaResource(void* buffer, std::size_t size, std::pmr::memory_resource* upstream = nullptr)
+        : upstream_(upstream), block_size_(size), initial_(static_cast<char*>(buffer)), initial_size_(size),
+          current_(initial_), end_(initial_ + size) {}
+
+    ArenaResource(const ArenaResource&) = delete;
+    ArenaResource& operator=(const ArenaResource&) = delete;
+
+    ~ArenaResource() override { release(); }
+
+    // Frees every allocation at once
+    void release() noexcept {
+        while (blocks_) {
+            Block* prev = blocks_->prev;
+            upstream_->deallocate(blocks_, blocks_->size, alignof(std::max_align_t));
+            blocks_ = prev;
+        }
+        current_ = initial_;
+        end_ = initial_ ? initial_ + initial_size_ : nullptr;
+        used_ = 0;
+    }
+
+    std::size_t used() const noexcept { return used_; }
+
+    bool owns(const void* p) const noexcept override {
+        auto in = [p](const char* begin, std::size_t size) {
+            return std::less_equal<const void*>()(begin, p) && std::less<const void*>()(p, begin + size);
+        };
+        if (initial_ && in(initial_, initial_size_)) return true;
+        for (const Block* b = blocks_; b; b = b->prev) {
+            if (in(reinterpret_cast<const char*>(b), b->size)) return true;
+        }
+        return false;
+    }
+
+    void* try_allocate(std::size_t bytes, std::size_t alignment) noexcept override {
+        if (void* p = bump(bytes, alignment)) return p;
+        if (!upstream_ || !grow(bytes + alignment)) return nullptr;
+        return bump(bytes, alignment);
+    }
+
+protected:
+    void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+private:
+    struct alignas(std::max_align_t) Block {
+        Block* prev;
+        std::size_t size;
+    };
+
+    void* bump(std::size_t bytes, std::size_t alignment) noexcept {
+        if (!current_) return nullptr;
+        auto addr = reinterpret_cast<std::uintptr_t>(current_);
+        auto aligned = (addr + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+        if (aligned + bytes > reinterpret_cast<std::uintptr_t>(end_)) return nullptr;
+        current_ = reinterpret_cast<char*>(aligned + bytes);
+        used_ += bytes;
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    bool grow(std::size_t min_bytes) noexcept {
+        std::size_t size = std::max(block_size_, min_bytes + sizeof(Block));
+        void* mem;
+        try {
+            mem = upstream_->allocate(size, alignof(std::max_align_t));
+        } catch (...) {
+            return false;
+        }
+        blocks_ = ::new (mem) Block{blocks_, size};
+        current_ = reinterpret_cast<char*>(blocks_ + 1);
+        end_ = reinterpret_cast<char*>(mem) + size;
+        return true;
+    }
+
+    std::pmr::memory_resource* upstream_;
+    std::size_t block_size_;
+    char* initial_ = nullptr;
+    std::size_t initial_size_ = 0;
+    char* current_ = nullptr;
+    char* end_ = nullptr;
+    Block* blocks_ = nullptr;
+    std::size_t used_ = 0;
+};
+
+// ============================================================================
+// FIXED-SIZE POOL
+// ============================================================================
+
+class FixedPoolResource : public OwningResource {
+public:
+    // Requests up to block_size bytes (alignment up to max_align_t) come from
+    // the pool; allocate() passes anything else through to upstream.
+    // try_allocate() only serves pooled sizes, so owns() covers everything
+    // it hands out and a FallbackResource frees other sizes in its fallback
+    explicit FixedPoolResource(std::size_t block_size, std::size_t blocks_per_chunk = 1024,
+                               std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : upstream_(upstream),
+          block_size_(round_up(std::max(block_size, sizeof(Node)), alignof(std::max_align_t))),
+          blocks_per_chunk_(blocks_per_chunk) {}
+
+    FixedPoolResource(const FixedPoolResource&) = delete;
+    FixedPoolResource& operator=(const FixedPoolResource&) = delete;
+
+    ~FixedPoolResource() override {
+        for (auto& chunk : chunks_) upstream_->deallocate(chunk.first, chunk.second, alignof(std::max_align_t));
+    }
+
+    std::size_t block_size() const noexcept { return block_size_; }
+
+    bool owns(const void* p) const noexcept override {
+        for (auto& chunk : chunks_) {
+            if (std::less_equal<const void*>()(chunk.first, p) &&
+                std::less<const void*>()(p, static_cast<const char*>(chunk.first) + chunk.second)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void* try_allocate(std::size_t bytes, std::size_t alignment) noexcept override {
+        if (!pooled(bytes, alignment)) return nullptr;
+        if (!free_ && !add_chunk()) return nullptr;
+        Node* node = free_;
+        free_ = node->next;
+        return node;
+    }
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        if (!pooled(bytes, alignment)) return upstream_->allocate(bytes, alignment);
+        return OwningResource::do_allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        if (!pooled(bytes, alignment)) {
+            upstream_->deallocate(p, bytes, alignment);
+            return;
+        }
+        free_ = ::new (p) Node{free_};
+    }
+
+private:
+    struct Node {
+        Node* next;
+    };
+
+    static std::size_t round_up(std::size_t n, std::size_t to) { return (n + to - 1) / to * to; }
+
+    bool pooled(std::size_t bytes, std::size_t alignment) const noexcept {
+        return bytes <= block_size_ && alignment <= alignof(std::max_align_t);
+    }
+
+    bool add_chunk() noexcept {
+        std::size_t size = block_size_ * blocks_per_chunk_;
+        char* chunk;
+        try {
+            chunks_.reserve(chunks_.size() + 1);
+            chunk = static_cast<char*>(upstream_->allocate(size, alignof(std::max_align_t)));
+        } catch (...) {
+            return false;
+        }
+        chunks_.emplace_back(chunk, size);
+        for (std::size_t i = blocks_per_chunk_; i-- > 0;) free_ = ::new (chunk + i * block_size_) Node{free_};
+        return true;
+    }
+
+    std::pmr::memory_resource* upstream_;
+    std::size_t block_size_;
+    std::size_t blocks_per_chunk_;
+    Node* free_ = nullptr;
+    std::vector<std::pair<void*, std::size_t>> chunks_;
+};
+
+// ============================================================================
+// ALIGNMENT
+// ============================================================================
+
+class AlignedResource : public std::pmr::memory_resource {
+public:
+    explicit AlignedResource(std::size_t min_alignment,
+                             std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : upstream_(upstream), min_alignment_(min_alignment) {}
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        return upstream_->allocate(bytes, std::max(alignment, min_alignment_));
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        upstream_->deallocate(p, bytes, std::max(alignment, min_alignment_));
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+private:
+    std::pmr::memory_resource* upstream_;
+    std::size_t min_alignment_;
+};
+
+// ============================================================================
+// COMPOSITION
+// ============================================================================
+
+// Typical chain: ArenaResource over a stack buffer, falling back to the heap
+class FallbackResource : public std::pmr::memory_resource {
+public:
+    FallbackResource(OwningResource& primary, std::pmr::memory_resource& fallback)
+        : primary_(primary), fallback_(fallback) {}
+
+    std::uint64_t fallback_count() const noexcept { return fallbacks_.load(std::memory_order_relaxed); }
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        if (void* p = primary_.try_allocate(bytes, alignment)) return p;
+        fallbacks_.fetch_add(1, std::memory_order_relaxed);
+        return fallback_.allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        if (primary_.owns(p)) {
+            primary_.deallocate(p, bytes, alignment);
+        } else {
+            fallback_.deallocate(p, bytes, alignment);
+        }
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+private:
+    OwningResource& primary_;
+    std::pmr::memory_resource& fallback_;
+    std::atomic<std::uint64_t> fallbacks_{0};
+};
+
+class SynchronizedResource : public std::pmr::memory_resource {
+public:
+    explicit SynchronizedResource(std::pmr::memory_resource& upstream) : upstream_(upstream) {}
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return upstream_.allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        upstream_.deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+private:
+    std::pmr::memory_resource& upstream_;
+    std::mutex mutex_;
+};
+
+// Each thread allocates from its own instance, made by `factory` on first
+// use. Instances live as long as this object, not the thread, and a block
+// freed on another thread goes to that thread's instance: fine for pools
+// of one block size and for arenas, wrong for resources that must get their
+// own pointers back.
+class PerThreadResource : public std::pmr::memory_resource {
+public:
+    using Factory = std::function<std::unique_ptr<std::pmr::memory_resource>()>;
+
+    explicit PerThreadResource(Factory factory) : factory_(std::move(factory)) {}
+
+    std::size_t instance_count() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return instances_.size();
+    }
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        return local().allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        local().deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+private:
+    struct Slot {
+        std::uint64_t owner;
+        std::pmr::memory_resource* resource;
+    };
+
+    std::pmr::memory_resource& local() {
+        // Keyed by a never-reused id, not `this`, so a slot left by a
+        // destroyed PerThreadResource can't match a new one at the same address
+        thread_local std::vector<Slot> slots;
+        thread_local Slot last{0, nullptr};
+        if (last.owner == id_) return *last.resource;
+        for (auto& slot : slots) {
+            if (slot.owner == id_) {
+                last = slot;
+                return *slot.resource;
+            }
+        }
+        std::pmr::memory_resource* created;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            instances_.push_back(factory_());
+            created = instances_.back().get();
+        }
+        slots.push_back({id_, created});
+        last = slots.back();
+        return *created;
+    }
+
+    static std::uint64_t next_id() {
+        static std::atomic<std::uint64_t> counter{1};
+        return counter.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const std::uint64_t id_ = next_id();
+    Factory factory_;
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<std::pmr::memory_resource>> instances_;
+};
+
+// ============================================================================
+// PROFILING
+// ============================================================================
+
+// Names the code allocating on this thread until it goes out of scope. The
+// name must be a string literal (or otherwise outlive the profiler).
+class AllocationSite {
+public:
+    explicit AllocationSite(const char* name) noexcept : previous_(current()) { current() = name; }
+    ~AllocationSite() { current() = previous_; }
+
+    AllocationSite(const AllocationSite&) = delete;
+    AllocationSite& operator=(const AllocationSite&) = delete;
+
+    static const char*& current() noexcept {
+        thread_local const char* site = "(untagged)";
+        return site;
+    }
+
+private:
+    const char* previous_;
+};
+
+#define MR_STRINGIFY_(x) #x
+#define MR_STRINGIFY(x) MR_STRINGIFY_(x)
+#define MR_CONCAT_(a, b) a##b
+#define MR_CONCAT(a, b) MR_CONCAT_(a, b)
+// Tags the rest of the enclosing scope with "file:line"
+#define ALLOCATION_SITE() AllocationSite MR_CONCAT(allocation_site_, __LINE__)(__FILE__ ":" MR_STRINGIFY(__LINE__))
+
+// Wrap any resource to see who allocates what. Adds a lock and a hash
+// lookup per call, so it is for measurement runs, not production.
+class ProfilingResource : public std::pmr::memory_resource {
+public:
+    static constexpr std::size_t kBuckets = 24;   // <= 8 B, <= 16 B, ... <= 32 MB, larger
+
+    struct SiteStats {
+        std::uint64_t allocations = 0;
+        std::uint64_t bytes = 0;
+    };
+
+    struct Snapshot {
+        std::uint64_t allocations = 0;
+        std::uint64_t deallocations = 0;
+        std::uint64_t bytes_allocated = 0;
+        std::size_t current_bytes = 0;
+        std::size_t peak_bytes = 0;
+        std::uint64_t by_size[kBuckets] = {};
+        std::vector<std::pair<std::string, SiteStats>> sites;   // most bytes first
+    };
+
+    explicit ProfilingResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : upstream_(upstream) {}
+
+    Snapshot snapshot() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Snapshot s = totals_;
+        for (auto& [site, stats] : sites_) s.sites.emplace_back(site, stats);
+        std::sort(s.sites.begin(), s.sites.end(),
+                  [](auto& a, auto& b) { return a.second.bytes > b.second.bytes; });
+        return s;
+    }
+
+    void report(std::ostream& out, std::size_t top_sites = 10) const {
+        Snapshot s = snapshot();
+        out << "allocations " << s.allocations << ", deallocations " << s.deallocations << ", bytes "
+            << s.bytes_allocated << ", live " << s.current_bytes << ", peak " << s.peak_bytes << "\n";
+        out << "by size:\n";
+        for (std::size_t b = 0; b < kBuckets; ++b) {
+            if (!s.by_size[b]) continue;
+            out << "  " << (b + 1 < kBuckets ? "<= " : " > ") << std::setw(9) << bucket_limit(b) << " B  "
+                << std::setw(10) << s.by_size[b] << "\n";
+        }
+        out << "by site:\n";
+        for (std::size_t i = 0; i < s.sites.size() && i < top_sites; ++i) {
+            out << "  " << std::setw(10) << s.sites[i].second.bytes << " B in " << std::setw(8)
+                << s.sites[i].second.allocations << " allocations  " << s.sites[i].first << "\n";
+        }
+    }
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        void* p = upstream_->allocate(bytes, alignment);
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++totals_.allocations;
+        totals_.bytes_allocated += bytes;
+        totals_.current_bytes += bytes;
+        totals_.peak_bytes = std::max(totals_.peak_bytes, totals_.current_bytes);
+        ++totals_.by_size[bucket(bytes)];
+        SiteStats& site = sites_[AllocationSite::current()];
+        ++site.allocations;
+        site.bytes += bytes;
+        return p;
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        upstream_->deallocate(p, bytes, alignment);
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++totals_.deallocations;
+        totals_.current_bytes -= bytes;
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+private:
+    static std::size_t bucket(std::size_t bytes) {
+        std::size_t b = 0;
+        while (b + 1 < kBuckets && bucket_limit(b) < bytes) ++b;
+        return b;
+    }
+
+    static std::size_t bucket_limit(std::size_t b) { return std::size_t{8} << std::min(b, kBuckets - 2); }
+
+    std::pmr::memory_resource* upstream_;
+    mutable std::mutex mutex_;
+    Snapshot totals_;
+    // Keyed by the literal's address: one entry per tag, no string hashing
+    std::unordered_map<const char*, SiteStats> sites_;
+};
+
+#endif // MEMORY_RESOURCES_H
@@ -1,119 +1,504 @@
-// [ Producers ] → [ Bounded Queue ] → [ Worker Thread Pool ] → [ Response ]
+// [ Load generator ] → [ Admission ] → [ Bounded Queue + CoDel ] → [ Adaptive Worker Pool ] → [ Backend ]
+//
+// Admission-controlled request executor:
+//   - non-blocking submit: a full queue or an unreachable deadline rejects
+//     immediately instead of stalling the caller
+//   - per-request deadlines: expired requests are dropped at dequeue, before
+//     any backend work is spent on them
+//   - CoDel queue management (server variant): if queueing delay never fell
+//     below a target during the last interval the queue is standing, so the
+//     queue timeout shrinks to that target and the queue switches to LIFO,
+//     serving fresh requests while stale ones age out
+//   - adaptive concurrency: AIMD or gradient limit on in-flight requests,
+//     driven by measured backend latency
+//   - latency histograms per outcome
+//
+// The benchmark replays open-loop Poisson load against a backend that slows
+// down once it has more than BACKEND_SLOTS requests in flight, and compares
+// goodput (completions within deadline per second) with the original fixed
+// design: 4 workers, queue of 10, blocking submit, no deadlines.
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <random>
 #include <thread>
 #include <vector>
-#include <queue>
-#include <mutex>
-#include <condition_variable>
-#include <atomic>
-#include <chrono>
+
+using Clock = std::chrono::steady_clock;
+using namespace std::chrono_literals;
 
 // =======================
-// Configuration
+// Latency histogram (log-linear, ~6% bucket error)
 // =======================
-constexpr size_t MAX_QUEUE_SIZE = 10;
-constexpr int NUM_WORKERS = 4;
+class LatencyHistogram {
+public:
+    void record(std::chrono::nanoseconds latency) {
+        auto ns = static_cast<std::uint64_t>(std::max<std::int64_t>(0, latency.count()));
+        ++counts[bucket(ns)];
+        ++total;
+    }
+
+    std::chrono::microseconds percentile(double p) const {
+        if (total == 0) return 0us;
+        auto rank = static_cast<std::uint64_t>(p / 100.0 * static_cast<double>(total - 1)) + 1;
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < counts.size(); ++i) {
+            seen += counts[i];
+            if (seen >= rank) return std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::nanoseconds(lower_bound(i)));
+        }
+        return 0us;
+    }
+
+    std::uint64_t count() const { return total; }
+
+private:
+    static std::size_t bucket(std::uint64_t v) {
+        if (v < 16) return static_cast<std::size_t>(v);
+        unsigned e = 63u - static_cast<unsigned>(__builtin_clzll(v));
+        return (e - 3) * 16 + ((v >> (e - 4)) & 15);
+    }
+
+    static std::uint64_t lower_bound(std::size_t i) {
+        if (i < 16) return i;
+        unsigned e = static_cast<unsigned>(i / 16 + 3);
+        return (16 + i % 16) << (e - 4);
+    }
+
+    std::array<std::uint64_t, 64 * 16> counts{};
+    std::uint64_t total = 0;
+};
 
 // =======================
 // Request definition
 // =======================
+enum class Outcome { Completed, Rejected, Expired, Dropped };
+
 struct Request {
-    int id;
+    int id = 0;
+    Clock::time_point arrival;    // when the client sent it (open-loop schedule)
+    Clock::time_point deadline;
+    std::function<void()> work;
+    std::function<void(const Request&, Outcome)> done;
+};
+
+// =======================
+// Concurrency limit algorithms
+// =======================
+class LimitAlgorithm {
+public:
+    virtual ~LimitAlgorithm() = default;
+    // One completed request: its backend latency and the in-flight count when
+    // it ran. Queue drops are not a signal here: they say nothing about the
+    // backend, only about offered load.
+    virtual double on_sample(std::chrono::nanoseconds rtt, unsigned inflight) = 0;
+};
+
+// Additive increase while latency is near the best seen, multiplicative
+// decrease when it is not
+class AimdLimit : public LimitAlgorithm {
+public:
+    AimdLimit(double initial, double min, double max) : limit(initial), min(min), max(max) {}
+
+    double on_sample(std::chrono::nanoseconds rtt, unsigned inflight) override {
+        min_rtt = std::min(min_rtt, rtt);
+        if (rtt > 2 * min_rtt) {
+            limit = std::max(min, limit * 0.9);
+        } else if (inflight * 2 >= limit) {
+            limit = std::min(max, limit + 1.0 / limit);   // +1 per limit's worth of samples
+        }
+        return limit;
+    }
+
+private:
+    double limit, min, max;
+    std::chrono::nanoseconds min_rtt = std::chrono::nanoseconds::max();
+};
+
+// Gradient: compare the no-load latency (best seen, with some tolerance)
+// with the average of a short window. Rising latency (gradient < 1) shrinks
+// the limit proportionally; sqrt(limit) of headroom lets it probe upwards
+// while latency is flat.
+class GradientLimit : public LimitAlgorithm {
+public:
+    GradientLimit(double initial, double min, double max) : limit(initial), min(min), max(max) {}
+
+    double on_sample(std::chrono::nanoseconds rtt, unsigned) override {
+        double sample = static_cast<double>(rtt.count());
+        min_rtt = std::min(min_rtt, sample);
+        window_sum += sample;
+        if (++window_count < WINDOW) return limit;
+
+        double short_rtt = window_sum / window_count;
+        window_sum = 0;
+        window_count = 0;
+
+        double gradient = std::clamp(TOLERANCE * min_rtt / short_rtt, 0.5, 1.0);
+        double target = limit * gradient + std::sqrt(limit);
+        limit = std::clamp(limit * 0.8 + target * 0.2, min, max);
+        return limit;
+    }
+
+private:
+    static constexpr int WINDOW = 20;
+    static constexpr double TOLERANCE = 1.5;
+    double limit, min, max;
+    double min_rtt = 1e18;
+    double window_sum = 0;
+    int window_count = 0;
 };
 
 // =======================
-// Shared state
+// CoDel (controlled delay) head-drop
 // =======================
-std::mutex mtx;
-std::condition_variable cv_not_empty;
-std::condition_variable cv_not_full;
+// The request-server form of CoDel: a queue that is only momentarily long
+// drains by itself, but one whose *minimum* delay stayed above target for a
+// whole interval is a standing queue. While standing, requests older than
+// target are dropped; otherwise the timeout is the (generous) interval.
+class CoDel {
+public:
+    CoDel(Clock::duration target, Clock::duration interval) : target(target), interval(interval) {}
+
+    void observe(Clock::duration sojourn, Clock::time_point now) {
+        if (now >= interval_end) {
+            overloaded = min_sojourn > target;
+            min_sojourn = Clock::duration::max();
+            interval_end = now + interval;
+        }
+        min_sojourn = std::min(min_sojourn, sojourn);
+    }
 
-std::queue<Request> queue;
-bool shutting_down = false;
+    bool should_drop(Clock::duration sojourn) const { return sojourn > (overloaded ? target : interval); }
+    bool congested() const { return overloaded; }
+
+private:
+    Clock::duration target, interval;
+    Clock::duration min_sojourn = Clock::duration::max();
+    Clock::time_point interval_end{};
+    bool overloaded = false;
+};
 
 // =======================
-// Worker thread function
+// Admission-controlled executor
 // =======================
-void worker_thread(int worker_id) {
-    while (true) {
-        Request req;
+struct ExecutorOptions {
+    std::size_t queue_capacity = 1000;
+    unsigned min_limit = 1;
+    unsigned max_limit = 64;     // also the number of worker threads
+    unsigned initial_limit = 4;
+    bool gradient = true;        // false: AIMD
+    Clock::duration codel_target = 5ms;
+    Clock::duration codel_interval = 100ms;
+};
+
+class RequestExecutor {
+public:
+    enum class Admission { Accepted, Rejected, Closed };
+
+    explicit RequestExecutor(ExecutorOptions options)
+        : options(options), codel(options.codel_target, options.codel_interval),
+          limit(options.initial_limit), limit_value(options.initial_limit) {
+        double lo = options.min_limit, hi = options.max_limit, init = options.initial_limit;
+        if (options.gradient) {
+            algorithm = std::make_unique<GradientLimit>(init, lo, hi);
+        } else {
+            algorithm = std::make_unique<AimdLimit>(init, lo, hi);
+        }
+        for (unsigned i = 0; i < options.max_limit; ++i) workers.emplace_back(&RequestExecutor::worker_thread, this);
+    }
+
+    ~RequestExecutor() { shutdown(); }
 
+    // Never blocks. Rejected requests get their done() callback before this returns.
+    Admission submit(Request req) {
+        std::unique_lock<std::mutex> lock(mtx);
+        if (shutting_down) return Admission::Closed;
+
+        // Early reject: a full queue, or a deadline we could not meet even if
+        // the request ran right now
+        if (queue.size() >= options.queue_capacity || Clock::now() + min_rtt > req.deadline) {
+            lock.unlock();
+            req.done(req, Outcome::Rejected);
+            return Admission::Rejected;
+        }
+        queue.push_back({std::move(req), Clock::now()});
+        lock.unlock();
+        cv_work.notify_one();
+        return Admission::Accepted;
+    }
+
+    void shutdown() {
         {
-            std::unique_lock<std::mutex> lock(mtx);
+            std::lock_guard<std::mutex> lock(mtx);
+            if (shutting_down) return;
+            shutting_down = true;
+        }
+        cv_work.notify_all();
+        for (auto& t : workers) t.join();
+    }
+
+    double current_limit() const {
+        std::lock_guard<std::mutex> lock(mtx);
+        return limit_value;
+    }
+
+private:
+    struct Queued {
+        Request req;
+        Clock::time_point enqueued;
+    };
+
+    void worker_thread() {
+        std::vector<std::pair<Request, Outcome>> discarded;
+        while (true) {
+            Request req;
+            bool have = false;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                cv_work.wait(lock, [this] { return (!queue.empty() && inflight < limit) || shutting_down; });
+                if (shutting_down && queue.empty()) return;
+
+                auto now = Clock::now();
+                codel.observe(now - queue.front().enqueued, now);
 
-            // Wait until work is available or shutdown requested
-            cv_not_empty.wait(lock, [] {
-                return !queue.empty() || shutting_down;
-            });
+                // Age out the oldest requests first: past their deadline, or
+                // older than CoDel's current queue timeout
+                while (!queue.empty()) {
+                    Queued& head = queue.front();
+                    if (now + min_rtt > head.req.deadline) {
+                        discarded.emplace_back(std::move(head.req), Outcome::Expired);
+                    } else if (codel.should_drop(now - head.enqueued)) {
+                        discarded.emplace_back(std::move(head.req), Outcome::Dropped);
+                    } else {
+                        break;
+                    }
+                    queue.pop_front();
+                }
 
-            // Exit condition
-            if (shutting_down && queue.empty())
-                return;
+                // Adaptive LIFO: under a standing queue the newest request is
+                // the one most likely to still be useful when it completes
+                if (!queue.empty()) {
+                    if (codel.congested()) {
+                        req = std::move(queue.back().req);
+                        queue.pop_back();
+                    } else {
+                        req = std::move(queue.front().req);
+                        queue.pop_front();
+                    }
+                    have = true;
+                    ++inflight;
+                }
+            }
 
-            req = queue.front();
-            queue.pop();
+            // Callbacks run outside the lock
+            for (auto& [r, outcome] : discarded) r.done(r, outcome);
+            discarded.clear();
+            if (!have) continue;
 
-            // Signal that queue has space
-            cv_not_full.notify_one();
+            auto start = Clock::now();
+            req.work();
+            auto rtt = Clock::now() - start;
+            req.done(req, Outcome::Completed);
+
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                unsigned running = inflight--;
+                if (min_rtt == Clock::duration::zero() || rtt < min_rtt) min_rtt = rtt;
+                limit_value = algorithm->on_sample(rtt, running);
+                limit = static_cast<unsigned>(std::lround(limit_value));
+            }
+            cv_work.notify_all();   // the limit may have grown
         }
+    }
 
-        // ---- Process request outside lock ----
-        std::cout << "[Worker " << worker_id
-                  << "] Processing request " << req.id << "\n";
+    ExecutorOptions options;
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    mutable std::mutex mtx;
+    std::condition_variable cv_work;
+    std::deque<Queued> queue;
+    CoDel codel;
+    std::unique_ptr<LimitAlgorithm> algorithm;
+    unsigned limit;
+    double limit_value;   // what the algorithm returned; initial_limit before the first sample
+    unsigned inflight = 0;
+    Clock::duration min_rtt = Clock::duration::zero();   // zero until the first sample
+    bool shutting_down = false;
 
-        std::cout << "[Worker " << worker_id
-                  << "] Finished request " << req.id << "\n";
+    std::vector<std::thread> workers;
+};
+
+// =======================
+// Original fixed design (globals moved into a class, printing removed)
+// =======================
+class FixedQueueServer {
+public:
+    static constexpr size_t MAX_QUEUE_SIZE = 10;
+    static constexpr int NUM_WORKERS = 4;
+
+    FixedQueueServer() {
+        for (int i = 0; i < NUM_WORKERS; ++i) workers.emplace_back(&FixedQueueServer::worker_thread, this);
+    }
+
+    ~FixedQueueServer() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            shutting_down = true;
+        }
+        cv_not_empty.notify_all();
+        cv_not_full.notify_all();
+        for (auto& t : workers) t.join();
     }
-}
+
+    // Backpressure: blocks until the queue has space
+    void submit_request(Request req) {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv_not_full.wait(lock, [this] { return queue.size() < MAX_QUEUE_SIZE || shutting_down; });
+        if (shutting_down) return;
+        queue.push(std::move(req));
+        cv_not_empty.notify_one();
+    }
+
+private:
+    void worker_thread() {
+        while (true) {
+            Request req;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                cv_not_empty.wait(lock, [this] { return !queue.empty() || shutting_down; });
+                if (shutting_down && queue.empty()) return;
+                req = std::move(queue.front());
+                queue.pop();
+                cv_not_full.notify_one();
+            }
+            req.work();
+            req.done(req, Outcome::Completed);
+        }
+    }
+
+    std::mutex mtx;
+    std::condition_variable cv_not_empty;
+    std::condition_variable cv_not_full;
+    std::queue<Request> queue;
+    bool shutting_down = false;
+    std::vector<std::thread> workers;
+};
 
 // =======================
-// Producer (request submitter)
+// Simulated backend and load generator
 // =======================
-void submit_request(Request req) {
-    std::unique_lock<std::mutex> lock(mtx);
 
-    // Backpressure: wait until queue has space
-    cv_not_full.wait(lock, [] {
-        return queue.size() < MAX_QUEUE_SIZE || shutting_down;
-    });
+// A downstream with BACKEND_SLOTS of real parallelism: beyond that, every
+// in-flight request slows down proportionally (processor sharing)
+constexpr unsigned BACKEND_SLOTS = 8;
+constexpr auto BACKEND_LATENCY = 2ms;
+constexpr auto DEADLINE = 50ms;
+std::atomic<unsigned> backend_inflight{0};
+
+void backend_call() {
+    unsigned n = backend_inflight.fetch_add(1) + 1;
+    double stretch = std::max(1.0, static_cast<double>(n) / BACKEND_SLOTS);
+    std::this_thread::sleep_for(std::chrono::duration_cast<Clock::duration>(BACKEND_LATENCY * stretch));
+    backend_inflight.fetch_sub(1);
+}
+
+struct LoadResult {
+    std::atomic<std::uint64_t> good{0}, late{0}, rejected{0}, expired{0}, dropped{0};
+    std::mutex hist_mtx;
+    LatencyHistogram latency;   // completed requests, measured from scheduled arrival
+};
+
+// Open loop: arrival times are fixed in advance, so a blocking submit shows up
+// as latency instead of silently slowing the client down
+template<typename Submit>
+double generate_load(double rate, Clock::duration duration, LoadResult& result, Submit submit) {
+    std::mt19937 rng(42);
+    std::exponential_distribution<double> gap(rate);
+    auto start = Clock::now();
+    auto t = start;
+    int id = 0;
+    while (t < start + duration) {
+        t += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(gap(rng)));
+        std::this_thread::sleep_until(t);
 
-    if (shutting_down)
-        return;
+        Request req;
+        req.id = id++;
+        req.arrival = t;
+        req.deadline = t + DEADLINE;
+        req.work = backend_call;
+        req.done = [&result](const Request& r, Outcome outcome) {
+            switch (outcome) {
+            case Outcome::Completed: {
+                auto latency = Clock::now() - r.arrival;
+                (latency <= DEADLINE ? result.good : result.late).fetch_add(1);
+                std::lock_guard<std::mutex> lock(result.hist_mtx);
+                result.latency.record(latency);
+                break;
+            }
+            case Outcome::Rejected: result.rejected.fetch_add(1); break;
+            case Outcome::Expired: result.expired.fetch_add(1); break;
+            case Outcome::Dropped: result.dropped.fetch_add(1); break;
+            }
+        };
+        submit(std::move(req));
+    }
+    return std::chrono::duration<double>(duration).count();
+}
 
-    queue.push(req);
-    cv_not_empty.notify_one();
+void report(const char* name, const LoadResult& r, double seconds) {
+    std::cout << "  " << name << ": goodput " << static_cast<int>(r.good / seconds) << "/s"
+              << ", late " << r.late << ", rejected " << r.rejected << ", expired " << r.expired
+              << ", codel-dropped " << r.dropped << " | completed p50 " << r.latency.percentile(50).count()
+              << " us, p99 " << r.latency.percentile(99).count() << " us\n";
 }
 
 // =======================
 // Main
 // =======================
 int main() {
-    // Start worker pool
-    std::vector<std::thread> workers;
-    for (int i = 0; i < NUM_WORKERS; ++i)
-        workers.emplace_back(worker_thread, i);
+    const double capacity_rps = BACKEND_SLOTS / std::chrono::duration<double>(BACKEND_LATENCY).count();
+    const auto duration = 1000ms;
+    std::cout << "backend: " << BACKEND_SLOTS << " slots x " << BACKEND_LATENCY.count() << " ms -> ~"
+              << capacity_rps << " req/s; deadline " << DEADLINE.count() << " ms\n";
 
-    // Simulate incoming requests
-    for (int i = 1; i <= 25; ++i) {
-        submit_request(Request{i});
-        std::cout << "[Main] Submitted request " << i << "\n";
-    }
+    for (double load : {0.5, 1.0, 2.0, 4.0}) {
+        double rate = capacity_rps * load;
+        std::cout << "offered load " << load << "x (" << rate << " req/s)\n";
 
-    // Graceful shutdown
-    {
-        std::lock_guard<std::mutex> lock(mtx);
-        shutting_down = true;
-    }
-
-    cv_not_empty.notify_all();
-    cv_not_full.notify_all();
-
-    for (auto& t : workers)
-        t.join();
+        {
+            LoadResult r;
+            double s;
+            {
+                FixedQueueServer server;
+                s = generate_load(rate, duration, r, [&](Request req) { server.submit_request(std::move(req)); });
+            }
+            report("fixed 4 workers, queue 10", r, s);
+        }
 
-    std::cout << "All requests processed. Shutdown complete.\n";
+        for (bool gradient : {false, true}) {
+            LoadResult r;
+            double s, final_limit;
+            {
+                ExecutorOptions options;
+                options.gradient = gradient;
+                RequestExecutor executor(options);
+                s = generate_load(rate, duration, r, [&](Request req) { executor.submit(std::move(req)); });
+                final_limit = executor.current_limit();
+                executor.shutdown();
+            }
+            report(gradient ? "adaptive gradient        " : "adaptive AIMD            ", r, s);
+            std::cout << "      final concurrency limit " << final_limit << "\n";
+        }
+    }
     return 0;
 }
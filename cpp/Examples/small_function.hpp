@@ -0,0 +1,204 @@
+#ifndef SMALL_FUNCTION_H
+#define SMALL_FUNCTION_H
+
+// Callable wrappers for hot paths where std::function costs too much:
+//
+//   small_function<R(Args...), N>  move-only, owns the callable. Callables
+//                                  up to N bytes with a noexcept move live
+//                                  inline; larger ones go to the heap.
+//   move_only_function<R(Args...)> small_function with the default capacity
+//   function_ref<R(Args...)>       non-owning view of a callable, two words,
+//                                  never allocates; for parameters only
+//
+// Differences from std::function:
+//   - move-only, so it can hold move-only captures (packaged_task, unique_ptr)
+//   - no RTTI (no target()/target_type()), a static table of three function
+//     pointers per callable type instead of a virtual class
+//   - trivially copyable callables (most lambdas capturing pointers and
+//     scalars) are moved with memcpy and need no destructor call
+//   - calling an empty wrapper is a precondition violation (assert), not an
+//     exception
+
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace detail {
+
+template<typename R, typename F, typename... Args>
+R invoke_r(F&& f, Args&&... args) {
+    if constexpr (std::is_void_v<R>) {
+        std::invoke(std::forward<F>(f), std::forward<Args>(args)...);
+    } else {
+        return std::invoke(std::forward<F>(f), std::forward<Args>(args)...);
+    }
+}
+
+} // namespace detail
+
+template<typename Signature, std::size_t Capacity = 3 * sizeof(void*)>
+class small_function;
+
+template<typename R, typename... Args, std::size_t Capacity>
+class small_function<R(Args...), Capacity> {
+    static constexpr std::size_t kSize = Capacity < sizeof(void*) ? sizeof(void*) : Capacity;
+    static constexpr std::size_t kAlign = alignof(std::max_align_t);
+
+    struct VTable {
+        R (*invoke)(void* storage, Args&&... args);
+        void (*relocate)(void* dst, void* src) noexcept;   // nullptr: memcpy the storage
+        void (*destroy)(void* storage) noexcept;            // nullptr: nothing to do
+    };
+
+    template<typename F>
+    static constexpr bool fits_inline =
+        sizeof(F) <= kSize && alignof(F) <= kAlign && std::is_nothrow_move_constructible_v<F>;
+
+    template<typename F>
+    static F* as(void* storage) { return std::launder(static_cast<F*>(storage)); }
+
+    template<typename F>
+    static F* heap(void* storage) { return *static_cast<F**>(storage); }
+
+    template<typename F>
+    static constexpr VTable inline_vtable = {
+        [](void* s, Args&&... args) -> R { return detail::invoke_r<R>(*as<F>(s), std::forward<Args>(args)...); },
+        std::is_trivially_copyable_v<F>
+            ? nullptr
+            : +[](void* dst, void* src) noexcept {
+                  ::new (dst) F(std::move(*as<F>(src)));
+                  as<F>(src)->~F();
+              },
+        std::is_trivially_destructible_v<F> ? nullptr : +[](void* s) noexcept { as<F>(s)->~F(); },
+    };
+
+    // Heap-held callables relocate by copying the pointer
+    template<typename F>
+    static constexpr VTable heap_vtable = {
+        [](void* s, Args&&... args) -> R { return detail::invoke_r<R>(*heap<F>(s), std::forward<Args>(args)...); },
+        nullptr,
+        [](void* s) noexcept { delete heap<F>(s); },
+    };
+
+public:
+    small_function() noexcept = default;
+    small_function(std::nullptr_t) noexcept {}
+
+    template<typename F, typename D = std::decay_t<F>,
+             typename = std::enable_if_t<!std::is_same_v<D, small_function> &&
+                                         std::is_invocable_r_v<R, D&, Args...>>>
+    small_function(F&& f) {
+        if constexpr (std::is_pointer_v<D> || std::is_member_pointer_v<D>) {
+            if (f == nullptr) return;
+        }
+        if constexpr (fits_inline<D>) {
+            ::new (static_cast<void*>(storage)) D(std::forward<F>(f));
+            vtable = &inline_vtable<D>;
+        } else {
+            ::new (static_cast<void*>(storage)) D*(new D(std::forward<F>(f)));
+            vtable = &heap_vtable<D>;
+        }
+    }
+
+    small_function(small_function&& other) noexcept { take(other); }
+
+    small_function& operator=(small_function&& other) noexcept {
+        if (this != &other) {
+            reset();
+            take(other);
+        }
+        return *this;
+    }
+
+    small_function& operator=(std::nullptr_t) noexcept {
+        reset();
+        return *this;
+    }
+
+    template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, small_function>>>
+    small_function& operator=(F&& f) {
+        return *this = small_function(std::forward<F>(f));
+    }
+
+    small_function(const small_function&) = delete;
+    small_function& operator=(const small_function&) = delete;
+
+    ~small_function() { reset(); }
+
+    // const like std::function's: the wrapper is a handle, the callable may be mutable
+    R operator()(Args... args) const {
+        assert(vtable && "calling an empty small_function");
+        return vtable->invoke(storage, std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const noexcept { return vtable != nullptr; }
+
+    // True if F would be stored without a heap allocation
+    template<typename F>
+    static constexpr bool stores_inline() { return fits_inline<std::decay_t<F>>; }
+
+private:
+    void take(small_function& other) noexcept {
+        if (!other.vtable) return;
+        if (other.vtable->relocate) {
+            other.vtable->relocate(storage, other.storage);
+        } else {
+            std::memcpy(storage, other.storage, kSize);
+        }
+        vtable = std::exchange(other.vtable, nullptr);
+    }
+
+    void reset() noexcept {
+        if (vtable && vtable->destroy) vtable->destroy(storage);
+        vtable = nullptr;
+    }
+
+    alignas(kAlign) mutable unsigned char storage[kSize];
+    const VTable* vtable = nullptr;
+};
+
+template<typename Signature>
+using move_only_function = small_function<Signature>;
+
+
+template<typename Signature>
+class function_ref;
+
+template<typename R, typename... Args>
+class function_ref<R(Args...)> {
+public:
+    template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, function_ref> &&
+                                                     std::is_invocable_r_v<R, F&, Args...>>>
+    function_ref(F&& f) noexcept {
+        using T = std::remove_reference_t<F>;
+        if constexpr (std::is_function_v<T>) {
+            target.fn = reinterpret_cast<void (*)()>(&f);
+            thunk = [](Target t, Args&&... args) -> R {
+                return detail::invoke_r<R>(reinterpret_cast<T*>(t.fn), std::forward<Args>(args)...);
+            };
+        } else {
+            target.object = const_cast<void*>(static_cast<const void*>(std::addressof(f)));
+            thunk = [](Target t, Args&&... args) -> R {
+                return detail::invoke_r<R>(*static_cast<T*>(t.object), std::forward<Args>(args)...);
+            };
+        }
+    }
+
+    R operator()(Args... args) const { return thunk(target, std::forward<Args>(args)...); }
+
+private:
+    union Target {
+        void* object;
+        void (*fn)();
+    };
+
+    Target target;
+    R (*thunk)(Target, Args&&...);
+};
+
+#endif // SMALL_FUNCTION_H
@@ -6,11 +6,16 @@
 #include <future>
 #include <condition_variable>
 #include <atomic>
+#include <tuple>
+
+#include "small_function.hpp"
 
 class ThreadPool {
 private:
     std::vector<std::thread> workers;
-    std::queue<std::function<void()>> tasks;
+    // packaged_task is move-only and fits the inline buffer, so a queued task
+    // costs one allocation (the future's shared state) instead of three
+    std::queue<small_function<void()>> tasks;
     
     std::mutex queue_mutex;
     std::condition_variable condition;
@@ -48,11 +53,13 @@ public:
         
         using return_type = typename std::invoke_result<F, Args...>::type;
         
-        auto task = std::make_shared<std::packaged_task<return_type()>>(
-            std::bind(std::forward<F>(f), std::forward<Args>(args)...)
+        std::packaged_task<return_type()> task(
+            [f = std::forward<F>(f), args = std::make_tuple(std::forward<Args>(args)...)]() mutable {
+                return std::apply(std::move(f), std::move(args));
+            }
         );
         
-        std::future<return_type> result = task->get_future();
+        std::future<return_type> result = task.get_future();
         
         {
             std::lock_guard<std::mutex> lock(queue_mutex);
@@ -60,7 +67,7 @@ public:
                 throw std::runtime_error("enqueue on stopped ThreadPool");
             }
             
-            tasks.emplace([task]() { (*task)(); });
+            tasks.emplace(std::move(task));
         }
         
         condition.notify_one();
@@ -70,7 +77,7 @@ public:
 private:
     void worker_loop() {
         while (true) {
-            std::function<void()> task;
+            small_function<void()> task;
             
             {
                 std::unique_lock<std::mutex> lock(queue_mutex);
@@ -196,7 +203,7 @@ void demonstrate_thread_pools() {
     class PriorityThreadPool {
     private:
         struct Task {
-            std::function<void()> func;
+            small_function<void()> func;
             int priority;
             
             bool operator<(const Task& other) const {
@@ -2,16 +2,17 @@
 #include <thread>
 #include <chrono>
 #include <atomic>
-#include <functional>
 #include <mutex>
 #include <condition_variable>
 
+#include "small_function.hpp"
+
 class Watchdog {
 public:
     // Constructor: sets timeout in milliseconds and optional callback
-    Watchdog(uint64_t timeout_ms, std::function<void()> callback = nullptr)
+    Watchdog(uint64_t timeout_ms, small_function<void()> callback = nullptr)
         : timeout_ms_(timeout_ms)
-        , callback_(callback)
+        , callback_(std::move(callback))
         , running_(false)
         , triggered_(false)
     {}
@@ -108,7 +109,7 @@ private:
     }
     
     uint64_t timeout_ms_;
-    std::function<void()> callback_;
+    small_function<void()> callback_;
     std::atomic<bool> running_;
     std::atomic<bool> triggered_;
     std::thread watchdog_thread_;
@@ -5,6 +5,10 @@
 #include <concepts>  // C++20
 #include <algorithm>
 #include <memory>
+#include <functional>
+#include <new>
+#include <cstddef>
+#include <utility>
 
 // ============ 1. FUNCTION TEMPLATES ============
 
@@ -690,51 +694,104 @@ public:
 };
 
 // Generic function object wrapper
+// Small callables (up to kInline bytes, noexcept move) are built inside the
+// wrapper itself, so the common lambda costs no heap allocation; larger ones
+// fall back to the heap. std::function does the same (small buffer optimization).
+// Hot paths that never copy the wrapper can go further with a move-only,
+// RTTI-free version: see Examples/small_function.hpp.
 template<typename T>
 class Function;
 
 template<typename Ret, typename... Args>
 class Function<Ret(Args...)> {
+    static constexpr std::size_t kInline = 3 * sizeof(void*);
+
     struct CallableBase {
         virtual ~CallableBase() = default;
         virtual Ret call(Args...) = 0;
-        virtual std::unique_ptr<CallableBase> clone() const = 0;
+        virtual CallableBase* clone_into(void* buffer) const = 0;   // buffer == nullptr: heap
+        virtual CallableBase* move_into(void* buffer) noexcept = 0; // only used for inline objects
     };
     
     template<typename F>
     struct Callable : CallableBase {
         F func;
         Callable(F f) : func(std::move(f)) {}
-        Ret call(Args... args) override { return func(args...); }
-        std::unique_ptr<CallableBase> clone() const override {
-            return std::make_unique<Callable>(func);
+        Ret call(Args... args) override { return func(std::forward<Args>(args)...); }
+        CallableBase* clone_into(void* buffer) const override {
+            return buffer ? ::new (buffer) Callable(func) : new Callable(func);
+        }
+        CallableBase* move_into(void* buffer) noexcept override {
+            return ::new (buffer) Callable(std::move(func));
         }
     };
     
-    std::unique_ptr<CallableBase> callable;
+    template<typename F>
+    static constexpr bool fits_inline = sizeof(Callable<F>) <= kInline &&
+                                        alignof(Callable<F>) <= alignof(std::max_align_t) &&
+                                        std::is_nothrow_move_constructible_v<F>;
+    
+    alignas(std::max_align_t) unsigned char buffer[kInline];
+    CallableBase* callable = nullptr;
+    
+    bool is_inline() const { return callable == reinterpret_cast<const CallableBase*>(buffer); }
+    
+    void reset() {
+        if (is_inline()) callable->~CallableBase();
+        else delete callable;
+        callable = nullptr;
+    }
+    
+    void copy_from(const Function& other) {
+        if (other.callable) callable = other.callable->clone_into(other.is_inline() ? buffer : nullptr);
+    }
+    
+    void move_from(Function& other) noexcept {
+        if (!other.callable) return;
+        if (other.is_inline()) {
+            callable = other.callable->move_into(buffer);
+            other.reset();
+        } else {
+            callable = std::exchange(other.callable, nullptr);   // steal the heap object
+        }
+    }
     
 public:
     Function() = default;
     
-    template<typename F>
-    Function(F f) : callable(std::make_unique<Callable<F>>(std::move(f))) {}
+    template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Function>>>
+    Function(F f) {
+        if constexpr (fits_inline<F>) callable = ::new (buffer) Callable<F>(std::move(f));
+        else callable = new Callable<F>(std::move(f));
+    }
     
-    Function(const Function& other) : 
-        callable(other.callable ? other.callable->clone() : nullptr) {}
+    Function(const Function& other) { copy_from(other); }
+    Function(Function&& other) noexcept { move_from(other); }
     
     Function& operator=(const Function& other) {
         if (this != &other) {
-            callable = other.callable ? other.callable->clone() : nullptr;
+            reset();
+            copy_from(other);
+        }
+        return *this;
+    }
+    
+    Function& operator=(Function&& other) noexcept {
+        if (this != &other) {
+            reset();
+            move_from(other);
         }
         return *this;
     }
     
+    ~Function() { reset(); }
+    
     Ret operator()(Args... args) const {
         if (!callable) throw std::bad_function_call();
-        return callable->call(args...);
+        return callable->call(std::forward<Args>(args)...);
     }
     
-    explicit operator bool() const { return static_cast<bool>(callable); }
+    explicit operator bool() const { return callable != nullptr; }
 };
 
 void demonstrate_real_world() {
@@ -756,6 +813,12 @@ void demonstrate_real_world() {
         
         std::cout << "add(3, 4) = " << add(3, 4) << std::endl;
         std::cout << "multiply(3, 4) = " << multiply(3, 4) << std::endl;
+        
+        // Too big for the inline buffer: stored on the heap, still copyable
+        std::vector<int> weights{1, 2, 3, 4};
+        Function<int(int, int)> weighted = [weights](int a, int b) { return a * weights[0] + b * weights[3]; };
+        Function<int(int, int)> copy = weighted;
+        std::cout << "weighted(3, 4) = " << copy(3, 4) << std::endl;
     }
 }
 
@@ -179,6 +179,8 @@ void cyclic_reference() {
 #include <thread>
 #include <chrono>
 #include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 
 // ============================================================================
 // 1. BASIC SMART POINTER TYPES & OWNERSHIP MODELS
@@ -407,6 +409,10 @@ void demonstrate_weak_ptr() {
     std::cout << "After destruction, expired: " << (weak.expired() ? "yes" : "no") << "\n";
     
     // 4.4 Cache pattern with weak_ptr
+    // Single mutex, so lookups serialize; the Resource is built outside it so a
+    // slow construction doesn't block hits on other ids. For striped locks,
+    // single-flight builds and eviction from the deleter instead of
+    // cleanupExpired() see Examples/Performance/concurrent_resource_cache.cpp
     class ResourceCache {
     private:
         std::unordered_map<int, std::weak_ptr<Resource>> cache;
@@ -414,22 +420,27 @@ void demonstrate_weak_ptr() {
         
     public:
         std::shared_ptr<Resource> getResource(int id, const std::string& name) {
-            std::lock_guard<std::mutex> lock(cacheMutex);
-            
-            auto it = cache.find(id);
-            if (it != cache.end()) {
-                if (auto cached = it->second.lock()) {
-                    std::cout << "Cache hit for id " << id << "\n";
-                    return cached;
+            {
+                std::lock_guard<std::mutex> lock(cacheMutex);
+                auto it = cache.find(id);
+                if (it != cache.end()) {
+                    if (auto cached = it->second.lock()) {
+                        std::cout << "Cache hit for id " << id << "\n";
+                        return cached;
+                    }
                 }
-                // Entry expired, remove it
-                cache.erase(it);
             }
             
-            // Cache miss, create new resource
+            // Cache miss, create new resource without holding the lock
             std::cout << "Cache miss for id " << id << ", creating new\n";
             auto resource = std::make_shared<Resource>(name);
-            cache[id] = resource;
+            
+            std::lock_guard<std::mutex> lock(cacheMutex);
+            auto& slot = cache[id];
+            if (auto winner = slot.lock()) {
+                return winner;   // another thread built it first; ours is discarded
+            }
+            slot = resource;
             return resource;
         }
         
@@ -535,24 +546,25 @@ void demonstrate_custom_deleters() {
     );
     
     // 5.4 Memory pool deleter
+    // Tracking set keeps deallocate O(1); a real pool would also avoid malloc
+    // per object (size-class slabs, thread caches, stateless deleters):
+    // see Examples/Performance/slab_pool.cpp
     class MemoryPool {
     private:
-        std::vector<void*> allocated;
+        std::unordered_set<void*> allocated;
         
     public:
         void* allocate(size_t size) {
             void* ptr = malloc(size);
-            allocated.push_back(ptr);
+            allocated.insert(ptr);
             std::cout << "Allocated " << size << " bytes at " << ptr << "\n";
             return ptr;
         }
         
         void deallocate(void* ptr) {
-            auto it = std::find(allocated.begin(), allocated.end(), ptr);
-            if (it != allocated.end()) {
+            if (allocated.erase(ptr)) {
                 std::cout << "Deallocating " << ptr << "\n";
                 free(ptr);
-                allocated.erase(it);
             }
         }
         
@@ -564,20 +576,18 @@ void demonstrate_custom_deleters() {
     };
     
     MemoryPool pool;
+    // The deleter owns the whole teardown: destroy the object, then return
+    // its memory. Calling ~Resource() by hand as well would destroy it twice.
     auto poolDeleter = [&pool](Resource* r) {
         std::cout << "Returning resource to pool: " << r->getName() << "\n";
+        r->~Resource();
         pool.deallocate(r);
     };
     
+    // Construct in pooled memory with placement new before handing it over
+    void* memory = pool.allocate(sizeof(Resource));
     std::unique_ptr<Resource, decltype(poolDeleter)> 
-        pooledResource(static_cast<Resource*>(pool.allocate(sizeof(Resource))), 
-                      poolDeleter);
-    
-    // Use placement new to construct object in pooled memory
-    new(pooledResource.get()) Resource("PooledResource");
-    
-    // Manually call destructor before deleter runs
-    pooledResource->~Resource();
+        pooledResource(new (memory) Resource("PooledResource"), poolDeleter);
 }
 
 // ============================================================================
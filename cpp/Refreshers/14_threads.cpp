@@ -539,18 +539,40 @@ void demonstrate_atomics() {
     t2.join();
     
     // 4. Lock-free stack example
+    // Popped nodes are NOT deleted immediately: another pop may still be
+    // reading old_head->next, and a freed address reused by a later push
+    // lets a stale CAS succeed (ABA problem). Here they are parked on a
+    // retired list until the stack dies. Real code uses hazard pointers or
+    // epoch-based reclamation (see Examples/Performance/lockfree_reclamation.cpp).
     template<typename T>
     class LockFreeStack {
     private:
         struct Node {
             T data;
             Node* next;
+            // Separate link for the retired list: a losing pop may still be
+            // reading `next` after the winner retires the node
+            Node* retired_next = nullptr;
             Node(const T& d) : data(d), next(nullptr) {}
         };
         
         std::atomic<Node*> head = nullptr;
+        std::atomic<Node*> retired = nullptr;  // linked through `retired_next`
         
     public:
+        ~LockFreeStack() {
+            for (Node* node = head.load(); node;) {
+                Node* next = node->next;
+                delete node;
+                node = next;
+            }
+            for (Node* node = retired.load(); node;) {
+                Node* next = node->retired_next;
+                delete node;
+                node = next;
+            }
+        }
+        
         void push(const T& value) {
             Node* new_node = new Node(value);
             new_node->next = head.load(std::memory_order_relaxed);
@@ -582,7 +604,15 @@ void demonstrate_atomics() {
             if (!old_head) return false;
             
             value = old_head->data;
-            delete old_head;
+            
+            // Defer reclamation: push onto the retired list
+            old_head->retired_next = retired.load(std::memory_order_relaxed);
+            while (!retired.compare_exchange_weak(
+                old_head->retired_next,
+                old_head,
+                std::memory_order_release,
+                std::memory_order_relaxed)) {
+            }
             return true;
         }
     };
@@ -1,7 +1,9 @@
 #include <iostream>
 #include <vector>
+#include <algorithm>
 #include <cmath>
 #include <chrono>
+#include <stdexcept>
 
 // ============================================================================
 // 1. PROBLEM: TEMPORARY OBJECTS IN VECTOR OPERATIONS
@@ -272,7 +274,8 @@ void demonstrate_expression_templates() {
 
 template<typename T>
 class LazyVector {
-    mutable std::vector<T>* data = nullptr;
+    // Held by value: no extra heap block (and no leak/double free on copy)
+    std::vector<T> data;
     
     // Expression type
     template<typename E>
@@ -294,15 +297,13 @@ class LazyVector {
 public:
     template<typename E>
     LazyVector(const VecExpression<E>& expr) 
-        : data(new std::vector<T>(Expression<E>(static_cast<const E&>(expr)))) {}
-    
-    ~LazyVector() { delete data; }
+        : data(Expression<E>(static_cast<const E&>(expr))) {}
     
     const T& operator[](size_t i) const {
-        return (*data)[i];
+        return data[i];
     }
     
-    size_t size() const { return data->size(); }
+    size_t size() const { return data.size(); }
 };
 
 void demonstrate_lazy_evaluation() {
@@ -328,36 +329,50 @@ void demonstrate_lazy_evaluation() {
 // 4. REAL-WORLD EXAMPLE: LINEAR ALGEBRA
 // ============================================================================
 
+// Contiguous row-major storage: one allocation, rows are adjacent in memory.
+// (vector<vector<T>> would cost one heap block per row and a pointer chase)
 template<typename T>
 class Matrix {
-    std::vector<std::vector<T>> data;
     size_t rows, cols;
+    std::vector<T> data;
     
 public:
-    Matrix(size_t r, size_t c) : rows(r), cols(c), data(r, std::vector<T>(c)) {}
+    Matrix(size_t r, size_t c) : rows(r), cols(c), data(r * c) {}
+    
+    // Row access: m[i][j] still works, m[i] points at the start of row i
+    T* operator[](size_t i) { return data.data() + i * cols; }
+    const T* operator[](size_t i) const { return data.data() + i * cols; }
     
-    std::vector<T>& operator[](size_t i) { return data[i]; }
-    const std::vector<T>& operator[](size_t i) const { return data[i]; }
+    void set_row(size_t i, std::initializer_list<T> values) {
+        std::copy(values.begin(), values.end(), (*this)[i]);
+    }
     
     size_t num_rows() const { return rows; }
     size_t num_cols() const { return cols; }
     
-    // Matrix multiplication using expression templates
+    // Matrix multiplication in i-k-j order: the inner loop streams a row of b
+    // and a row of result sequentially instead of striding down b's columns.
+    // For large sizes see Examples/Performance/gemm.cpp (blocked, packed,
+    // AVX2/FMA micro-kernel, multithreaded, fused elementwise epilogue).
     template<typename E1, typename E2>
     static Matrix multiply(const E1& a, const E2& b) {
+        if (a.num_cols() != b.num_rows()) {
+            throw std::invalid_argument("Matrix::multiply: inner dimensions differ");
+        }
         size_t n = a.num_rows();
         size_t m = a.num_cols();
         size_t p = b.num_cols();
         
-        Matrix result(n, p);
+        Matrix result(n, p);  // zero-initialized
         
         for (size_t i = 0; i < n; ++i) {
-            for (size_t j = 0; j < p; ++j) {
-                T sum = 0;
-                for (size_t k = 0; k < m; ++k) {
-                    sum += a[i][k] * b[k][j];
+            T* out = result[i];
+            for (size_t k = 0; k < m; ++k) {
+                const T aik = a[i][k];
+                const auto* b_row = b[k];
+                for (size_t j = 0; j < p; ++j) {
+                    out[j] += aik * b_row[j];
                 }
-                result[i][j] = sum;
             }
         }
         
@@ -372,12 +387,12 @@ void demonstrate_matrix_operations() {
     Matrix<double> B(3, 2);
     
     // Initialize matrices
-    A[0] = {1, 2, 3};
-    A[1] = {4, 5, 6};
+    A.set_row(0, {1, 2, 3});
+    A.set_row(1, {4, 5, 6});
     
-    B[0] = {7, 8};
-    B[1] = {9, 10};
-    B[2] = {11, 12};
+    B.set_row(0, {7, 8});
+    B.set_row(1, {9, 10});
+    B.set_row(2, {11, 12});
     
     // Matrix multiplication
     auto C = Matrix<double>::multiply(A, B);
@@ -421,13 +436,20 @@ void explain_benefits() {
     std::cout << "- Templates create expression trees at compile time\n";
     std::cout << "- Evaluation happens in a single pass\n";
     std::cout << "- Each element computed once, not stored intermediately\n";
+    
+    std::cout << "\nGoing further (Examples/Performance/simd_expression.cpp):\n";
+    std::cout << "- Give every node eval_packet<W>(i) returning W lanes at once\n";
+    std::cout << "- Vectorized sqrt/sin instead of scalar libm calls\n";
+    std::cout << "- Aligned storage + chunked multithreaded assignment\n";
 }
 
 
 #include <iostream>
 #include <vector>
+#include <algorithm>
 #include <cmath>
 #include <chrono>
+#include <stdexcept>
 
 // ============================================================================
 // 1. PROBLEM: TEMPORARY OBJECTS IN VECTOR OPERATIONS
@@ -698,7 +720,8 @@ void demonstrate_expression_templates() {
 
 template<typename T>
 class LazyVector {
-    mutable std::vector<T>* data = nullptr;
+    // Held by value: no extra heap block (and no leak/double free on copy)
+    std::vector<T> data;
     
     // Expression type
     template<typename E>
@@ -720,15 +743,13 @@ class LazyVector {
 public:
     template<typename E>
     LazyVector(const VecExpression<E>& expr) 
-        : data(new std::vector<T>(Expression<E>(static_cast<const E&>(expr)))) {}
-    
-    ~LazyVector() { delete data; }
+        : data(Expression<E>(static_cast<const E&>(expr))) {}
     
     const T& operator[](size_t i) const {
-        return (*data)[i];
+        return data[i];
     }
     
-    size_t size() const { return data->size(); }
+    size_t size() const { return data.size(); }
 };
 
 void demonstrate_lazy_evaluation() {
@@ -754,36 +775,50 @@ void demonstrate_lazy_evaluation() {
 // 4. REAL-WORLD EXAMPLE: LINEAR ALGEBRA
 // ============================================================================
 
+// Contiguous row-major storage: one allocation, rows are adjacent in memory.
+// (vector<vector<T>> would cost one heap block per row and a pointer chase)
 template<typename T>
 class Matrix {
-    std::vector<std::vector<T>> data;
     size_t rows, cols;
+    std::vector<T> data;
     
 public:
-    Matrix(size_t r, size_t c) : rows(r), cols(c), data(r, std::vector<T>(c)) {}
+    Matrix(size_t r, size_t c) : rows(r), cols(c), data(r * c) {}
     
-    std::vector<T>& operator[](size_t i) { return data[i]; }
-    const std::vector<T>& operator[](size_t i) const { return data[i]; }
+    // Row access: m[i][j] still works, m[i] points at the start of row i
+    T* operator[](size_t i) { return data.data() + i * cols; }
+    const T* operator[](size_t i) const { return data.data() + i * cols; }
+    
+    void set_row(size_t i, std::initializer_list<T> values) {
+        std::copy(values.begin(), values.end(), (*this)[i]);
+    }
     
     size_t num_rows() const { return rows; }
     size_t num_cols() const { return cols; }
     
-    // Matrix multiplication using expression templates
+    // Matrix multiplication in i-k-j order: the inner loop streams a row of b
+    // and a row of result sequentially instead of striding down b's columns.
+    // For large sizes see Examples/Performance/gemm.cpp (blocked, packed,
+    // AVX2/FMA micro-kernel, multithreaded, fused elementwise epilogue).
     template<typename E1, typename E2>
     static Matrix multiply(const E1& a, const E2& b) {
+        if (a.num_cols() != b.num_rows()) {
+            throw std::invalid_argument("Matrix::multiply: inner dimensions differ");
+        }
         size_t n = a.num_rows();
         size_t m = a.num_cols();
         size_t p = b.num_cols();
         
-        Matrix result(n, p);
+        Matrix result(n, p);  // zero-initialized
         
         for (size_t i = 0; i < n; ++i) {
-            for (size_t j = 0; j < p; ++j) {
-                T sum = 0;
-                for (size_t k = 0; k < m; ++k) {
-                    sum += a[i][k] * b[k][j];
+            T* out = result[i];
+            for (size_t k = 0; k < m; ++k) {
+                const T aik = a[i][k];
+                const auto* b_row = b[k];
+                for (size_t j = 0; j < p; ++j) {
+                    out[j] += aik * b_row[j];
                 }
-                result[i][j] = sum;
             }
         }
         
@@ -798,12 +833,12 @@ void demonstrate_matrix_operations() {
     Matrix<double> B(3, 2);
     
     // Initialize matrices
-    A[0] = {1, 2, 3};
-    A[1] = {4, 5, 6};
+    A.set_row(0, {1, 2, 3});
+    A.set_row(1, {4, 5, 6});
     
-    B[0] = {7, 8};
-    B[1] = {9, 10};
-    B[2] = {11, 12};
+    B.set_row(0, {7, 8});
+    B.set_row(1, {9, 10});
+    B.set_row(2, {11, 12});
     
     // Matrix multiplication
     auto C = Matrix<double>::multiply(A, B);
@@ -847,13 +882,20 @@ void explain_benefits() {
     std::cout << "- Templates create expression trees at compile time\n";
     std::cout << "- Evaluation happens in a single pass\n";
     std::cout << "- Each element computed once, not stored intermediately\n";
+    
+    std::cout << "\nGoing further (Examples/Performance/simd_expression.cpp):\n";
+    std::cout << "- Give every node eval_packet<W>(i) returning W lanes at once\n";
+    std::cout << "- Vectorized sqrt/sin instead of scalar libm calls\n";
+    std::cout << "- Aligned storage + chunked multithreaded assignment\n";
 }
 
 
 #include <iostream>
 #include <vector>
+#include <algorithm>
 #include <cmath>
 #include <chrono>
+#include <stdexcept>
 
 // ============================================================================
 // 1. PROBLEM: TEMPORARY OBJECTS IN VECTOR OPERATIONS
@@ -1124,7 +1166,8 @@ void demonstrate_expression_templates() {
 
 template<typename T>
 class LazyVector {
-    mutable std::vector<T>* data = nullptr;
+    // Held by value: no extra heap block (and no leak/double free on copy)
+    std::vector<T> data;
     
     // Expression type
     template<typename E>
@@ -1146,15 +1189,13 @@ class LazyVector {
 public:
     template<typename E>
     LazyVector(const VecExpression<E>& expr) 
-        : data(new std::vector<T>(Expression<E>(static_cast<const E&>(expr)))) {}
-    
-    ~LazyVector() { delete data; }
+        : data(Expression<E>(static_cast<const E&>(expr))) {}
     
     const T& operator[](size_t i) const {
-        return (*data)[i];
+        return data[i];
     }
     
-    size_t size() const { return data->size(); }
+    size_t size() const { return data.size(); }
 };
 
 void demonstrate_lazy_evaluation() {
@@ -1180,36 +1221,50 @@ void demonstrate_lazy_evaluation() {
 // 4. REAL-WORLD EXAMPLE: LINEAR ALGEBRA
 // ============================================================================
 
+// Contiguous row-major storage: one allocation, rows are adjacent in memory.
+// (vector<vector<T>> would cost one heap block per row and a pointer chase)
 template<typename T>
 class Matrix {
-    std::vector<std::vector<T>> data;
     size_t rows, cols;
+    std::vector<T> data;
     
 public:
-    Matrix(size_t r, size_t c) : rows(r), cols(c), data(r, std::vector<T>(c)) {}
+    Matrix(size_t r, size_t c) : rows(r), cols(c), data(r * c) {}
     
-    std::vector<T>& operator[](size_t i) { return data[i]; }
-    const std::vector<T>& operator[](size_t i) const { return data[i]; }
+    // Row access: m[i][j] still works, m[i] points at the start of row i
+    T* operator[](size_t i) { return data.data() + i * cols; }
+    const T* operator[](size_t i) const { return data.data() + i * cols; }
+    
+    void set_row(size_t i, std::initializer_list<T> values) {
+        std::copy(values.begin(), values.end(), (*this)[i]);
+    }
     
     size_t num_rows() const { return rows; }
     size_t num_cols() const { return cols; }
     
-    // Matrix multiplication using expression templates
+    // Matrix multiplication in i-k-j order: the inner loop streams a row of b
+    // and a row of result sequentially instead of striding down b's columns.
+    // For large sizes see Examples/Performance/gemm.cpp (blocked, packed,
+    // AVX2/FMA micro-kernel, multithreaded, fused elementwise epilogue).
     template<typename E1, typename E2>
     static Matrix multiply(const E1& a, const E2& b) {
+        if (a.num_cols() != b.num_rows()) {
+            throw std::invalid_argument("Matrix::multiply: inner dimensions differ");
+        }
         size_t n = a.num_rows();
         size_t m = a.num_cols();
         size_t p = b.num_cols();
         
-        Matrix result(n, p);
+        Matrix result(n, p);  // zero-initialized
         
         for (size_t i = 0; i < n; ++i) {
-            for (size_t j = 0; j < p; ++j) {
-                T sum = 0;
-                for (size_t k = 0; k < m; ++k) {
-                    sum += a[i][k] * b[k][j];
+            T* out = result[i];
+            for (size_t k = 0; k < m; ++k) {
+                const T aik = a[i][k];
+                const auto* b_row = b[k];
+                for (size_t j = 0; j < p; ++j) {
+                    out[j] += aik * b_row[j];
                 }
-                result[i][j] = sum;
             }
         }
         
@@ -1224,12 +1279,12 @@ void demonstrate_matrix_operations() {
     Matrix<double> B(3, 2);
     
     // Initialize matrices
-    A[0] = {1, 2, 3};
-    A[1] = {4, 5, 6};
+    A.set_row(0, {1, 2, 3});
+    A.set_row(1, {4, 5, 6});
     
-    B[0] = {7, 8};
-    B[1] = {9, 10};
-    B[2] = {11, 12};
+    B.set_row(0, {7, 8});
+    B.set_row(1, {9, 10});
+    B.set_row(2, {11, 12});
     
     // Matrix multiplication
     auto C = Matrix<double>::multiply(A, B);
@@ -1273,12 +1328,19 @@ void explain_benefits() {
     std::cout << "- Templates create expression trees at compile time\n";
     std::cout << "- Evaluation happens in a single pass\n";
     std::cout << "- Each element computed once, not stored intermediately\n";
+    
+    std::cout << "\nGoing further (Examples/Performance/simd_expression.cpp):\n";
+    std::cout << "- Give every node eval_packet<W>(i) returning W lanes at once\n";
+    std::cout << "- Vectorized sqrt/sin instead of scalar libm calls\n";
+    std::cout << "- Aligned storage + chunked multithreaded assignment\n";
 }
 
 #include <iostream>
 #include <vector>
+#include <algorithm>
 #include <cmath>
 #include <chrono>
+#include <stdexcept>
 
 // ============================================================================
 // 1. PROBLEM: TEMPORARY OBJECTS IN VECTOR OPERATIONS
@@ -1549,7 +1611,8 @@ void demonstrate_expression_templates() {
 
 template<typename T>
 class LazyVector {
-    mutable std::vector<T>* data = nullptr;
+    // Held by value: no extra heap block (and no leak/double free on copy)
+    std::vector<T> data;
     
     // Expression type
     template<typename E>
@@ -1571,15 +1634,13 @@ class LazyVector {
 public:
     template<typename E>
     LazyVector(const VecExpression<E>& expr) 
-        : data(new std::vector<T>(Expression<E>(static_cast<const E&>(expr)))) {}
-    
-    ~LazyVector() { delete data; }
+        : data(Expression<E>(static_cast<const E&>(expr))) {}
     
     const T& operator[](size_t i) const {
-        return (*data)[i];
+        return data[i];
     }
     
-    size_t size() const { return data->size(); }
+    size_t size() const { return data.size(); }
 };
 
 void demonstrate_lazy_evaluation() {
@@ -1605,36 +1666,50 @@ void demonstrate_lazy_evaluation() {
 // 4. REAL-WORLD EXAMPLE: LINEAR ALGEBRA
 // ============================================================================
 
+// Contiguous row-major storage: one allocation, rows are adjacent in memory.
+// (vector<vector<T>> would cost one heap block per row and a pointer chase)
 template<typename T>
 class Matrix {
-    std::vector<std::vector<T>> data;
     size_t rows, cols;
+    std::vector<T> data;
     
 public:
-    Matrix(size_t r, size_t c) : rows(r), cols(c), data(r, std::vector<T>(c)) {}
+    Matrix(size_t r, size_t c) : rows(r), cols(c), data(r * c) {}
     
-    std::vector<T>& operator[](size_t i) { return data[i]; }
-    const std::vector<T>& operator[](size_t i) const { return data[i]; }
+    // Row access: m[i][j] still works, m[i] points at the start of row i
+    T* operator[](size_t i) { return data.data() + i * cols; }
+    const T* operator[](size_t i) const { return data.data() + i * cols; }
+    
+    void set_row(size_t i, std::initializer_list<T> values) {
+        std::copy(values.begin(), values.end(), (*this)[i]);
+    }
     
     size_t num_rows() const { return rows; }
     size_t num_cols() const { return cols; }
     
-    // Matrix multiplication using expression templates
+    // Matrix multiplication in i-k-j order: the inner loop streams a row of b
+    // and a row of result sequentially instead of striding down b's columns.
+    // For large sizes see Examples/Performance/gemm.cpp (blocked, packed,
+    // AVX2/FMA micro-kernel, multithreaded, fused elementwise epilogue).
     template<typename E1, typename E2>
     static Matrix multiply(const E1& a, const E2& b) {
+        if (a.num_cols() != b.num_rows()) {
+            throw std::invalid_argument("Matrix::multiply: inner dimensions differ");
+        }
         size_t n = a.num_rows();
         size_t m = a.num_cols();
         size_t p = b.num_cols();
         
-        Matrix result(n, p);
+        Matrix result(n, p);  // zero-initialized
         
         for (size_t i = 0; i < n; ++i) {
-            for (size_t j = 0; j < p; ++j) {
-                T sum = 0;
-                for (size_t k = 0; k < m; ++k) {
-                    sum += a[i][k] * b[k][j];
+            T* out = result[i];
+            for (size_t k = 0; k < m; ++k) {
+                const T aik = a[i][k];
+                const auto* b_row = b[k];
+                for (size_t j = 0; j < p; ++j) {
+                    out[j] += aik * b_row[j];
                 }
-                result[i][j] = sum;
             }
         }
         
@@ -1649,12 +1724,12 @@ void demonstrate_matrix_operations() {
     Matrix<double> B(3, 2);
     
     // Initialize matrices
-    A[0] = {1, 2, 3};
-    A[1] = {4, 5, 6};
+    A.set_row(0, {1, 2, 3});
+    A.set_row(1, {4, 5, 6});
     
-    B[0] = {7, 8};
-    B[1] = {9, 10};
-    B[2] = {11, 12};
+    B.set_row(0, {7, 8});
+    B.set_row(1, {9, 10});
+    B.set_row(2, {11, 12});
     
     // Matrix multiplication
     auto C = Matrix<double>::multiply(A, B);
@@ -1698,6 +1773,11 @@ void explain_benefits() {
     std::cout << "- Templates create expression trees at compile time\n";
     std::cout << "- Evaluation happens in a single pass\n";
     std::cout << "- Each element computed once, not stored intermediately\n";
+    
+    std::cout << "\nGoing further (Examples/Performance/simd_expression.cpp):\n";
+    std::cout << "- Give every node eval_packet<W>(i) returning W lanes at once\n";
+    std::cout << "- Vectorized sqrt/sin instead of scalar libm calls\n";
+    std::cout << "- Aligned storage + chunked multithreaded assignment\n";
 }
 
 
@@ -2188,6 +2268,11 @@ int main() {
 #include <type_traits>
 #include <array>
 #include <tuple>
+#include <vector>
+#include <cassert>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
 
 // 1. CRTP (Curiously Recurring Template Pattern)
 template<typename Derived>
@@ -2360,22 +2445,22 @@ struct Visitor<T, Rest...> : Visitor<Rest...> {
 };
 
 // 9. Policy-based Design
+// Readers take the policy's shared lock, writers the exclusive one. For
+// seqlock/RCU policies and storage that never moves elements, see
+// Examples/Performance/concurrent_container.cpp
 template<typename StoragePolicy, typename LockingPolicy>
 class Container : private StoragePolicy, private LockingPolicy {
 public:
     template<typename T>
     void add(const T& value) {
-        LockingPolicy::lock();
+        std::lock_guard<LockingPolicy> lock(*this);
         StoragePolicy::add(value);
-        LockingPolicy::unlock();
     }
     
     template<typename T>
     T get(size_t index) {
-        LockingPolicy::lock();
-        T value = StoragePolicy::template get<T>(index);
-        LockingPolicy::unlock();
-        return value;
+        std::shared_lock<LockingPolicy> lock(*this);
+        return static_cast<T>(StoragePolicy::get(index));
     }
 };
 
@@ -2389,8 +2474,10 @@ public:
         data.push_back(value);
     }
     
+    // Callers check the size; .at() would pay a branch on every access
     int get(size_t index) {
-        return data.at(index);
+        assert(index < data.size());
+        return data[index];
     }
 };
 
@@ -2419,12 +2506,28 @@ class NoLock {
 public:
     void lock() {}
     void unlock() {}
+    void lock_shared() {}
+    void unlock_shared() {}
 };
 
 class MockLock {
 public:
     void lock() { std::cout << "Lock acquired\n"; }
     void unlock() { std::cout << "Lock released\n"; }
+    void lock_shared() { std::cout << "Shared lock acquired\n"; }
+    void unlock_shared() { std::cout << "Shared lock released\n"; }
+};
+
+// Concurrent readers, exclusive writers
+class SharedMutexLock {
+private:
+    std::shared_mutex mutex;
+
+public:
+    void lock() { mutex.lock(); }
+    void unlock() { mutex.unlock(); }
+    void lock_shared() { mutex.lock_shared(); }
+    void unlock_shared() { mutex.unlock_shared(); }
 };
 
 int main() {
@@ -2468,5 +2571,9 @@ int main() {
     arrayContainer.add(20);
     std::cout << "Array element 1: " << arrayContainer.get<int>(1) << "\n";
     
+    Container<VectorStorage, SharedMutexLock> sharedContainer;
+    sharedContainer.add(7);
+    std::cout << "Shared element 0: " << sharedContainer.get<int>(0) << "\n";
+    
     return 0;
 }
\ No newline at end of file
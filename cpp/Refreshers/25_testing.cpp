@@ -961,6 +961,8 @@ int main() {
 //// FUZZING
 
 // fuzzing_example.cpp
+#include <cassert>
+#include <climits>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
@@ -1023,49 +1025,37 @@ extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
 }
 
 // Custom fuzzer with coverage guidance
+// The "coverage" here is simulated; Examples/Performance/coverage_fuzzer.cpp
+// is the real thing: -fsanitize-coverage edge counters, a corpus weighted
+// toward rare edges, comparison-operand mutations and forked workers that
+// save crashing inputs
 class CustomFuzzer {
 private:
     std::vector<uint8_t> corpus;
+    std::vector<uint8_t> scratch;  // mutated in place, reused every iteration
     size_t mutations = 1000;
     
     // Mutation strategies
-    void bitFlip(uint8_t* data, size_t size) {
-        if (size == 0) return;
-        size_t pos = rand() % size;
+    void bitFlip(std::vector<uint8_t>& data) {
+        if (data.empty()) return;
+        size_t pos = rand() % data.size();
         data[pos] ^= 1 << (rand() % 8);
     }
     
-    void byteChange(uint8_t* data, size_t size) {
-        if (size == 0) return;
-        size_t pos = rand() % size;
+    void byteChange(std::vector<uint8_t>& data) {
+        if (data.empty()) return;
+        size_t pos = rand() % data.size();
         data[pos] = rand() % 256;
     }
     
-    void insertByte(uint8_t*& data, size_t& size) {
-        size_t pos = rand() % (size + 1);
-        uint8_t* newData = new uint8_t[size + 1];
-        
-        memcpy(newData, data, pos);
-        newData[pos] = rand() % 256;
-        memcpy(newData + pos + 1, data + pos, size - pos);
-        
-        delete[] data;
-        data = newData;
-        size++;
+    void insertByte(std::vector<uint8_t>& data) {
+        size_t pos = rand() % (data.size() + 1);
+        data.insert(data.begin() + pos, static_cast<uint8_t>(rand() % 256));
     }
     
-    void deleteByte(uint8_t*& data, size_t& size) {
-        if (size <= 1) return;
-        
-        size_t pos = rand() % size;
-        uint8_t* newData = new uint8_t[size - 1];
-        
-        memcpy(newData, data, pos);
-        memcpy(newData + pos, data + pos + 1, size - pos - 1);
-        
-        delete[] data;
-        data = newData;
-        size--;
+    void deleteByte(std::vector<uint8_t>& data) {
+        if (data.size() <= 1) return;
+        data.erase(data.begin() + rand() % data.size());
     }
     
 public:
@@ -1078,36 +1068,33 @@ public:
                      initialInput.end());
         
         for (size_t i = 0; i < mutations; ++i) {
-            // Create a mutation of the corpus
-            size_t size = corpus.size();
-            uint8_t* data = new uint8_t[size];
-            memcpy(data, corpus.data(), size);
+            // Create a mutation of the corpus (assign keeps the capacity,
+            // so this stops allocating once the buffer has grown)
+            scratch.assign(corpus.begin(), corpus.end());
             
             // Apply random mutation
             int mutationType = rand() % 4;
             switch (mutationType) {
-                case 0: bitFlip(data, size); break;
-                case 1: byteChange(data, size); break;
-                case 2: insertByte(data, size); break;
-                case 3: deleteByte(data, size); break;
+                case 0: bitFlip(scratch); break;
+                case 1: byteChange(scratch); break;
+                case 2: insertByte(scratch); break;
+                case 3: deleteByte(scratch); break;
             }
             
             // Execute with mutated input
             try {
-                LLVMFuzzerTestOneInput(data, size);
+                LLVMFuzzerTestOneInput(scratch.data(), scratch.size());
                 
                 // If execution was interesting (found new paths), 
                 // add to corpus
                 if (rand() % 10 == 0) {  // Simulated coverage feedback
-                    corpus.assign(data, data + size);
+                    corpus.assign(scratch.begin(), scratch.end());
                 }
             }
             catch (...) {
-                std::cout << "Exception caught with input of size " << size << "\n";
+                std::cout << "Exception caught with input of size " << scratch.size() << "\n";
             }
             
-            delete[] data;
-            
             if (i % 100 == 0) {
                 std::cout << "Processed " << i << " mutations\n";
             }
@@ -1247,8 +1234,12 @@ int main() {
 #include <sstream>
 #include <fstream>
 #include <random>
+#include <unordered_map>
 
 // System components for integration testing
+// Test doubles, not meant to be fast: Examples/Performance/kv_engine.cpp
+// replaces Database and Cache with a typed in-process KV engine (hash index,
+// batched writes, optional log with group commit) for load tests
 class Database {
 private:
     std::vector<std::pair<std::string, std::string>> data;
@@ -1256,7 +1247,9 @@ private:
 public:
     bool connect(const std::string& connectionString) {
         std::cout << "Database connecting to: " << connectionString << "\n";
-        return connectionString.find("test.db") != std::string::npos;
+        const std::string suffix = ".db";
+        return connectionString.size() > suffix.size() &&
+               connectionString.compare(connectionString.size() - suffix.size(), suffix.size(), suffix) == 0;
     }
     
     bool execute(const std::string& query) {
@@ -1269,8 +1262,12 @@ public:
             if (valuesPos != std::string::npos) {
                 std::string values = query.substr(valuesPos + 7);
                 size_t commaPos = values.find(',');
-                if (commaPos != std::string::npos) {
-                    std::string key = values.substr(1, commaPos - 2);  // Remove quotes
+                if (commaPos != std::string::npos && commaPos > 0) {
+                    std::string key = values.substr(1, commaPos - 1);  // Skip "("
+                    // Strip quotes only when present: (1, ...) has none
+                    if (key.size() >= 2 && key.front() == '\'' && key.back() == '\'') {
+                        key = key.substr(1, key.size() - 2);
+                    }
                     std::string value = values.substr(commaPos + 2, 
                                                      values.length() - commaPos - 3);
                     data.emplace_back(key, value);
@@ -1532,7 +1529,7 @@ public:
         std::cout << "TEST: System Initialization\n";
         std::cout << "---------------------------\n";
         
-        assert(!system.initialize());  // First init should fail without proper DB
+        assert(system.initialize());  // connect() accepts any ".db" test database
         // Note: In real test, we'd mock or setup test database
         
         std::cout << "✓ Initialization test completed\n\n";
@@ -1766,6 +1763,9 @@ int main() {
 #include <memory>
 #include <map>
 #include <unordered_map>
+#include <string>
+#include <typeinfo>
+#include <cstdint>
 #include <benchmark/benchmark.h>  // Google Benchmark
 
 // Microbenchmark examples using Google Benchmark
@@ -1921,16 +1921,22 @@ static void BM_CacheUnfriendly(benchmark::State& state) {
 BENCHMARK(BM_CacheUnfriendly)->Range(64, 512);
 
 // Custom performance test framework
+// (Examples/bench_harness.hpp is the full version: iteration calibration,
+// MAD outlier rejection, CPU pinning, perf counters, JSON and a regression
+// comparator; Examples/Performance/bench_suite.cpp runs these tests on it)
 class PerformanceTest {
 public:
     struct TestResult {
         std::string name;
         double average_time_ms;
+        double median_time_ms;
         double min_time_ms;
         double max_time_ms;
-        double throughput;  // operations per second
+        double throughput;  // operations per second, from the median
     };
     
+    virtual ~PerformanceTest() = default;
+    virtual std::string name() const { return typeid(*this).name(); }  // mangled; override it
     virtual void setup() {}
     virtual void run() = 0;
     virtual void teardown() {}
@@ -1941,27 +1947,31 @@ public:
             run();
         }
         
-        // Actual measurement
+        // Actual measurement; steady_clock, high_resolution_clock may be
+        // the wall clock and jump
         std::vector<double> times;
         times.reserve(iterations);
         
         for (int i = 0; i < iterations; ++i) {
-            auto start = std::chrono::high_resolution_clock::now();
+            auto start = std::chrono::steady_clock::now();
             run();
-            auto end = std::chrono::high_resolution_clock::now();
+            auto end = std::chrono::steady_clock::now();
             
             double duration = std::chrono::duration<double, std::milli>(end - start).count();
             times.push_back(duration);
         }
         
-        // Calculate statistics
+        // Calculate statistics; the median ignores the odd preempted run
+        // that drags the average
+        std::sort(times.begin(), times.end());
         double sum = std::accumulate(times.begin(), times.end(), 0.0);
         double avg = sum / iterations;
-        double min = *std::min_element(times.begin(), times.end());
-        double max = *std::max_element(times.begin(), times.end());
-        double throughput = 1000.0 / avg;  // operations per second
+        double median = times[times.size() / 2];
+        double min = times.front();
+        double max = times.back();
+        double throughput = 1000.0 / median;  // operations per second
         
-        return {typeid(*this).name(), avg, min, max, throughput};
+        return {name(), avg, median, min, max, throughput};
     }
 };
 
@@ -1972,6 +1982,8 @@ private:
     int result;
     
 public:
+    std::string name() const override { return "VectorSum"; }
+    
     void setup() override {
         // Initialize with 1M elements
         data.resize(1000000);
@@ -2001,6 +2013,8 @@ private:
     int result;
     
 public:
+    std::string name() const override { return "LinkedListSum"; }
+    
     void setup() override {
         // Create linked list with 1M elements
         head = nullptr;
@@ -2037,17 +2051,20 @@ public:
 class MemoryBandwidthTest {
 public:
     static double testReadBandwidth(size_t size) {
-        std::vector<char> buffer(size, 1);
-        volatile char sink;  // Prevent optimization
+        // Word loads summed into a result that is kept; one volatile char
+        // store per byte measured the store loop, not the memory
+        std::vector<uint64_t> buffer(size / sizeof(uint64_t), 1);
+        uint64_t sum = 0;
         
-        auto start = std::chrono::high_resolution_clock::now();
+        auto start = std::chrono::steady_clock::now();
         
         // Read entire buffer
-        for (size_t i = 0; i < size; ++i) {
-            sink = buffer[i];
+        for (uint64_t word : buffer) {
+            sum += word;
         }
+        benchmark::DoNotOptimize(sum);
         
-        auto end = std::chrono::high_resolution_clock::now();
+        auto end = std::chrono::steady_clock::now();
         
         double time_ms = std::chrono::duration<double, std::milli>(end - start).count();
         double bandwidth_mb_s = (size / (1024.0 * 1024.0)) / (time_ms / 1000.0);
@@ -2058,14 +2075,15 @@ public:
     static double testWriteBandwidth(size_t size) {
         std::vector<char> buffer(size);
         
-        auto start = std::chrono::high_resolution_clock::now();
+        auto start = std::chrono::steady_clock::now();
         
         // Write to entire buffer
         for (size_t i = 0; i < size; ++i) {
             buffer[i] = static_cast<char>(i);
         }
+        benchmark::ClobberMemory();
         
-        auto end = std::chrono::high_resolution_clock::now();
+        auto end = std::chrono::steady_clock::now();
         
         double time_ms = std::chrono::duration<double, std::milli>(end - start).count();
         double bandwidth_mb_s = (size / (1024.0 * 1024.0)) / (time_ms / 1000.0);
@@ -2153,12 +2171,12 @@ void runPerformanceComparisons() {
     auto listResult = listTest.execute(100, 10);
     listTest.teardown();
     
-    std::cout << "Vector - Avg time: " << vectorResult.average_time_ms 
+    std::cout << "Vector - Median time: " << vectorResult.median_time_ms 
               << "ms, Throughput: " << vectorResult.throughput << " ops/sec\n";
-    std::cout << "LinkedList - Avg time: " << listResult.average_time_ms 
+    std::cout << "LinkedList - Median time: " << listResult.median_time_ms 
               << "ms, Throughput: " << listResult.throughput << " ops/sec\n";
     
-    double speedup = listResult.average_time_ms / vectorResult.average_time_ms;
+    double speedup = listResult.median_time_ms / vectorResult.median_time_ms;
     std::cout << "Vector is " << speedup << "x faster than LinkedList\n\n";
     
     // Memory bandwidth tests
@@ -2220,6 +2238,7 @@ int main(int argc, char** argv) {
 #include <latch>
 #include <semaphore>
 #include <memory>
+#include <optional>
 #include <cassert>
 
 // Non-deterministic counter (problematic for testing)
@@ -2242,7 +2261,7 @@ public:
 class MutexCounter {
 private:
     int value = 0;
-    std::mutex mtx;
+    mutable std::mutex mtx;  // get() is const
     
 public:
     void increment() {
@@ -2272,6 +2291,10 @@ public:
 };
 
 // Test helper for deterministic thread scheduling
+// Only the start and the end are synchronized; the interleaving in between
+// is still the OS's. Examples/Performance/schedule_explorer.cpp runs these
+// classes under a scheduler that picks every interleaving (random, PCT or
+// bounded DFS) and replays failures from a schedule string
 class DeterministicScheduler {
 private:
     std::vector<std::function<void()>> tasks;
@@ -2405,7 +2428,7 @@ void testCounterDeterministic() {
 class ProducerConsumer {
 private:
     std::queue<int> queue;
-    std::mutex mtx;
+    mutable std::mutex mtx;
     std::condition_variable cv;
     bool done = false;
     const size_t max_size;
@@ -2460,7 +2483,10 @@ void testProducerConsumerDeterministic() {
     std::vector<int> consumed_items;
     std::mutex consumed_mtx;
     
-    DeterministicScheduler scheduler(NUM_PRODUCERS + NUM_CONSUMERS);
+    // Consumers only return after finish(), so they cannot be scheduler
+    // tasks: run() would wait for them before finish() is ever called
+    DeterministicScheduler scheduler(NUM_PRODUCERS);
+    std::vector<std::thread> consumers;
     
     // Setup producers
     for (int i = 0; i < NUM_PRODUCERS; ++i) {
@@ -2473,7 +2499,7 @@ void testProducerConsumerDeterministic() {
     
     // Setup consumers
     for (int i = 0; i < NUM_CONSUMERS; ++i) {
-        scheduler.setTask(NUM_PRODUCERS + i, [&pc, &consumed_items, &consumed_mtx]() {
+        consumers.emplace_back([&pc, &consumed_items, &consumed_mtx]() {
             while (true) {
                 auto item = pc.consume();
                 if (!item) break;
@@ -2484,11 +2510,14 @@ void testProducerConsumerDeterministic() {
         });
     }
     
-    // Run producers and consumers
+    // Run producers
     scheduler.run();
     
     // Signal completion and let consumers finish
     pc.finish();
+    for (auto& consumer : consumers) {
+        consumer.join();
+    }
     
     // Verify all items were produced and consumed
     int expected_total = NUM_PRODUCERS * ITEMS_PER_PRODUCER;
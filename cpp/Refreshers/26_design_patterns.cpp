@@ -1459,6 +1459,7 @@ void adapterExample() {
 #include <string>
 #include <vector>
 #include <functional>
+#include <string_view>
 
 // ========== BASIC DECORATOR ==========
 class Beverage {
@@ -1549,10 +1550,13 @@ public:
 };
 
 // ========== STREAM DECORATOR ==========
+// Each layer below still materialises a new string per write. For a chain
+// that hands pooled chunks down by ownership, transforms them in place and
+// flushes with writev, see Examples/Performance/zero_copy_stream.cpp
 class OutputStream {
 public:
     virtual ~OutputStream() = default;
-    virtual void write(const std::string& data) = 0;
+    virtual void write(std::string_view data) = 0;
     virtual void flush() = 0;
 };
 
@@ -1565,7 +1569,7 @@ public:
         std::cout << "Opening file: " << filename << "\n";
     }
     
-    void write(const std::string& data) override {
+    void write(std::string_view data) override {
         std::cout << "Writing to file: " << data << "\n";
     }
     
@@ -1583,7 +1587,7 @@ public:
     explicit StreamDecorator(std::unique_ptr<OutputStream> stream)
         : stream(std::move(stream)) {}
     
-    void write(const std::string& data) override {
+    void write(std::string_view data) override {
         stream->write(data);
     }
     
@@ -1599,9 +1603,11 @@ private:
     
 public:
     BufferedStream(std::unique_ptr<OutputStream> stream, size_t size = 1024)
-        : StreamDecorator(std::move(stream)), bufferSize(size) {}
+        : StreamDecorator(std::move(stream)), bufferSize(size) {
+        buffer.reserve(size);   // one allocation, reused across flushes
+    }
     
-    void write(const std::string& data) override {
+    void write(std::string_view data) override {
         buffer += data;
         if (buffer.size() >= bufferSize) {
             flush();
@@ -1622,9 +1628,11 @@ public:
     explicit CompressedStream(std::unique_ptr<OutputStream> stream)
         : StreamDecorator(std::move(stream)) {}
     
-    void write(const std::string& data) override {
+    void write(std::string_view data) override {
         // Simulate compression
-        std::string compressed = "COMPRESSED[" + data + "]";
+        std::string compressed;
+        compressed.reserve(data.size() + 12);
+        compressed.append("COMPRESSED[").append(data).append("]");
         stream->write(compressed);
     }
 };
@@ -1637,9 +1645,9 @@ public:
     EncryptedStream(std::unique_ptr<OutputStream> stream, int key = 42)
         : StreamDecorator(std::move(stream)), key(key) {}
     
-    void write(const std::string& data) override {
+    void write(std::string_view data) override {
         // Simple XOR encryption
-        std::string encrypted = data;
+        std::string encrypted(data);
         for (char& c : encrypted) {
             c ^= key;
         }
@@ -3230,6 +3238,10 @@ public:
 };
 
 // Composite: Directory
+// getSize() walks the whole subtree on every call and remove() scans all
+// children. Examples/Performance/composite_fs.cpp keeps cached subtree
+// totals, an O(1) remove, a name index and a parallel visitor traversal
+// for trees with millions of nodes
 class Directory : public FileSystemComponent {
 private:
     std::string name;
@@ -3721,6 +3733,7 @@ void compositeExample() {
 #include <unordered_map>
 #include <functional>
 #include <mutex>
+#include <typeindex>
 
 // ========== CLASSIC OBSERVER ==========
 class IObserver {
@@ -3915,44 +3928,55 @@ public:
     }
 };
 
+// Handler lists are immutable snapshots: subscribe copies the list and swaps
+// in a new one, publish only takes a reference under the lock. Publishing no
+// longer copies every std::function on each event (subscribe is the rare path).
+// Handlers are keyed by payload type, so the per-call dynamic_cast is gone.
+// For handler storage without std::function's copy/RTTI overhead see
+// Examples/small_function.hpp.
 class EventBus {
 private:
     using EventHandler = std::function<void(const Event&)>;
-    std::unordered_map<std::string, std::vector<EventHandler>> handlers;
+    using HandlerList = std::vector<EventHandler>;
+    std::unordered_map<std::type_index, std::shared_ptr<const HandlerList>> handlers;
     std::mutex mutex;
     
 public:
     // Subscribe to event type
     template<typename EventType>
     void subscribe(std::function<void(const EventType&)> handler) {
+        using Data = std::remove_cv_t<std::remove_reference_t<EventType>>;
+        
+        // Convert typed handler to generic handler; only TypedEvent<Data>
+        // is ever published under this key
+        EventHandler generic = [handler = std::move(handler)](const Event& event) {
+            handler(static_cast<const TypedEvent<Data>&>(event).getData());
+        };
+        
         std::lock_guard<std::mutex> lock(mutex);
-        std::string typeName = typeid(EventType).name();
-        
-        // Convert typed handler to generic handler
-        handlers[typeName].push_back([handler](const Event& event) {
-            if (auto typedEvent = dynamic_cast<const TypedEvent<
-                typename std::remove_const<
-                typename std::remove_reference<EventType>::type>::type>*>(&event)) {
-                handler(typedEvent->getData());
-            }
-        });
+        auto& current = handlers[std::type_index(typeid(Data))];
+        auto updated = current ? std::make_shared<HandlerList>(*current)
+                               : std::make_shared<HandlerList>();
+        updated->push_back(std::move(generic));
+        current = std::move(updated);
     }
     
     // Publish event
-    template<typename EventType>
-    void publish(const EventType& event) {
-        std::string typeName = typeid(EventType).name();
-        std::vector<EventHandler> localHandlers;
+    template<typename T>
+    void publish(const TypedEvent<T>& event) {
+        std::shared_ptr<const HandlerList> snapshot;
         
         {
             std::lock_guard<std::mutex> lock(mutex);
-            auto it = handlers.find(typeName);
+            auto it = handlers.find(std::type_index(typeid(T)));
             if (it != handlers.end()) {
-                localHandlers = it->second;
+                snapshot = it->second;
             }
         }
         
-        for (const auto& handler : localHandlers) {
+        if (!snapshot) return;
+        // Handlers run without the lock and may subscribe re-entrantly
+        for (const auto& handler : *snapshot) {
             handler(event);
         }
     }
@@ -4201,7 +4225,6 @@ public:
 class BubbleSort : public SortStrategy {
 public:
     void sort(std::vector<int>& data) const override {
-        std::cout << "Using Bubble Sort\n";
         for (size_t i = 0; i < data.size(); ++i) {
             for (size_t j = 0; j < data.size() - i - 1; ++j) {
                 if (data[j] > data[j + 1]) {
@@ -4227,6 +4250,13 @@ private:
     }
     
     int partition(std::vector<int>& data, int low, int high) const {
+        // Median-of-three: move the median of low/mid/high into data[high].
+        // A plain "last element" pivot is O(n^2) on already-sorted input.
+        int mid = low + (high - low) / 2;
+        if (data[mid] < data[low]) std::swap(data[mid], data[low]);
+        if (data[high] < data[low]) std::swap(data[high], data[low]);
+        if (data[mid] < data[high]) std::swap(data[mid], data[high]);
+        
         int pivot = data[high];
         int i = low - 1;
         
@@ -4242,7 +4272,6 @@ private:
     
 public:
     void sort(std::vector<int>& data) const override {
-        std::cout << "Using Quick Sort\n";
         if (!data.empty()) {
             quickSort(data, 0, data.size() - 1);
         }
@@ -4303,7 +4332,6 @@ private:
     
 public:
     void sort(std::vector<int>& data) const override {
-        std::cout << "Using Merge Sort\n";
         if (!data.empty()) {
             mergeSort(data, 0, data.size() - 1);
         }
@@ -4323,8 +4351,10 @@ public:
         strategy = std::move(newStrategy);
     }
     
+    // Strategies do no I/O themselves; reporting belongs to the context
     void sortData(std::vector<int>& data) const {
         if (strategy) {
+            std::cout << "Using " << strategy->getName() << "\n";
             auto dataCopy = data;  // Don't modify original
             strategy->sort(dataCopy);
             data = dataCopy;
@@ -4335,6 +4365,7 @@ public:
     
     void sortInPlace(std::vector<int>& data) const {
         if (strategy) {
+            std::cout << "Using " << strategy->getName() << "\n";
             strategy->sort(data);
         } else {
             std::cout << "No strategy set!\n";
@@ -4460,6 +4491,9 @@ public:
     }
 };
 
+// The codecs below only simulate compression. A real LZ4-style codec behind
+// this interface (parallel blocks, streaming over spans, random-access frames)
+// is in Examples/Performance/block_compression.cpp
 class ZipCompression : public CompressionStrategy {
 public:
     std::string compress(const std::string& data) const override {
@@ -4604,25 +4638,36 @@ auto lambdaStdSort = [](std::vector<int>& data) {
 };
 
 // ========== STRATEGY WITH TEMPLATES ==========
+// Generic over the element type and a key extractor (sort records by a field).
+// Radix, pdqsort, parallel sample sort and sorting-network policies:
+// see Examples/Performance/sort_strategies.cpp
+struct IdentityKey {
+    template<typename T>
+    const T& operator()(const T& x) const { return x; }
+};
+
 template<typename SortPolicy>
 class GenericSorter {
 public:
-    void sort(std::vector<int>& data) const {
-        SortPolicy::sort(data);
+    template<typename T, typename KeyFn = IdentityKey>
+    void sort(std::vector<T>& data, KeyFn key = {}) const {
+        SortPolicy::sort(data, key);
     }
 };
 
 struct StdSortPolicy {
-    static void sort(std::vector<int>& data) {
-        std::cout << "Template Policy: std::sort\n";
-        std::sort(data.begin(), data.end());
+    template<typename T, typename KeyFn>
+    static void sort(std::vector<T>& data, KeyFn key) {
+        std::sort(data.begin(), data.end(),
+                  [&key](const T& a, const T& b) { return key(a) < key(b); });
     }
 };
 
 struct StableSortPolicy {
-    static void sort(std::vector<int>& data) {
-        std::cout << "Template Policy: std::stable_sort\n";
-        std::stable_sort(data.begin(), data.end());
+    template<typename T, typename KeyFn>
+    static void sort(std::vector<T>& data, KeyFn key) {
+        std::stable_sort(data.begin(), data.end(),
+                         [&key](const T& a, const T& b) { return key(a) < key(b); });
     }
 };
 
@@ -4733,6 +4778,13 @@ void strategyExample() {
     std::cout << "stable_sort result: ";
     for (int n : nums5) std::cout << n << " ";
     std::cout << "\n";
+    
+    // Same policy, sorting records by a key extractor
+    std::vector<std::pair<std::string, int>> people = {{"Ann", 31}, {"Bob", 25}, {"Cid", 28}};
+    stableSorter.sort(people, [](const auto& p) { return p.second; });
+    std::cout << "by age: ";
+    for (const auto& p : people) std::cout << p.first << "(" << p.second << ") ";
+    std::cout << "\n";
 }
 
 
@@ -4755,6 +4807,9 @@ public:
 };
 
 // Receiver
+// One std::string: fine for a demo, O(n) per keystroke on large files. For a
+// piece-table buffer with O(log n) edits, a line index and piece-diff undo
+// with typing coalescing, see Examples/Performance/piece_table_editor.cpp
 class TextEditor {
 private:
     std::string text;
@@ -4791,7 +4846,7 @@ public:
         cursorPosition = text.length();
     }
     
-    std::string getText() const {
+    const std::string& getText() const {
         return text;
     }
     
@@ -4837,6 +4892,7 @@ class DeleteCommand : public Command {
 private:
     TextEditor& editor;
     int count;
+    int position = 0;   // cursor after the deletion
     std::string deletedText;
     bool executed;
     
@@ -4846,19 +4902,19 @@ public:
     
     void execute() override {
         int pos = editor.getCursorPosition();
-        std::string text = editor.getText();
         if (pos >= count) {
-            deletedText = text.substr(pos - count, count);
+            // Copy only the deleted range, not the whole document
+            deletedText = editor.getText().substr(pos - count, count);
             editor.deleteChars(count);
+            position = pos - count;
             executed = true;
         }
     }
     
     void undo() override {
         if (executed) {
-            editor.moveCursor(-editor.getCursorPosition());
+            editor.moveCursor(position - editor.getCursorPosition());
             editor.insert(deletedText);
-            editor.moveCursor(editor.getText().length() - editor.getCursorPosition());
             executed = false;
         }
     }
@@ -5097,10 +5153,13 @@ public:
 };
 
 // ========== COMMAND QUEUE (for Undo/Redo) ==========
+// One worker, one unbounded FIFO. For N workers, priority lanes with aging,
+// bounded submit, batch dequeue and latency histograms, see
+// Examples/Performance/command_engine.cpp
 class CommandQueue {
 private:
     std::queue<std::unique_ptr<Command>> queue;
-    std::mutex mutex;
+    mutable std::mutex mutex;   // size() is const
     std::condition_variable cv;
     bool running;
     std::thread worker;
@@ -5669,6 +5728,8 @@ public:
     }
 };
 
+// Walks the tree on every call. To evaluate one formula over many rows,
+// Examples/Performance/expr_compiler.cpp compiles it to bytecode instead
 class EvalVisitor : public ExprVisitor {
 private:
     std::unordered_map<std::string, double> variables;
@@ -5686,15 +5747,14 @@ public:
     }
     
     void visit(BinaryExpr& expr) override {
-        // Evaluate left
-        EvalVisitor leftVisitor = *this;
-        expr.getLeft()->accept(leftVisitor);
-        double leftResult = leftVisitor.getResult();
+        // Evaluate left, keep its result, then reuse this visitor for the
+        // right side (copying the visitor would copy the variable map)
+        expr.getLeft()->accept(*this);
+        double leftResult = result;
         
         // Evaluate right
-        EvalVisitor rightVisitor = *this;
-        expr.getRight()->accept(rightVisitor);
-        double rightResult = rightVisitor.getResult();
+        expr.getRight()->accept(*this);
+        double rightResult = result;
         
         // Apply operation
         switch (expr.getOp()) {
@@ -699,6 +699,7 @@ extern "C" {
 #pragma once
 #include <string>
 #include <cstdint>
+#include <cstring>
 #include <type_traits>
 
 // ===================== SEMANTIC VERSIONING =====================
@@ -963,7 +964,7 @@ struct MessageHeader {
 // Version 1.0 message format
 struct MessageV1 {
     MessageHeader header;
-    char data[256];  // Fixed size
+    char data[256];  // Upper bound; header.size says how much was sent
 };
 
 // Version 2.0 message format (extended)
@@ -975,37 +976,65 @@ struct MessageV2 {
 };
 #pragma pack(pop)
 
+// Validates a message in place and returns it (no copy); cast the result to
+// MessageV1/MessageV2 according to its version. For a streaming parser with
+// partial frames, typed views and a pooled writer, see
+// Examples/Performance/wire_protocol.cpp
 class MessageProcessor {
 public:
-    static void* parseMessage(const void* data, size_t size) {
-        const MessageHeader* header = static_cast<const MessageHeader*>(data);
+    static const void* parseMessage(const void* data, size_t size) {
+        if (size < sizeof(MessageHeader)) {
+            throw std::runtime_error("Message too small for header");
+        }
+        MessageHeader header;
+        std::memcpy(&header, data, sizeof(header));  // data may be unaligned
+        if (header.size > size) {
+            throw std::runtime_error("Truncated message");
+        }
         
-        switch (header->version) {
+        switch (header.version) {
             case 1:
-                return parseV1Message(data, size);
+                return parseV1Message(data, header);
             case 2:
-                return parseV2Message(data, size);
+                return parseV2Message(data, header);
             default:
                 throw std::runtime_error("Unsupported message version");
         }
     }
     
+    // Adler-32 over everything after the header
+    static uint32_t computeChecksum(const void* body, size_t size) {
+        const unsigned char* p = static_cast<const unsigned char*>(body);
+        uint32_t s1 = 1, s2 = 0;
+        for (size_t i = 0; i < size; ++i) {
+            s1 = (s1 + p[i]) % 65521;
+            s2 = (s2 + s1) % 65521;
+        }
+        return (s2 << 16) | s1;
+    }
+    
 private:
-    static void* parseV1Message(const void* data, size_t size) {
-        if (size < sizeof(MessageV1)) {
-            throw std::runtime_error("Message too small for v1");
+    static void verifyChecksum(const void* data, const MessageHeader& header) {
+        const char* body = static_cast<const char*>(data) + sizeof(MessageHeader);
+        if (computeChecksum(body, header.size - sizeof(MessageHeader)) != header.checksum) {
+            throw std::runtime_error("Checksum mismatch");
         }
-        // Parse v1 message
-        return nullptr;
     }
     
-    static void* parseV2Message(const void* data, size_t size) {
-        const MessageV2* msg = static_cast<const MessageV2*>(data);
-        if (size < sizeof(MessageV2)) {
+    static const void* parseV1Message(const void* data, const MessageHeader& header) {
+        if (header.size < sizeof(MessageHeader) || header.size > sizeof(MessageV1)) {
+            throw std::runtime_error("Bad size for v1 message");
+        }
+        verifyChecksum(data, header);
+        return data;
+    }
+    
+    static const void* parseV2Message(const void* data, const MessageHeader& header) {
+        if (header.size < sizeof(MessageV2)) {
             throw std::runtime_error("Message too small for v2");
         }
-        // Parse v2 message
-        return nullptr;
+        verifyChecksum(data, header);
+        return data;
     }
 };
 
@@ -1115,6 +1144,7 @@ void demonstrateVersioning() {
 #pragma once
 #include <string>
 #include <cstdint>
+#include <cstring>
 #include <type_traits>
 
 // ===================== SEMANTIC VERSIONING =====================
@@ -1379,7 +1409,7 @@ struct MessageHeader {
 // Version 1.0 message format
 struct MessageV1 {
     MessageHeader header;
-    char data[256];  // Fixed size
+    char data[256];  // Upper bound; header.size says how much was sent
 };
 
 // Version 2.0 message format (extended)
@@ -1391,37 +1421,65 @@ struct MessageV2 {
 };
 #pragma pack(pop)
 
+// Validates a message in place and returns it (no copy); cast the result to
+// MessageV1/MessageV2 according to its version. For a streaming parser with
+// partial frames, typed views and a pooled writer, see
+// Examples/Performance/wire_protocol.cpp
 class MessageProcessor {
 public:
-    static void* parseMessage(const void* data, size_t size) {
-        const MessageHeader* header = static_cast<const MessageHeader*>(data);
+    static const void* parseMessage(const void* data, size_t size) {
+        if (size < sizeof(MessageHeader)) {
+            throw std::runtime_error("Message too small for header");
+        }
+        MessageHeader header;
+        std::memcpy(&header, data, sizeof(header));  // data may be unaligned
+        if (header.size > size) {
+            throw std::runtime_error("Truncated message");
+        }
         
-        switch (header->version) {
+        switch (header.version) {
             case 1:
-                return parseV1Message(data, size);
+                return parseV1Message(data, header);
             case 2:
-                return parseV2Message(data, size);
+                return parseV2Message(data, header);
             default:
                 throw std::runtime_error("Unsupported message version");
         }
     }
     
+    // Adler-32 over everything after the header
+    static uint32_t computeChecksum(const void* body, size_t size) {
+        const unsigned char* p = static_cast<const unsigned char*>(body);
+        uint32_t s1 = 1, s2 = 0;
+        for (size_t i = 0; i < size; ++i) {
+            s1 = (s1 + p[i]) % 65521;
+            s2 = (s2 + s1) % 65521;
+        }
+        return (s2 << 16) | s1;
+    }
+    
 private:
-    static void* parseV1Message(const void* data, size_t size) {
-        if (size < sizeof(MessageV1)) {
-            throw std::runtime_error("Message too small for v1");
+    static void verifyChecksum(const void* data, const MessageHeader& header) {
+        const char* body = static_cast<const char*>(data) + sizeof(MessageHeader);
+        if (computeChecksum(body, header.size - sizeof(MessageHeader)) != header.checksum) {
+            throw std::runtime_error("Checksum mismatch");
         }
-        // Parse v1 message
-        return nullptr;
     }
     
-    static void* parseV2Message(const void* data, size_t size) {
-        const MessageV2* msg = static_cast<const MessageV2*>(data);
-        if (size < sizeof(MessageV2)) {
+    static const void* parseV1Message(const void* data, const MessageHeader& header) {
+        if (header.size < sizeof(MessageHeader) || header.size > sizeof(MessageV1)) {
+            throw std::runtime_error("Bad size for v1 message");
+        }
+        verifyChecksum(data, header);
+        return data;
+    }
+    
+    static const void* parseV2Message(const void* data, const MessageHeader& header) {
+        if (header.size < sizeof(MessageV2)) {
             throw std::runtime_error("Message too small for v2");
         }
-        // Parse v2 message
-        return nullptr;
+        verifyChecksum(data, header);
+        return data;
     }
 };
 